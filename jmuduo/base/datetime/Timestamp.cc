@@ -3,6 +3,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <sys/time.h>
+#include <time.h>
 #include <assert.h>
 
 using namespace jmuduo;
@@ -10,6 +11,29 @@ using std::string;
 
 static_assert(sizeof(Timestamp) == sizeof(int64_t));
 
+namespace {
+
+// "00" 到 "99" 的两位数字表，一次查表输出两位十进制数
+const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 向 buf 写入 0-99 之间的数 v，固定两位
+inline void write2Digits(char* buf, int v) {
+  buf[0] = kDigitPairs[v * 2];
+  buf[1] = kDigitPairs[v * 2 + 1];
+}
+
+}  // namespace
+
 Timestamp::Timestamp() : microSecondsSinceEpoch_(0) {}
 
 Timestamp::Timestamp(int64_t microSecondsSinceEpoch)
@@ -26,19 +50,44 @@ string Timestamp::toString() const {
 }
 
 string Timestamp::toFormattedString() const {
-  char buf[64] = {0};
-  time_t seconds =
-      static_cast<time_t>(microSecondsSinceEpoch_ / kMicroSecondsPerSecond);
-  int microSeconds =
-      static_cast<int>(microSecondsSinceEpoch_ % kMicroSecondsPerSecond);
+  char buf[kSecondsFormatLength + kMicroSecondsFormatLength + 1];
+  formatSeconds(buf);
+  formatMicroSeconds(buf + kSecondsFormatLength);
+  buf[kSecondsFormatLength + kMicroSecondsFormatLength] = 'Z';
+
+  return string(buf, sizeof buf);
+}
+
+void Timestamp::formatSeconds(char* buf) const {
+  time_t seconds = static_cast<time_t>(secondsSinceEpoch());
   struct tm tm_time;
   gmtime_r(&seconds, &tm_time); // 用 tm_time 返回 seconds 指定的 utc 时间
 
-  snprintf(buf, sizeof(buf) - 1, "%4d-%02d-%02d %02d:%02d:%02d.%06dZ",
-           tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
-           tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec, microSeconds);
+  int year = tm_time.tm_year + 1900;
+  assert(0 <= year && year <= 9999);
+  // YYYY-MM-DD HH:mm:ss
+  write2Digits(buf, year / 100);
+  write2Digits(buf + 2, year % 100);
+  buf[4] = '-';
+  write2Digits(buf + 5, tm_time.tm_mon + 1);
+  buf[7] = '-';
+  write2Digits(buf + 8, tm_time.tm_mday);
+  buf[10] = ' ';
+  write2Digits(buf + 11, tm_time.tm_hour);
+  buf[13] = ':';
+  write2Digits(buf + 14, tm_time.tm_min);
+  buf[16] = ':';
+  write2Digits(buf + 17, tm_time.tm_sec);
+}
 
-  return buf;
+void Timestamp::formatMicroSeconds(char* buf) const {
+  int microSeconds =
+      static_cast<int>(microSecondsSinceEpoch_ % kMicroSecondsPerSecond);
+  // .uuuuuu
+  buf[0] = '.';
+  write2Digits(buf + 1, microSeconds / 10000);
+  write2Digits(buf + 3, microSeconds / 100 % 100);
+  write2Digits(buf + 5, microSeconds % 100);
 }
 
 Timestamp Timestamp::now() {
@@ -38,11 +38,25 @@ class Timestamp : copyable {
   // 返回表示时间戳的 ISO 格式化字符串
   std::string toFormattedString() const;
 
+  /**
+   * 快速格式化接口，供日志前端等热点路径使用：不分配内存、不调用 snprintf，
+   * 输出不以 '\0' 结尾。调用者可以按秒缓存 formatSeconds 的结果，
+   * 同一秒内只需重写微秒部分
+   */
+  // 向 buf 写入 "YYYY-MM-DD HH:mm:ss"，共 kSecondsFormatLength 个字符
+  void formatSeconds(char* buf) const;
+  // 向 buf 写入 ".uuuuuu"，共 kMicroSecondsFormatLength 个字符
+  void formatMicroSeconds(char* buf) const;
+
   // 判断时间戳是是否合法
   bool valid() const { return microSecondsSinceEpoch_ > 0; }
 
   // 返回内部时间戳，应该只在库的内部使用
   int64_t microSecondsSinceEpoch() const { return microSecondsSinceEpoch_; }
+  // 返回自 1970-01-01T00:00:00Z 以来的秒数
+  int64_t secondsSinceEpoch() const {
+    return microSecondsSinceEpoch_ / kMicroSecondsPerSecond;
+  }
 
   // 返回当前时间的时间戳
   static Timestamp now();
@@ -51,6 +65,10 @@ class Timestamp : copyable {
 
   // 每秒的微秒数
   static const int kMicroSecondsPerSecond = 1000 * 1000;
+  // formatSeconds 输出的长度
+  static const int kSecondsFormatLength = 19;
+  // formatMicroSeconds 输出的长度
+  static const int kMicroSecondsFormatLength = 7;
 
  private:
   // 自 1970-01-01T00:00:00Z 以来的微秒数
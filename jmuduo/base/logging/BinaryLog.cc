@@ -0,0 +1,143 @@
+#include "BinaryLog.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <memory>
+
+#include "../thread/Mutex.h"
+#include "../thread/Thread.h"
+
+namespace jmuduo {
+namespace binlog {
+namespace detail {
+
+__thread Buffer* t_buffer = nullptr;
+__thread int64_t t_lastMicroSeconds = 0;
+
+}  // namespace detail
+}  // namespace binlog
+}  // namespace jmuduo
+
+using namespace jmuduo;
+using namespace jmuduo::binlog;
+using namespace jmuduo::binlog::detail;
+
+namespace {
+
+void defaultOutput(const char* msg, int len) {
+  fwrite(msg, 1, len, stdout);
+}
+
+Logger::OutputFunc g_output = defaultOutput;
+
+MutexLock g_siteMutex;         // 保护调用点注册
+uint32_t g_nextSiteId = 1;     // @GuardedBy g_siteMutex 下一个调用点 id
+
+/**
+ * 拥有当前线程的日志缓冲区，线程退出时把剩余的日志交给输出函数。
+ * 热点路径只通过 __thread 指针 t_buffer 访问缓冲区，不经过 thread_local 对象的初始化检查
+ */
+struct ThreadBuffer {
+  std::unique_ptr<Buffer> buffer;
+
+  ~ThreadBuffer() {
+    flush();
+    t_buffer = nullptr;
+  }
+};
+
+thread_local ThreadBuffer t_threadBuffer;
+
+template <typename T>
+void put(Buffer* buf, T v) {
+  buf->append(reinterpret_cast<const char*>(&v), sizeof v);
+}
+
+// 块头：每个线程每次刷新的数据都以块头开始，记录线程 id 和基准时间
+void writeBlockHeader(Buffer* buf, int64_t now) {
+  put<uint32_t>(buf, 0);
+  put<uint8_t>(buf, kBlockHeader);
+  put<int32_t>(buf, CurrentThread::tid());
+  put<int64_t>(buf, now);
+  t_lastMicroSeconds = now;
+}
+
+const size_t kBlockHeaderSize = 4 + 1 + 4 + 8;
+
+// 刷新当前线程的缓冲区，并以新的块头开始
+Buffer* resetBuffer(int64_t now) {
+  if (!t_threadBuffer.buffer) {
+    t_threadBuffer.buffer.reset(new Buffer);
+    t_buffer = t_threadBuffer.buffer.get();
+  } else if (t_buffer->length() > 0) {
+    g_output(t_buffer->data(), t_buffer->length());
+    t_buffer->reset();
+  }
+  writeBlockHeader(t_buffer, now);
+  return t_buffer;
+}
+
+}  // namespace
+
+Buffer* binlog::detail::prepareBuffer(size_t len, int64_t now) {
+  // 单条记录不可能超过缓冲区大小，字符串参数最长 64KB
+  assert(len + kBlockHeaderSize < static_cast<size_t>(jmuduo::detail::kLargeBuffer));
+  if (t_buffer == nullptr ||
+      static_cast<size_t>(t_buffer->avail()) <= len + kBlockHeaderSize) {
+    resetBuffer(now);
+  } else {
+    // 时间增量溢出或时钟回拨，写入新的基准时间
+    writeBlockHeader(t_buffer, now);
+  }
+  return t_buffer;
+}
+
+uint32_t binlog::detail::registerSite(LogSite& site, const char* argTypes) {
+  MutexLockGuard lock(g_siteMutex);
+  uint32_t id = site.id.load(std::memory_order_relaxed);
+  if (id != 0) return id;  // 已经被别的线程注册
+  id = g_nextSiteId++;
+
+  // 调用点描述不经过线程缓冲区，在锁内直接交给输出函数。任何线程使用该调用点的事件
+  // 都发生在注册之后，其所在的缓冲区也必然在此之后才被输出，解码时只需顺序读一遍
+  std::string def;
+  auto put = [&def](const void* p, size_t n) {
+    def.append(static_cast<const char*>(p), n);
+  };
+  auto putString = [&put](const char* str) {
+    size_t len = strlen(str);
+    uint16_t n = static_cast<uint16_t>(len > UINT16_MAX ? UINT16_MAX : len);
+    put(&n, sizeof n);
+    put(str, n);
+  };
+  uint32_t zero = 0;
+  uint8_t type = kSiteDefinition;
+  uint8_t level = static_cast<uint8_t>(site.level);
+  int32_t line = site.line;
+  uint8_t nargs = static_cast<uint8_t>(strlen(argTypes));
+  put(&zero, sizeof zero);
+  put(&type, sizeof type);
+  put(&id, sizeof id);
+  put(&level, sizeof level);
+  put(&line, sizeof line);
+  putString(site.file);
+  putString(site.format);
+  put(&nargs, sizeof nargs);
+  put(argTypes, nargs);
+  g_output(def.data(), static_cast<int>(def.size()));
+
+  site.id.store(id, std::memory_order_release);
+  return id;
+}
+
+void binlog::setOutput(Logger::OutputFunc out) { g_output = out; }
+
+void binlog::flush() {
+  if (t_buffer != nullptr && t_buffer->length() > 0) {
+    g_output(t_buffer->data(), t_buffer->length());
+    t_buffer->reset();
+    // 下一条记录会发现缓冲区中没有块头
+    t_lastMicroSeconds = 0;
+  }
+}
@@ -0,0 +1,229 @@
+#ifndef _JMUDUO_BASE_BINARY_LOG_H_
+#define _JMUDUO_BASE_BINARY_LOG_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+#include "../datetime/Timestamp.h"
+#include "./LogStream.h"
+#include "./Logging.h"
+
+namespace jmuduo {
+
+/**
+ * 二进制结构化日志，用于事件追踪等最高频率的日志场景
+ * 文本日志即使格式化得再快，每条也要几十到上百字节的时间、线程 id、文件名等重复内容。
+ * 二进制日志把格式化推迟到离线进行：
+ * 1. 每个调用点有一个静态的格式描述 LogSite（级别、文件名、行号、格式串、参数类型），
+ *    第一次调用时注册并分配 id，同时把描述直接交给输出函数
+ * 2. 热点路径只写入 调用点 id + 时间增量 + 参数的原始字节，写入 per thread 的 FixedBuffer，
+ *    缓冲区写满、线程退出或手动 flush 时才交给输出函数
+ * 3. 使用 tools/logdecode 离线把二进制日志还原成和 Logger 相同格式的文本
+ *
+ * 用法，格式串中的 {} 依次被参数替换：
+ *   LOG_BIN(INFO, "conn fd={} read {} bytes", fd, n);
+ * 支持的参数类型：整数、bool、char、浮点数、指针、const char*、std::string
+ *
+ * 日志格式（本机字节序），由若干记录组成：
+ *   事件：  u32 siteId(>0) | u32 距上一条记录的微秒数 | 参数...
+ *   块头：  u32 0 | u8 kBlockHeader | u32 tid | i64 基准时间（微秒）
+ *   调用点：u32 0 | u8 kSiteDefinition | u32 siteId | u8 level | i32 line |
+ *           u16 len | file | u16 len | format | u8 nargs | 参数类型码...
+ * 每个线程每次刷新的数据以块头开始；调用点描述总是出现在使用它的事件之前
+ */
+namespace binlog {
+
+// 特殊记录的类型，跟在 u32 0 之后
+enum RecordType : uint8_t {
+  kBlockHeader = 1,
+  kSiteDefinition = 2,
+};
+
+/* 参数类型码 */
+const char kInt32 = 'i';
+const char kUInt32 = 'I';
+const char kInt64 = 'l';
+const char kUInt64 = 'L';
+const char kDouble = 'd';
+const char kChar = 'c';
+const char kPointer = 'p';
+const char kString = 's';  // u16 长度 + 字节，超长截断
+
+/**
+ * @brief 调用点的静态格式描述，由 LOG_BIN 宏定义为静态变量。
+ * 构造函数是 constexpr 的，静态变量是常量初始化的，热点路径不需要检查初始化守卫
+ */
+struct LogSite {
+  constexpr LogSite(Logger::LogLevel lv, const char* f, int l, const char* fmt)
+      : level(lv), file(f), line(l), format(fmt), id(0) {}
+
+  const Logger::LogLevel level;
+  const char* const file;
+  const int line;
+  const char* const format;
+  std::atomic<uint32_t> id;  // 0 表示还未注册
+};
+
+// 二进制日志输出函数，和 Logger 的输出函数形式相同，默认写入标准输出
+void setOutput(Logger::OutputFunc);
+// 将当前线程缓冲区中的日志交给输出函数
+void flush();
+
+namespace detail {
+
+using Buffer = jmuduo::detail::FixedBuffer<jmuduo::detail::kLargeBuffer>;
+
+extern __thread Buffer* t_buffer;        // 当前线程的日志缓冲区
+extern __thread int64_t t_lastMicroSeconds;  // 当前线程上一条记录的时间
+
+// 注册调用点并写入调用点描述，返回调用点 id
+uint32_t registerSite(LogSite& site, const char* argTypes);
+// 慢路径：分配/刷新缓冲区或写入新的块头，保证能写入 len 字节的事件
+Buffer* prepareBuffer(size_t len, int64_t now);
+
+/* 编译期计算参数类型码 */
+template <typename T, typename = void>
+struct ArgTraits;
+
+template <typename T>
+struct ArgTraits<T, std::enable_if_t<std::is_integral<T>::value>> {
+  static constexpr char code =
+      std::is_same<T, char>::value ? kChar
+      : sizeof(T) <= 4 ? (std::is_signed<T>::value ? kInt32 : kUInt32)
+                       : (std::is_signed<T>::value ? kInt64 : kUInt64);
+  using Stored = std::conditional_t<
+      std::is_same<T, char>::value, char,
+      std::conditional_t<sizeof(T) <= 4,
+                         std::conditional_t<std::is_signed<T>::value, int32_t,
+                                            uint32_t>,
+                         std::conditional_t<std::is_signed<T>::value, int64_t,
+                                            uint64_t>>>;
+  static size_t size(T) { return sizeof(Stored); }
+  static char* write(char* p, T v) {
+    Stored s = static_cast<Stored>(v);
+    memcpy(p, &s, sizeof s);
+    return p + sizeof s;
+  }
+};
+
+template <typename T>
+struct ArgTraits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  static constexpr char code = kDouble;
+  static size_t size(T) { return sizeof(double); }
+  static char* write(char* p, T v) {
+    double d = static_cast<double>(v);
+    memcpy(p, &d, sizeof d);
+    return p + sizeof d;
+  }
+};
+
+// 字符串以 u16 长度为前缀
+inline size_t stringSize(size_t len) {
+  return sizeof(uint16_t) + (len > UINT16_MAX ? UINT16_MAX : len);
+}
+inline char* writeString(char* p, const char* str, size_t len) {
+  uint16_t n = static_cast<uint16_t>(len > UINT16_MAX ? UINT16_MAX : len);
+  memcpy(p, &n, sizeof n);
+  memcpy(p + sizeof n, str, n);
+  return p + sizeof n + n;
+}
+
+template <>
+struct ArgTraits<const char*> {
+  static constexpr char code = kString;
+  static size_t size(const char* v) { return stringSize(v ? strlen(v) : 6); }
+  static char* write(char* p, const char* v) {
+    return v ? writeString(p, v, strlen(v)) : writeString(p, "(null)", 6);
+  }
+};
+
+template <>
+struct ArgTraits<char*> : ArgTraits<const char*> {};
+
+template <>
+struct ArgTraits<std::string> {
+  static constexpr char code = kString;
+  static size_t size(const std::string& v) { return stringSize(v.size()); }
+  static char* write(char* p, const std::string& v) {
+    return writeString(p, v.data(), v.size());
+  }
+};
+
+template <typename T>
+struct ArgTraits<T*, std::enable_if_t<!std::is_same<std::remove_cv_t<T>, char>::value>> {
+  static constexpr char code = kPointer;
+  static size_t size(T*) { return sizeof(uint64_t); }
+  static char* write(char* p, T* v) {
+    uint64_t u = reinterpret_cast<uintptr_t>(v);
+    memcpy(p, &u, sizeof u);
+    return p + sizeof u;
+  }
+};
+
+// 实参类型退化后再匹配，字符数组字面量退化为 const char*
+template <typename T>
+using Traits = ArgTraits<std::decay_t<T>>;
+
+// 参数类型码字符串，每种参数组合一份静态常量
+template <typename... Args>
+struct ArgTypes {
+  static constexpr char value[] = {Traits<Args>::code..., '\0'};
+};
+
+}  // namespace detail
+
+/**
+ * @brief 写入一条二进制日志，供 LOG_BIN 宏使用
+ */
+template <typename... Args>
+void write(LogSite& site, const Args&... args) {
+  uint32_t id = site.id.load(std::memory_order_acquire);
+  if (__builtin_expect(id == 0, 0))
+    id = detail::registerSite(site, detail::ArgTypes<Args...>::value);
+
+  int64_t now = Timestamp::now().microSecondsSinceEpoch();
+  size_t len = 2 * sizeof(uint32_t);
+  ((len += detail::Traits<Args>::size(args)), ...);
+
+  detail::Buffer* buf = detail::t_buffer;
+  uint64_t delta = static_cast<uint64_t>(now - detail::t_lastMicroSeconds);
+  // 缓冲区不存在、空间不足或时间增量溢出（约 71 分钟）时走慢路径
+  if (__builtin_expect(buf == nullptr ||
+                           static_cast<size_t>(buf->avail()) < len ||
+                           delta > UINT32_MAX,
+                       0)) {
+    buf = detail::prepareBuffer(len, now);
+    delta = 0;
+  }
+  detail::t_lastMicroSeconds = now;
+
+  char* p = buf->current();
+  uint32_t delta32 = static_cast<uint32_t>(delta);
+  memcpy(p, &id, sizeof id);
+  memcpy(p + sizeof id, &delta32, sizeof delta32);
+  p += 2 * sizeof(uint32_t);
+  ((p = detail::Traits<Args>::write(p, args)), ...);
+  buf->add(len);
+}
+
+}  // namespace binlog
+
+}  // namespace jmuduo
+
+/**
+ * 二进制日志宏，日志级别的编译期/运行期过滤规则和 LOG_INFO 等文本日志宏相同
+ */
+#define LOG_BIN(level, format, ...)                                          \
+  do {                                                                       \
+    if (JMUDUO_LOG_IS_ON(level)) {                                           \
+      static jmuduo::binlog::LogSite jmuduoBinLogSite(                       \
+          jmuduo::Logger::level, __FILE__, __LINE__, format);                \
+      jmuduo::binlog::write(jmuduoBinLogSite, ##__VA_ARGS__);                \
+    }                                                                        \
+  } while (0)
+
+#endif
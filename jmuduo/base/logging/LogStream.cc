@@ -1,44 +1,90 @@
 #include "./LogStream.h"
 
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <limits>
 #include <type_traits>
 #include <assert.h>
+#include <stdio.h>
 
 namespace jmuduo {
 namespace detail {
 
-// 10进制数的字符
-const char digits[] = "9876543210123456789";
-const char* zero = digits + 9;
-static_assert(sizeof(digits) == 20);
+// 两位十进制数 "00" 到 "99" 的字符表，一次除法输出两位数字
+const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+static_assert(sizeof(digitPairs) == 201);
 
 // 16进制数的字符
 const char digitsHex[] = "0123456789abcdef";
 static_assert(sizeof(digitsHex) == 17);
+const char digitsHexUpper[] = "0123456789ABCDEF";
+
+// 计算无符号数 v 的十进制位数，每轮比较 4 位，避免逐位除法
+template <typename U>
+int countDigits(U v) {
+  int n = 1;
+  for (;;) {
+    if (v < 10) return n;
+    if (v < 100) return n + 1;
+    if (v < 1000) return n + 2;
+    if (v < 10000) return n + 3;
+    v /= 10000u;
+    n += 4;
+  }
+}
+
+/**
+ * @brief 将无符号数 v 的十进制字符表示写入 [end-位数, end)，
+ * 从低位到高位每次写入两位数字
+ */
+template <typename U>
+void writeDigits(char* end, U v) {
+  while (v >= 100) {
+    unsigned idx = static_cast<unsigned>(v % 100) * 2;
+    v /= 100;
+    *--end = digitPairs[idx + 1];
+    *--end = digitPairs[idx];
+  }
+  if (v < 10) {
+    *--end = static_cast<char>('0' + v);
+  } else {
+    unsigned idx = static_cast<unsigned>(v) * 2;
+    *--end = digitPairs[idx + 1];
+    *--end = digitPairs[idx];
+  }
+}
 
 /**
  * @brief 将数 value 的十进制字符表示写入缓冲区 buf
+ * 先计算位数，再从低位到高位两位两位地写入，不需要像逐位转换那样最后再反转
  *
  * @tparam T 数 value 的类型
  * @return size_t 写入的字符串长度
  */
 template <typename T>
 size_t convert(char buf[], T value) {
-  T i = value;
+  using U = typename std::make_unsigned<T>::type;
+  // 转换为无符号数处理，0 - U(value) 对最小的负数也是正确的
+  U i = value < 0 ? 0 - static_cast<U>(value) : static_cast<U>(value);
   char* p = buf;
-
-  do {  // 从低位到高位解析每一位上的数字
-    int lsd = i % 10;
-    i /= 10;
-    *p++ = zero[lsd];
-  } while (i != 0);
-
   if (value < 0)  // 小于 0 的数要加上负号
     *p++ = '-';
 
+  int n = countDigits(i);
+  writeDigits(p + n, i);
+  p += n;
   *p = '\0';
-  std::reverse(buf, p);  // 当前输出为 "低位到高位 - \0"，需要反转
   return p - buf;
 }
 
@@ -157,24 +203,239 @@ LogStream& LogStream::operator<<(const void* p) {
 
   return *this;
 }
-// FIXME 将浮点数转换为字符串应该使用 Grisu3 算法
+// 浮点数使用 std::to_chars 输出能精确还原（round-trip）的最短字符串，
+// libstdc++ 的实现基于 Ryu 算法，比 snprintf("%.12g") 快得多且不丢失精度
 // https://daily.zhihu.com/story/4509088
 LogStream& LogStream::operator<<(double v) {
   if (buffer_.avail() >= kMaxNumericSize) {
-    int len = snprintf(buffer_.current(), kMaxNumericSize, "%.12g", v);
-    buffer_.add(len);
+    char* buf = buffer_.current();
+    auto res = std::to_chars(buf, buf + kMaxNumericSize, v);
+    assert(res.ec == std::errc());
+    buffer_.add(res.ptr - buf);
   }
   return *this;
 }
 
+namespace jmuduo {
+namespace detail {
+
+/**
+ * @brief 解析后的 printf 风格格式说明：[前缀]%[flags][width][.precision][length]conv[后缀]
+ * 只支持一个算术类型的转换，前后缀中可以含有 "%%"
+ */
+struct FormatSpec {
+  const char* prefix;  // 转换说明前的文本
+  const char* prefixEnd;
+  const char* suffix;  // 转换说明后的文本
+  const char* suffixEnd;
+  bool leftAlign;      // '-'
+  bool plusSign;       // '+'
+  bool spaceSign;      // ' '
+  bool zeroPad;        // '0'
+  int width;           // 最小宽度
+  int precision;       // 精度，-1 表示未指定
+  char conv;           // 转换字符
+
+  bool isFloat() const {
+    return conv == 'f' || conv == 'F' || conv == 'e' || conv == 'E' ||
+           conv == 'g' || conv == 'G';
+  }
+};
+
+// 将 [begin, end) 中的文本写入 out，"%%" 转义为 '%'；若文本中还有其他转换说明则返回 false
+bool appendLiteral(const char* begin, const char* end, char** out,
+                   char* outEnd) {
+  for (const char* p = begin; p < end; ++p) {
+    if (*p == '%') {
+      if (p + 1 < end && p[1] == '%')
+        ++p;
+      else
+        return false;
+    }
+    if (*out < outEnd) *(*out)++ = *p;
+  }
+  return true;
+}
+
+// 解析格式化字符串，不支持的格式返回 false，由调用者退回到 snprintf
+bool parseFormatSpec(const char* fmt, FormatSpec* spec) {
+  const char* p = fmt;
+  while (*p && !(*p == '%' && p[1] != '%')) p += (*p == '%') ? 2 : 1;
+  if (*p != '%') return false;
+  spec->prefix = fmt;
+  spec->prefixEnd = p++;
+
+  spec->leftAlign = spec->plusSign = spec->spaceSign = spec->zeroPad = false;
+  for (;; ++p) {
+    if (*p == '-') spec->leftAlign = true;
+    else if (*p == '+') spec->plusSign = true;
+    else if (*p == ' ') spec->spaceSign = true;
+    else if (*p == '0') spec->zeroPad = true;
+    else if (*p == '#') return false;  // 替代格式交给 snprintf
+    else break;
+  }
+  spec->width = 0;
+  while (*p >= '0' && *p <= '9') spec->width = spec->width * 10 + (*p++ - '0');
+  spec->precision = -1;
+  if (*p == '.') {
+    ++p;
+    spec->precision = 0;
+    while (*p >= '0' && *p <= '9')
+      spec->precision = spec->precision * 10 + (*p++ - '0');
+  }
+  // 长度修饰符由实参类型 T 决定，这里直接跳过
+  while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'q' || *p == 'j' ||
+         *p == 'z' || *p == 't')
+    ++p;
+  spec->conv = *p;
+  if (!(spec->isFloat() || spec->conv == 'd' || spec->conv == 'i' ||
+        spec->conv == 'u' || spec->conv == 'x' || spec->conv == 'X' ||
+        spec->conv == 'o' || spec->conv == 'c'))
+    return false;
+
+  spec->suffix = ++p;
+  spec->suffixEnd = p + strlen(p);
+  return true;
+}
+
+/**
+ * @brief 按 spec 组装输出：前缀、宽度填充、符号、数字部分、后缀
+ *
+ * @param numeric 数字部分是否可以用 '0' 填充
+ * @return int 输出长度，和 snprintf 一样，超出 size 的部分被截断
+ */
+int formatBody(char* buf, size_t size, const FormatSpec& spec, char sign,
+               const char* body, int bodyLen, bool numeric) {
+  char tmp[128];
+  char* out = tmp;
+  char* outEnd = tmp + sizeof tmp;
+  appendLiteral(spec.prefix, spec.prefixEnd, &out, outEnd);
+
+  int len = bodyLen + (sign ? 1 : 0);
+  int pad = spec.width > len ? spec.width - len : 0;
+  bool zeros = numeric && spec.zeroPad && !spec.leftAlign;
+  if (!spec.leftAlign && !zeros)
+    for (; pad > 0 && out < outEnd; --pad) *out++ = ' ';
+  if (sign && out < outEnd) *out++ = sign;
+  if (zeros)
+    for (; pad > 0 && out < outEnd; --pad) *out++ = '0';
+  int n = std::min<int>(bodyLen, static_cast<int>(outEnd - out));
+  memcpy(out, body, n);
+  out += n;
+  for (; pad > 0 && out < outEnd; --pad) *out++ = ' ';
+  appendLiteral(spec.suffix, spec.suffixEnd, &out, outEnd);
+
+  int length = static_cast<int>(out - tmp);
+  size_t copy = std::min(static_cast<size_t>(length), size - 1);
+  memcpy(buf, tmp, copy);
+  buf[copy] = '\0';
+  return length;
+}
+
+char signOf(const FormatSpec& spec, bool negative) {
+  if (negative) return '-';
+  if (spec.plusSign) return '+';
+  if (spec.spaceSign) return ' ';
+  return '\0';
+}
+
+// 按整数转换说明 d/i/u/x/X/o 格式化绝对值为 magnitude 的整数
+int formatIntegerSpec(char* buf, size_t size, const FormatSpec& spec,
+                      bool negative, unsigned long long magnitude) {
+  char digits[32];
+  char* end = digits + sizeof digits;
+  char* p = end;
+  if (spec.conv == 'x' || spec.conv == 'X') {
+    const char* table = spec.conv == 'x' ? digitsHex : digitsHexUpper;
+    do {
+      *--p = table[magnitude & 0xf];
+      magnitude >>= 4;
+    } while (magnitude != 0);
+  } else if (spec.conv == 'o') {
+    do {
+      *--p = static_cast<char>('0' + (magnitude & 07));
+      magnitude >>= 3;
+    } while (magnitude != 0);
+  } else {
+    p = end - countDigits(magnitude);
+    writeDigits(end, magnitude);
+  }
+  // 精度表示最少输出的数字位数，"%.0d" 输出 0 时不输出任何数字
+  if (spec.precision == 0 && p == end - 1 && *p == '0') p = end;
+  while (end - p < spec.precision && p > digits) *--p = '0';
+
+  // 指定了精度时忽略 '0' 标志，和 printf 一致
+  return formatBody(buf, size, spec, signOf(spec, negative), p,
+                    static_cast<int>(end - p), spec.precision < 0);
+}
+
+// 按浮点数转换说明 f/F/e/E/g/G 格式化，使用 std::to_chars 代替 snprintf，
+// 数字部分太长时返回 -1，由调用者用原始的格式串退回到 snprintf
+int formatFloatSpec(char* buf, size_t size, const FormatSpec& spec,
+                    double v) {
+  char body[64];
+  bool negative = std::signbit(v);
+  double abs = std::fabs(v);
+  std::chars_format format = std::chars_format::general;
+  char lower = static_cast<char>(spec.conv | 0x20);
+  if (lower == 'f') format = std::chars_format::fixed;
+  else if (lower == 'e') format = std::chars_format::scientific;
+  int precision = spec.precision < 0 ? 6 : spec.precision;
+
+  auto res = std::to_chars(body, body + sizeof body, abs, format, precision);
+  if (res.ec != std::errc()) return -1;  // 太长了，例如 "%f" 输出 1e300
+  int bodyLen = static_cast<int>(res.ptr - body);
+  if (spec.conv == 'F' || spec.conv == 'E' || spec.conv == 'G')
+    std::transform(body, res.ptr, body, ::toupper);
+  return formatBody(buf, size, spec, signOf(spec, negative), body, bodyLen,
+                    std::isfinite(v));
+}
+
+}  // namespace detail
+}  // namespace jmuduo
+
 /**
  * @brief 将算数类型 T 的值 val 按格式化字符串 fmt 的定义转化为字符串
+ * 常见的整数、浮点数转换由 formatIntegerSpec/formatFloatSpec 直接完成，
+ * 只有不支持的格式（如 '#'、"%a"）才退回到 snprintf
  */
 template<typename T>
 Fmt::Fmt(const char* fmt, T val) {
   // T 必须是算术类型（即整数类型或浮点类型）
   static_assert(std::is_arithmetic<T>::value == true);
-  length_ = snprintf(buf_, sizeof buf_, fmt, val);
+  FormatSpec spec;
+  if (!parseFormatSpec(fmt, &spec)) {
+    length_ = snprintf(buf_, sizeof buf_, fmt, val);
+  } else if (spec.conv == 'c') {
+    char c = static_cast<char>(val);
+    length_ = formatBody(buf_, sizeof buf_, spec, '\0', &c, 1, false);
+  } else if (spec.isFloat()) {
+    double v = static_cast<double>(val);
+    length_ = formatFloatSpec(buf_, sizeof buf_, spec, v);
+    if (length_ < 0) {
+      // 结果被截断为缓冲区的大小
+      length_ = std::min(snprintf(buf_, sizeof buf_, fmt, v),
+                         static_cast<int>(sizeof buf_) - 1);
+    }
+  } else if constexpr (std::is_floating_point<T>::value) {
+    // 整数转换说明用于浮点数，截断为整数输出
+    long long v = static_cast<long long>(val);
+    length_ = formatIntegerSpec(buf_, sizeof buf_, spec, v < 0,
+                                v < 0 ? 0 - static_cast<unsigned long long>(v)
+                                      : static_cast<unsigned long long>(v));
+  } else {
+    using U = typename std::make_unsigned<T>::type;
+    bool isSigned = spec.conv == 'd' || spec.conv == 'i';
+    if (isSigned && val < 0) {
+      // short、char 的 U 会被提升为 int，先在 int 中取负再截断回 U
+      length_ = formatIntegerSpec(buf_, sizeof buf_, spec, true,
+                                  static_cast<U>(0 - static_cast<U>(val)));
+    } else {
+      // u/x/X/o 按同宽度的无符号数解释，和 printf 一致
+      length_ = formatIntegerSpec(buf_, sizeof buf_, spec, false,
+                                  static_cast<U>(val));
+    }
+  }
   assert(static_cast<size_t>(length_) < sizeof buf_);
 }
 
@@ -42,7 +42,7 @@ class FixedBuffer : noncopyable {
 
   char* current() { return cur_; }
   // 剩余空间大小
-  int avail() const { return static_cast<int>(end() - data_); }
+  int avail() const { return static_cast<int>(end() - cur_); }
   // 移动空闲指针
   void add(size_t len) { cur_ += len; }
 
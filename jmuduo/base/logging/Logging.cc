@@ -9,7 +9,7 @@ namespace jmuduo {
 
 __thread char t_errnobuf[512];  // 存储系统调用错误信息的缓冲区
 __thread char t_time[32];  // 用于格式化时间的缓冲区，per thread 保证了线程安全
-__thread time_t t_lastSecond;  // 最后一次记录日志的时间
+__thread int64_t t_lastSecond;  // 最后一次记录日志的时间，同一秒内 t_time 可以复用
 
 // 解析系统调用错误
 const char* strerror_tl(int savedErrno) {
@@ -64,33 +64,30 @@ Logger::Impl::Impl(LogLevel level, int savedErrno, const char* file, int line)
   basename_ = (path_sep_pos != nullptr) ? path_sep_pos + 1 : fullname_;
 
   formatTime(); // log 时间
-  Fmt tid("%6d ", CurrentThread::tid()); // 格式化输出 tid
-  assert(tid.length() == 7); // 每个平台的 pid 长度可能不同
-  stream_ << FixedString(tid.data(), 7) // log 线程 id
+  stream_ << FixedString(CurrentThread::tidString(),
+                         CurrentThread::tidStringLength()) // log 线程 id，每个线程只格式化一次
           << FixedString(LogLevelName[level], 6); // log 当前日志对象的输出级别
   if (savedErrno != 0)  // （如果有）log 系统调用错误
     stream_ << strerror_tl(savedErrno) << " (error=" << savedErrno << ") ";
 }
 
 void Logger::Impl::formatTime() {
-  int64_t microSecondsSinceEpoch = time_.microSecondsSinceEpoch();
-  time_t seconds = static_cast<time_t>(microSecondsSinceEpoch / 1000000);
-  int microseconds = static_cast<int>(microSecondsSinceEpoch % 1000000);
+  // 只有跨秒时才重新格式化 "YYYY-MM-DD HH:mm:ss" 部分，
+  // 这里所用的缓冲区 t_time 是 per thread 的，保证了线程安全
+  int64_t seconds = time_.secondsSinceEpoch();
   if (seconds != t_lastSecond) {
     t_lastSecond = seconds;
-    struct tm tm_time;
-    ::gmtime_r(&seconds, &tm_time);  // FIXME TimeZone::fromUtcTime
-
-    // 这里所用的缓冲区 t_time 是 per thread 的，保证了线程安全
-    int len =
-        snprintf(t_time, sizeof(t_time), "%4d-%02d-%02d %02d:%02d:%02d",
-                 tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
-                 tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
-    assert(len == 19);
+    time_.formatSeconds(t_time);
+    t_time[Timestamp::kSecondsFormatLength] = '\0';
   }
-  Fmt us(".%06dZ ", microseconds);
-  assert(us.length() == 9);
-  stream_ << FixedString(t_time, 19) << FixedString(us.data(), 9); // log 时间
+  // 每条日志只需重写微秒部分 ".uuuuuuZ "
+  char us[Timestamp::kMicroSecondsFormatLength + 3];
+  time_.formatMicroSeconds(us);
+  us[7] = 'Z';
+  us[8] = ' ';
+  us[9] = '\0';
+  stream_ << FixedString(t_time, Timestamp::kSecondsFormatLength)
+          << FixedString(us, 9); // log 时间
 }
 
 void Logger::Impl::finish() {
@@ -122,10 +119,12 @@ Logger::~Logger() {
   }
 }
 
-Logger::LogLevel Logger::logLevel() { return g_logLevel; }
-
 void Logger::setLogLevel(Logger::LogLevel level) { g_logLevel = level; }
 
+AtomicInt64 jmuduo::detail::g_suppressedLogs;
+
+int64_t Logger::suppressedCount() { return detail::g_suppressedLogs.get(); }
+
 void Logger::setOutput(OutputFunc out) { g_output = out; }
 
 void Logger::setFlush(FlushFunc flush) { g_flush = flush; }
\ No newline at end of file
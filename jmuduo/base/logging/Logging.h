@@ -2,8 +2,19 @@
 #define _JMUDUO_BASE_LOGGING_H_
 
 #include "../datetime/Timestamp.h"
+#include "../thread/Atomic.h"
 #include "./LogStream.h"
 
+/**
+ * 编译期日志输出级别下限（Logger::LogLevel 的数值），低于该级别的日志语句在编译期
+ * 即成为死代码，连同参数表达式一起被优化掉，例如：
+ *   -DJMUDUO_LOG_MIN_LEVEL=2 只保留 INFO 及以上级别的日志
+ * 运行期的日志输出级别 Logger::setLogLevel 仍然有效，但不能低于这个下限
+ */
+#ifndef JMUDUO_LOG_MIN_LEVEL
+#define JMUDUO_LOG_MIN_LEVEL 0
+#endif
+
 namespace jmuduo {
 
 /**
@@ -31,6 +42,11 @@ class Logger {
     NUM_LOG_LEVELS,
   };
 
+  // 编译期日志输出级别下限，FATAL 总是输出
+  static constexpr LogLevel kMinLogLevel =
+      static_cast<LogLevel>(JMUDUO_LOG_MIN_LEVEL);
+  static_assert(kMinLogLevel <= FATAL, "JMUDUO_LOG_MIN_LEVEL out of range");
+
   Logger(const char* file, int line);
   Logger(const char* file, int line, LogLevel level);
   Logger(const char* file, int line, LogLevel level, const char* func);
@@ -43,6 +59,8 @@ class Logger {
   static LogLevel logLevel();
   // 设置全局日志输出级别
   static void setLogLevel(LogLevel level);
+  // 被 LOG_EVERY_N/LOG_EVERY_MS 采样/限流丢弃的日志条数，可在任意线程调用
+  static int64_t suppressedCount();
 
   /* 日志前端用来操作日志后端的接口函数类型 */
   // 全局日志输出函数应该把一条长为 len 的日志 msg 写入到日志后端
@@ -73,26 +91,110 @@ class Logger {
   Impl impl_;
 };
 
+// 全局统一日志输出级别，定义在 Logging.cc
+extern Logger::LogLevel g_logLevel;
+
+// 内联，每条日志语句的运行期判断只是一次内存读取
+inline Logger::LogLevel Logger::logLevel() { return g_logLevel; }
+
+namespace detail {
+
+// 每个调用点的采样状态，由 LOG_EVERY_N/LOG_EVERY_MS 中 lambda 的静态局部变量提供
+struct LogSiteState {
+  AtomicInt64 count;            // 调用次数
+  AtomicInt64 nextMicroSeconds; // 下一次允许输出的时间
+};
+
+// 所有调用点被丢弃的日志条数，见 Logger::suppressedCount
+extern AtomicInt64 g_suppressedLogs;
+
+// 每 n 次调用输出一次（第 1、n+1、2n+1... 次）
+inline bool logEveryN(LogSiteState& site, int64_t n) {
+  if (site.count.getAndAdd(1) % n == 0) return true;
+  g_suppressedLogs.increment();
+  return false;
+}
+
+// 每 ms 毫秒最多输出一次，多个线程同时到达时只有一个能输出
+inline bool logEveryMs(LogSiteState& site, int64_t ms) {
+  int64_t now = Timestamp::now().microSecondsSinceEpoch();
+  int64_t next = site.nextMicroSeconds.get();
+  if (now >= next &&
+      site.nextMicroSeconds.compareAndSet(next, now + ms * 1000))
+    return true;
+  g_suppressedLogs.increment();
+  return false;
+}
+
+}  // namespace detail
+
 
-/* 用户直接使用的日志输出宏 */
-// TRACE、DEBUG、INFO 三种信息采用选择性打印的方式
-// 只有 TRACE 和 DEBUG 会记录本条日志所在的函数名
-#define LOG_TRACE                                          \
-  if (jmuduo::Logger::logLevel() <= jmuduo::Logger::TRACE) \
-  jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::TRACE, __func__).stream()
-#define LOG_DEBUG                                          \
-  if (jmuduo::Logger::logLevel() <= jmuduo::Logger::DEBUG) \
-  jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::DEBUG, __func__).stream()
-#define LOG_INFO                                          \
-  if (jmuduo::Logger::logLevel() <= jmuduo::Logger::INFO) \
-  jmuduo::Logger(__FILE__, __LINE__).stream()
-#define LOG_WARN jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::WARN).stream()
-#define LOG_ERROR jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::ERROR).stream()
+/**
+ * 用户直接使用的日志输出宏
+ * 1. 宏展开为 if (!on) {} else Logger(...).stream()，所以流式参数只在该条日志需要
+ *    输出时才会求值（惰性求值），且宏后接 else 也不会产生歧义
+ * 2. 级别低于 JMUDUO_LOG_MIN_LEVEL 的语句在编译期即被判定为不输出，整条语句被优化掉
+ * 3. TRACE、DEBUG、INFO 三种信息还要根据运行期的日志级别选择性打印
+ * 4. 只有 TRACE 和 DEBUG 会记录本条日志所在的函数名
+ */
+// 日志级别 level 在编译期是否被保留
+#define JMUDUO_LOG_COMPILED(level) \
+  (jmuduo::Logger::level >= jmuduo::Logger::kMinLogLevel)
+// 日志级别 level 当前是否需要输出
+#define JMUDUO_LOG_IS_ON(level) \
+  (JMUDUO_LOG_COMPILED(level) &&  \
+   jmuduo::Logger::logLevel() <= jmuduo::Logger::level)
+
+#define LOG_TRACE                 \
+  if (!JMUDUO_LOG_IS_ON(TRACE)) { \
+  } else                          \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::TRACE, __func__).stream()
+#define LOG_DEBUG                 \
+  if (!JMUDUO_LOG_IS_ON(DEBUG)) { \
+  } else                          \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::DEBUG, __func__).stream()
+#define LOG_INFO                 \
+  if (!JMUDUO_LOG_IS_ON(INFO)) { \
+  } else                         \
+    jmuduo::Logger(__FILE__, __LINE__).stream()
+#define LOG_WARN                   \
+  if (!JMUDUO_LOG_COMPILED(WARN)) { \
+  } else                           \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::WARN).stream()
+#define LOG_ERROR                   \
+  if (!JMUDUO_LOG_COMPILED(ERROR)) { \
+  } else                            \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::ERROR).stream()
 #define LOG_FATAL jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::FATAL).stream()
 // 存在系统错误时需要输出 errno
-#define LOG_SYSERR jmuduo::Logger(__FILE__, __LINE__, false).stream()
+#define LOG_SYSERR                  \
+  if (!JMUDUO_LOG_COMPILED(ERROR)) { \
+  } else                            \
+    jmuduo::Logger(__FILE__, __LINE__, false).stream()
 #define LOG_SYSFATAL jmuduo::Logger(__FILE__, __LINE__, true).stream()
 
+/**
+ * 调用点级别的采样/限流，防止热点循环中的日志刷屏，例如：
+ *   LOG_EVERY_N(WARN, 1000) << "queue full";   每 1000 次输出一次
+ *   LOG_EVERY_MS(ERROR, 500) << "read error";  每 500 毫秒最多输出一次
+ * 采样状态是每个调用点一份的静态变量，线程安全；日志级别被过滤时不计数
+ */
+#define JMUDUO_LOG_SITE_STATE()                       \
+  ([]() -> jmuduo::detail::LogSiteState& {            \
+    static jmuduo::detail::LogSiteState jmuduoLogSite; \
+    return jmuduoLogSite;                              \
+  }())
+#define LOG_EVERY_N(level, n)                                            \
+  if (!(JMUDUO_LOG_IS_ON(level) &&                                       \
+        jmuduo::detail::logEveryN(JMUDUO_LOG_SITE_STATE(), (n)))) {     \
+  } else                                                                 \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::level).stream()
+#define LOG_EVERY_MS(level, ms)                                          \
+  if (!(JMUDUO_LOG_IS_ON(level) &&                                       \
+        jmuduo::detail::logEveryMs(JMUDUO_LOG_SITE_STATE(), (ms)))) {   \
+  } else                                                                 \
+    jmuduo::Logger(__FILE__, __LINE__, jmuduo::Logger::level).stream()
+
 // 根据系统调用返回的错误号 savedErrno 解析字符串形式的错误信息
 const char* strerror_tl(int savedErrno);
 
@@ -0,0 +1,169 @@
+#ifndef _JMUDUO_HISTOGRAM_H_
+#define _JMUDUO_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "../noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * HDR 风格的直方图：对数-线性分桶，内存大小固定
+ * 1. 小于 2^kSubBits 的值每个值一个桶；之后每个 2 的幂区间 [2^e, 2^(e+1)) 再线性地分为
+ *    2^kSubBits 个桶，相对误差不超过 1/2^kSubBits（约 6%），和数值的大小无关
+ * 2. 不小于 2^kMaxBits 的值记入最后一个桶，以纳秒为单位时约为 18 分钟
+ * 3. 桶的下标只需要一次 clz 和几次移位计算，没有循环和浮点运算
+ */
+namespace detail {
+
+struct HistogramBuckets {
+  static const int kSubBits = 4;
+  static const int kSubCount = 1 << kSubBits;
+  static const int kMaxBits = 40;
+  static const size_t kNumBuckets = (kMaxBits - kSubBits + 1) * kSubCount;
+
+  static size_t indexOf(uint64_t value) {
+    if (value < kSubCount) return static_cast<size_t>(value);
+    int e = 63 - __builtin_clzll(value);  // value 的最高位
+    if (e >= kMaxBits) return kNumBuckets - 1;
+    int shift = e - kSubBits;
+    size_t sub = static_cast<size_t>(value >> shift) & (kSubCount - 1);
+    return static_cast<size_t>(shift + 1) * kSubCount + sub;
+  }
+
+  // 桶中最小的值
+  static uint64_t lowerBound(size_t index) {
+    if (index < kSubCount) return index;
+    int shift = static_cast<int>(index / kSubCount) - 1;
+    uint64_t sub = index % kSubCount;
+    return (kSubCount + sub) << shift;
+  }
+
+  // 桶中最大的值
+  static uint64_t upperBound(size_t index) {
+    if (index + 1 == kNumBuckets) return UINT64_MAX;
+    return lowerBound(index + 1) - 1;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief 直方图某一时刻的拷贝，可以在任意线程中计算统计值、合并多个直方图
+ */
+class HistogramSnapshot : copyable {
+ public:
+  using Buckets = detail::HistogramBuckets;
+
+  HistogramSnapshot() : counts_{}, count_(0), sum_(0), max_(0) {}
+
+  uint64_t count() const { return count_; }
+  uint64_t sum() const { return sum_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ == 0 ? 0 : double(sum_) / count_; }
+
+  /**
+   * @brief 百分位数，p 的范围为 [0, 100]
+   * 返回所在桶的上界（不超过 max），即真实值向上取整到桶的精度
+   */
+  uint64_t percentile(double p) const {
+    if (count_ == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p / 100 * count_ + 0.5);
+    rank = std::clamp<uint64_t>(rank, 1, count_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < Buckets::kNumBuckets; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) return std::min(Buckets::upperBound(i), max_);
+    }
+    return max_;
+  }
+
+  // 累加另一个直方图，用于汇总多个事件循环
+  void merge(const HistogramSnapshot& other) {
+    for (size_t i = 0; i < Buckets::kNumBuckets; ++i)
+      counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  // 按桶遍历，用于导出完整的分布
+  static size_t numBuckets() { return Buckets::kNumBuckets; }
+  uint64_t bucketCount(size_t index) const { return counts_[index]; }
+  static uint64_t bucketUpperBound(size_t index) {
+    return Buckets::upperBound(index);
+  }
+
+ private:
+  friend class Histogram;
+
+  std::array<uint64_t, Buckets::kNumBuckets> counts_;
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t max_;
+};
+
+/**
+ * @brief 单写者、多读者的直方图
+ * 1. 只能在一个线程中（事件循环所在的 IO 线程）调用 record，计数器只有这一个写者，
+ *    用 relaxed 的 load + store 更新，不需要带 lock 前缀的原子加，和普通的加法一样便宜
+ * 2. 任意线程可以随时调用 snapshot，不加锁、不影响写者。各个计数器分别读取，
+ *    快照不是严格的同一时刻的值，count 和各桶之和可能相差正在记录的几个值
+ */
+class Histogram : noncopyable {
+ public:
+  using Buckets = detail::HistogramBuckets;
+
+  Histogram() : counts_{}, count_(0), sum_(0), max_(0) {}
+
+  void record(uint64_t value) {
+    increment(counts_[Buckets::indexOf(value)], 1);
+    increment(count_, 1);
+    increment(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed))
+      max_.store(value, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 记录 value 并修正协同遗漏（coordinated omission）：闭环的压测客户端在一个请求
+   * 被阻塞时不会发出后续请求，停顿期间本应记录的样本都缺失了。value 大于期望的采样间隔时，
+   * 补记 value - interval、value - 2 * interval ... 中不小于 interval 的值，同 HdrHistogram
+   * 的 recordValueWithExpectedInterval。interval 为 0 时不修正
+   */
+  void recordWithExpectedInterval(uint64_t value, uint64_t interval) {
+    record(value);
+    if (interval == 0 || value <= interval) return;
+    for (uint64_t missing = value - interval; missing >= interval; missing -= interval)
+      record(missing);
+  }
+
+  HistogramSnapshot snapshot() const {
+    HistogramSnapshot s;
+    for (size_t i = 0; i < Buckets::kNumBuckets; ++i)
+      s.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+    s.count_ = count_.load(std::memory_order_relaxed);
+    s.sum_ = sum_.load(std::memory_order_relaxed);
+    s.max_ = max_.load(std::memory_order_relaxed);
+    return s;
+  }
+
+ private:
+  static void increment(std::atomic<uint64_t>& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint64_t>, Buckets::kNumBuckets> counts_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+}  // namespace jmuduo
+
+#endif
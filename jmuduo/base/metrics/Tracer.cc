@@ -0,0 +1,144 @@
+#include "Tracer.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../thread/Mutex.h"
+#include "../thread/Thread.h"
+
+using namespace jmuduo;
+using namespace jmuduo::detail;
+
+std::atomic<bool> jmuduo::detail::g_tracing(false);
+__thread TraceBuffer* jmuduo::detail::t_traceBuffer = nullptr;
+
+namespace {
+
+std::atomic<size_t> g_capacity(Tracer::kDefaultCapacity);
+
+// 所有线程的缓冲区，线程退出后保留，直到进程结束，只在创建和导出时加锁
+MutexLock g_buffersMutex;
+std::vector<std::unique_ptr<TraceBuffer>> g_buffers;
+
+size_t roundUpToPowerOfTwo(size_t n) {
+  size_t capacity = 1;
+  while (capacity < n) capacity <<= 1;
+  return capacity;
+}
+
+// 追加 JSON 字符串，转义引号、反斜杠和控制字符
+void appendJsonString(std::string* out, const char* s) {
+  out->push_back('"');
+  for (; *s != '\0'; ++s) {
+    unsigned char c = static_cast<unsigned char>(*s);
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(*s);
+    } else if (c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof buf, "\\u%04x", c);
+      out->append(buf);
+    } else {
+      out->push_back(*s);
+    }
+  }
+  out->push_back('"');
+}
+
+// snprintf 的返回值可能大于缓冲区，追加实际写入的部分
+void appendFormatted(std::string* out, const char* buf, size_t size, int n) {
+  if (n > 0) out->append(buf, std::min(static_cast<size_t>(n), size - 1));
+}
+
+}  // namespace
+
+TraceBuffer::TraceBuffer(pid_t tid, size_t capacity)
+    : tid_(tid),
+      mask_(capacity - 1),
+      events_(new TraceEvent[capacity]),
+      head_(0) {}
+
+size_t TraceBuffer::appendJson(pid_t pid, std::string* out) const {
+  uint64_t capacity = mask_ + 1;
+  uint64_t end = head_.load(std::memory_order_acquire);
+  uint64_t begin = end > capacity ? end - capacity : 0;
+
+  struct Copy {
+    int64_t start, duration, arg;
+    const char* name;
+  };
+  std::vector<Copy> copies;
+  copies.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    const TraceEvent& e = events_[i & mask_];
+    copies.push_back({e.start.load(std::memory_order_relaxed),
+                      e.duration.load(std::memory_order_relaxed),
+                      e.arg.load(std::memory_order_relaxed),
+                      e.name.load(std::memory_order_relaxed)});
+  }
+  // 拷贝期间写者又写入了 newEnd - end 条，正在写的是第 newEnd 条，
+  // 它们覆盖的是最早的 newEnd + 1 - begin - capacity 条（如果有的话）
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t newEnd = head_.load(std::memory_order_relaxed);
+  size_t skip = 0;
+  if (newEnd + 1 > begin + capacity)
+    skip = std::min<uint64_t>(newEnd + 1 - begin - capacity, copies.size());
+
+  // 名字可能很长，直接转义后追加，只有数值部分经过 buf
+  char buf[128];
+  for (size_t i = skip; i < copies.size(); ++i) {
+    const Copy& c = copies[i];
+    if (!out->empty() && out->back() != '[') out->append(",\n");
+    out->append("{\"name\":");
+    appendJsonString(out, c.name);
+    int n = snprintf(buf, sizeof buf,
+                     ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                     c.start / 1e3, c.duration / 1e3, pid, tid_);
+    appendFormatted(out, buf, sizeof buf, n);
+    if (c.arg >= 0) {
+      n = snprintf(buf, sizeof buf, ",\"args\":{\"arg\":%lld}",
+                   static_cast<long long>(c.arg));
+      appendFormatted(out, buf, sizeof buf, n);
+    }
+    out->push_back('}');
+  }
+  return copies.size() - skip;
+}
+
+TraceBuffer* jmuduo::detail::createThreadTraceBuffer() {
+  size_t capacity = roundUpToPowerOfTwo(g_capacity.load());
+  auto buffer = std::make_unique<TraceBuffer>(CurrentThread::tid(), capacity);
+  t_traceBuffer = buffer.get();
+  MutexLockGuard lock(g_buffersMutex);
+  g_buffers.push_back(std::move(buffer));
+  return t_traceBuffer;
+}
+
+void Tracer::start(size_t capacity) {
+  g_capacity.store(capacity);
+  g_tracing.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() { g_tracing.store(false, std::memory_order_relaxed); }
+
+std::string Tracer::dumpJson() {
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  pid_t pid = ::getpid();
+  {
+    MutexLockGuard lock(g_buffersMutex);
+    for (auto& buffer : g_buffers) buffer->appendJson(pid, &out);
+  }
+  out += "]}\n";
+  return out;
+}
+
+bool Tracer::dumpToFile(const char* path) {
+  FILE* fp = ::fopen(path, "w");
+  if (fp == nullptr) return false;
+  std::string json = dumpJson();
+  bool ok = ::fwrite(json.data(), 1, json.size(), fp) == json.size();
+  return ::fclose(fp) == 0 && ok;
+}
@@ -86,6 +86,12 @@ class AtomicIntegerT : noncopyable
     return __sync_lock_test_and_set(&value_, newValue);
   }
 
+  // 当前值等于 expected 时设置为 newValue，返回是否设置成功
+  bool compareAndSet(T expected, T newValue)
+  {
+    return __sync_bool_compare_and_swap(&value_, expected, newValue);
+  }
+
  private:
   volatile T value_;
 };
@@ -0,0 +1,75 @@
+#ifndef _JMUDUO_BLOCKING_QUEUE_H_
+#define _JMUDUO_BLOCKING_QUEUE_H_
+
+#include <assert.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "../noncopyable.h"
+#include "Condition.h"
+#include "Mutex.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 无界阻塞队列，用于生产者消费者模型
+ * 1. put 从不阻塞，take 在队列为空时阻塞
+ * 2. 支持只能移动的元素类型，如 std::unique_ptr
+ * 3. take(n) 一次取出多个元素，减少加锁和唤醒的次数
+ */
+template <typename T>
+class BlockingQueue : noncopyable {
+ public:
+  BlockingQueue() : notEmpty_(mutex_) {}
+
+  void put(const T& x) {
+    MutexLockGuard lock(mutex_);
+    queue_.push_back(x);
+    notEmpty_.notify();
+  }
+
+  void put(T&& x) {
+    MutexLockGuard lock(mutex_);
+    queue_.push_back(std::move(x));
+    notEmpty_.notify();
+  }
+
+  // 队列为空时阻塞
+  T take() {
+    MutexLockGuard lock(mutex_);
+    while (queue_.empty()) notEmpty_.wait();
+    assert(!queue_.empty());
+    T front(std::move(queue_.front()));
+    queue_.pop_front();
+    return front;
+  }
+
+  // 队列为空时阻塞，然后取出队列中的前 n 个元素（不足 n 个时全部取出）
+  std::vector<T> take(size_t n) {
+    std::vector<T> result;
+    MutexLockGuard lock(mutex_);
+    while (queue_.empty()) notEmpty_.wait();
+    n = std::min(n, queue_.size());
+    result.reserve(n);
+    std::move(queue_.begin(), queue_.begin() + n, std::back_inserter(result));
+    queue_.erase(queue_.begin(), queue_.begin() + n);
+    return result;
+  }
+
+  size_t size() const {
+    MutexLockGuard lock(mutex_);
+    return queue_.size();
+  }
+
+ private:
+  mutable MutexLock mutex_;
+  Condition notEmpty_;
+  std::deque<T> queue_;  // @GuardedBy mutex_
+};
+
+}  // namespace jmuduo
+
+#endif
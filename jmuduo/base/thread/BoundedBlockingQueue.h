@@ -0,0 +1,92 @@
+#ifndef _JMUDUO_BOUNDED_BLOCKING_QUEUE_H_
+#define _JMUDUO_BOUNDED_BLOCKING_QUEUE_H_
+
+#include <assert.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "../noncopyable.h"
+#include "Condition.h"
+#include "Mutex.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 有界阻塞队列，队列满时生产者阻塞，起到限流的作用
+ * 1. put 在队列满时阻塞，take 在队列为空时阻塞
+ * 2. 支持只能移动的元素类型
+ * 3. take(n) 一次取出多个元素，并唤醒所有等待的生产者
+ */
+template <typename T>
+class BoundedBlockingQueue : noncopyable {
+ public:
+  explicit BoundedBlockingQueue(size_t maxSize)
+      : notEmpty_(mutex_), notFull_(mutex_), maxSize_(maxSize) {
+    assert(maxSize > 0);
+  }
+
+  void put(const T& x) {
+    MutexLockGuard lock(mutex_);
+    while (queue_.size() >= maxSize_) notFull_.wait();
+    queue_.push_back(x);
+    notEmpty_.notify();
+  }
+
+  void put(T&& x) {
+    MutexLockGuard lock(mutex_);
+    while (queue_.size() >= maxSize_) notFull_.wait();
+    queue_.push_back(std::move(x));
+    notEmpty_.notify();
+  }
+
+  // 队列为空时阻塞
+  T take() {
+    MutexLockGuard lock(mutex_);
+    while (queue_.empty()) notEmpty_.wait();
+    assert(!queue_.empty());
+    T front(std::move(queue_.front()));
+    queue_.pop_front();
+    notFull_.notify();
+    return front;
+  }
+
+  // 队列为空时阻塞，然后取出队列中的前 n 个元素（不足 n 个时全部取出）
+  std::vector<T> take(size_t n) {
+    std::vector<T> result;
+    MutexLockGuard lock(mutex_);
+    while (queue_.empty()) notEmpty_.wait();
+    n = std::min(n, queue_.size());
+    result.reserve(n);
+    std::move(queue_.begin(), queue_.begin() + n, std::back_inserter(result));
+    queue_.erase(queue_.begin(), queue_.begin() + n);
+    // 一次腾出了多个位置，唤醒所有生产者
+    if (n > 1)
+      notFull_.notifyAll();
+    else
+      notFull_.notify();
+    return result;
+  }
+
+  size_t size() const {
+    MutexLockGuard lock(mutex_);
+    return queue_.size();
+  }
+
+  bool empty() const { return size() == 0; }
+  bool full() const { return size() >= maxSize_; }
+  size_t capacity() const { return maxSize_; }
+
+ private:
+  mutable MutexLock mutex_;
+  Condition notEmpty_;
+  Condition notFull_;
+  const size_t maxSize_;
+  std::deque<T> queue_;  // @GuardedBy mutex_
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef _JMUDUO_MPMC_RING_H_
+#define _JMUDUO_MPMC_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 多生产者多消费者的无锁有界环形队列，即 Dmitry Vyukov 的 bounded MPMC queue
+ * 1. 每个槽位有一个序号，表示该槽位当前可以被哪个位置的 push 或 pop 使用，
+ *    生产者和消费者各自通过 CAS 抢占下标，抢到后独占该槽位，不需要加锁
+ * 2. 入队下标和出队下标放在不同的缓存行中，生产者和消费者之间没有伪共享
+ * 3. 非阻塞，队列满/空时 tryPush/tryPop 返回 false
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * @tparam T 元素类型，可以是只能移动的类型
+ */
+template <typename T>
+class MpmcRing : noncopyable {
+ public:
+  // 容量向上取整为 2 的幂，至少为 2
+  explicit MpmcRing(size_t capacity)
+      : capacity_(roundUp(capacity)),
+        mask_(capacity_ - 1),
+        cells_(new Cell[capacity_]),
+        enqueuePos_(0),
+        dequeuePos_(0) {
+    for (size_t i = 0; i < capacity_; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  // 析构时生产者和消费者都已停止，直接销毁剩余的元素
+  ~MpmcRing() {
+    size_t enq = enqueuePos_.load(std::memory_order_acquire);
+    for (size_t i = dequeuePos_.load(std::memory_order_relaxed); i != enq; ++i)
+      cells_[i & mask_].get()->~T();
+  }
+
+  // 任意线程调用，队列满时返回 false
+  template <typename... Args>
+  bool tryEmplace(Args&&... args) {
+    Cell* cell;
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {  // 槽位空闲，抢占下标
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {  // 槽位中还是上一轮的元素，队列满
+        return false;
+      } else {  // 被别的生产者抢先了
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const T& x) { return tryEmplace(x); }
+  bool tryPush(T&& x) { return tryEmplace(std::move(x)); }
+
+  // 任意线程调用，队列为空时返回 false
+  bool tryPop(T* x) {
+    Cell* cell;
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {  // 槽位中有元素，抢占下标
+        if (dequeuePos_.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {  // 队列为空
+        return false;
+      } else {  // 被别的消费者抢先了
+        pos = dequeuePos_.load(std::memory_order_relaxed);
+      }
+    }
+    T* p = cell->get();
+    *x = std::move(*p);
+    p->~T();
+    // 槽位留给下一轮的生产者
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 元素个数的近似值
+  size_t size() const {
+    size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+    size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+    return enq >= deq ? enq - deq : 0;
+  }
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return capacity_; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+    T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  static size_t roundUp(size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap <<= 1;
+    return cap;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+
+  alignas(64) std::atomic<size_t> enqueuePos_;  // 生产者竞争的下标
+  alignas(64) std::atomic<size_t> dequeuePos_;  // 消费者竞争的下标
+};
+
+}  // namespace jmuduo
+
+#endif
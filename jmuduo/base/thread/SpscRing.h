@@ -0,0 +1,109 @@
+#ifndef _JMUDUO_SPSC_RING_H_
+#define _JMUDUO_SPSC_RING_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 单生产者单消费者的无锁有界环形队列
+ * 1. 只能有一个线程 push、一个线程 pop，两端各自只写自己的下标，不需要 CAS
+ * 2. 两个下标放在不同的缓存行中，并各自缓存一份对方的下标，
+ *    只有看起来满/空时才去读对方的缓存行，减少缓存行在两个核之间来回传递
+ * 3. 非阻塞，队列满/空时 tryPush/tryPop 返回 false，由调用者决定自旋、让出还是睡眠
+ *
+ * @tparam T 元素类型，可以是只能移动的类型
+ */
+template <typename T>
+class SpscRing : noncopyable {
+ public:
+  // 容量向上取整为 2 的幂
+  explicit SpscRing(size_t capacity)
+      : capacity_(roundUp(capacity)),
+        mask_(capacity_ - 1),
+        slots_(new Slot[capacity_]),
+        head_(0),
+        cachedTail_(0),
+        tail_(0),
+        cachedHead_(0) {}
+
+  // 析构时生产者和消费者都已停止，直接销毁剩余的元素
+  ~SpscRing() {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+      slots_[i & mask_].get()->~T();
+  }
+
+  // 生产者调用，队列满时返回 false
+  template <typename... Args>
+  bool tryEmplace(Args&&... args) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ == capacity_) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ == capacity_) return false;
+    }
+    new (slots_[tail & mask_].storage) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const T& x) { return tryEmplace(x); }
+  bool tryPush(T&& x) { return tryEmplace(std::move(x)); }
+
+  // 消费者调用，队列为空时返回 false
+  bool tryPop(T* x) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (head == cachedTail_) return false;
+    }
+    T* p = slots_[head & mask_].get();
+    *x = std::move(*p);
+    p->~T();
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 元素个数的近似值
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return capacity_; }
+
+ private:
+  // 未初始化的元素存储空间，只有 [head_, tail_) 中的元素是构造过的
+  struct Slot {
+    alignas(T) unsigned char storage[sizeof(T)];
+    T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+  };
+
+  static size_t roundUp(size_t n) {
+    size_t cap = 1;
+    while (cap < n) cap <<= 1;
+    return cap;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+
+  // 消费者修改的数据
+  alignas(64) std::atomic<size_t> head_;
+  size_t cachedTail_;  // 消费者缓存的 tail_
+  // 生产者修改的数据
+  alignas(64) std::atomic<size_t> tail_;
+  size_t cachedHead_;  // 生产者缓存的 head_
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -6,11 +6,15 @@
 #include <assert.h>
 #include <sys/prctl.h>
 #include <linux/unistd.h>
+#include <stdio.h>
 
 namespace { // 只在本文件中使用的名字
 
 // 线程独立变量，保存当前线程的线程 ID，不用每次都使用系统调用获取
 __thread pid_t t_cachedTid = 0;
+// 线程 ID 的字符串形式，和 t_cachedTid 同时缓存，避免每条日志都格式化一次
+__thread char t_tidString[32];
+__thread int t_tidStringLength = 0;
 __thread const char * t_threadName = "unnamedThread";
 
 /**
@@ -18,6 +22,13 @@ __thread const char * t_threadName = "unnamedThread";
  */
 pid_t gettid_() { return static_cast<pid_t>(::syscall(SYS_gettid)); }
 
+// 第一次获取线程 ID 时，同时缓存其字符串形式
+void cacheTid() {
+  t_cachedTid = gettid_();
+  t_tidStringLength =
+      snprintf(t_tidString, sizeof t_tidString, "%6d ", t_cachedTid);
+}
+
 /**
  * @brief 传递给线程执行函数的参数
  */
@@ -80,11 +91,23 @@ void *startThread(void *obj) {
 using namespace jmuduo;
 
 pid_t CurrentThread::tid() {
-  if (t_cachedTid == 0) t_cachedTid = gettid_();
+  if (t_cachedTid == 0) cacheTid();
 
   return t_cachedTid;
 }
 
+const char* CurrentThread::tidString() {
+  if (t_cachedTid == 0) cacheTid();
+
+  return t_tidString;
+}
+
+int CurrentThread::tidStringLength() {
+  if (t_cachedTid == 0) cacheTid();
+
+  return t_tidStringLength;
+}
+
 bool CurrentThread::isMainThread() { 
   // 在一个进程中，只有主线程的线程 id 和进程 id 是一样的
   return ::getpid() == tid();
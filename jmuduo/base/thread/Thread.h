@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 #include "../noncopyable.h"
 #include "Atomic.h"
@@ -49,6 +50,10 @@ namespace CurrentThread {
 
 // 获取线程 ID
 pid_t tid();
+// 获取格式化后的线程 ID 字符串 "%6d "，per thread 缓存，供日志前端使用
+const char* tidString();
+// 线程 ID 字符串的长度
+int tidStringLength();
 // 判断当前线程是否是主线程
 bool isMainThread();
 
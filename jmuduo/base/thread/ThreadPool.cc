@@ -0,0 +1,203 @@
+#include "ThreadPool.h"
+
+#include <assert.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <exception>
+
+#include "../logging/Logging.h"
+
+using namespace jmuduo;
+
+/**
+ * @brief 工作线程，拥有一个只有自己能 push/pop、其他线程可以 steal 的任务队列
+ */
+struct ThreadPool::Worker {
+  Worker(ThreadPool* p, uint32_t s) : pool(p), seed(s) {}
+
+  ThreadPool* pool;                 // 所属的线程池
+  WorkStealingQueue<Task*> queue;   // 本线程的任务队列
+  std::unique_ptr<Thread> thread;
+  uint32_t seed;                    // 选取窃取对象的随机数种子
+};
+
+namespace {
+
+// 一次从注入队列中最多搬运到自己队列中的任务数
+const size_t kMaxInjectionBatch = 32;
+// 睡眠前让出 CPU 并重新查找任务的次数
+const int kSpinRounds = 2;
+
+// xorshift 随机数
+uint32_t nextRandom(uint32_t* seed) {
+  uint32_t x = *seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *seed = x;
+}
+
+}  // namespace
+
+__thread ThreadPool::Worker* ThreadPool::t_currentWorker = nullptr;
+
+ThreadPool::ThreadPool(const std::string& name)
+    : name_(name),
+      cond_(mutex_),
+      running_(false),
+      injectionSize_(0),
+      queuedTasks_(0),
+      pushCount_(0),
+      sleepers_(0) {}
+
+ThreadPool::~ThreadPool() {
+  if (!workers_.empty()) stop();
+}
+
+void ThreadPool::start(int numThreads) {
+  assert(workers_.empty());
+  assert(numThreads >= 0);
+  {
+    MutexLockGuard lock(mutex_);
+    running_ = true;
+  }
+  // 先建好所有工作线程的队列再启动线程，运行期间 workers_ 不再改变，窃取时不需要加锁
+  for (int i = 0; i < numThreads; ++i)
+    workers_.emplace_back(new Worker(this, 2654435761u * (i + 1)));
+  for (int i = 0; i < numThreads; ++i) {
+    Worker* worker = workers_[i].get();
+    worker->thread.reset(new Thread([this, worker] { workerThread(worker); },
+                                    name_ + std::to_string(i + 1)));
+    worker->thread->start();
+  }
+}
+
+void ThreadPool::stop() {
+  {
+    MutexLockGuard lock(mutex_);
+    running_ = false;
+    cond_.notifyAll();
+  }
+  for (auto& worker : workers_) worker->thread->join();
+  workers_.clear();
+}
+
+void ThreadPool::run(Task task) {
+  if (workers_.empty()) {  // 没有工作线程，直接执行
+    task();
+    return;
+  }
+
+  Task* t = new Task(std::move(task));
+  queuedTasks_.fetch_add(1);
+  Worker* self = t_currentWorker;
+  if (self != nullptr && self->pool == this) {
+    // 工作线程中提交的子任务放入自己的队列
+    self->queue.push(t);
+    pushCount_.fetch_add(1);
+    wakeUpOne();
+  } else {
+    MutexLockGuard lock(mutex_);
+    injection_.push_back(t);
+    injectionSize_.fetch_add(1, std::memory_order_relaxed);
+    pushCount_.fetch_add(1);
+    if (sleepers_.load() > 0) cond_.notify();
+  }
+}
+
+void ThreadPool::wakeUpOne() {
+  // 和 workerThread 中的 sleepers_ 递增、pushCount_ 检查配对：
+  // 要么这里看到有线程要睡眠，要么那个线程看到有新任务
+  if (sleepers_.load() > 0) {
+    MutexLockGuard lock(mutex_);
+    cond_.notify();
+  }
+}
+
+void ThreadPool::workerThread(Worker* self) {
+  t_currentWorker = self;
+  while (true) {
+    // 记下开始查找前提交的任务总数。在此之前入队的任务都能被找到，
+    // 除非被别的线程抢先取走；之后入队的任务会改变这个值
+    int64_t pushed = pushCount_.load();
+    Task* task = findTask(self);
+    for (int i = 0; task == nullptr && i < kSpinRounds; ++i) {
+      ::sched_yield();
+      task = findTask(self);
+    }
+    if (task != nullptr) {
+      runTask(task);
+      continue;
+    }
+
+    MutexLockGuard lock(mutex_);
+    if (!running_) {
+      if (queuedTasks_.load() == 0) break;  // 任务都已执行完毕
+      continue;  // 其他工作线程的任务还可能提交子任务
+    }
+    sleepers_.fetch_add(1);
+    while (running_ && pushCount_.load() == pushed) cond_.wait();
+    sleepers_.fetch_sub(1);
+  }
+  t_currentWorker = nullptr;
+}
+
+ThreadPool::Task* ThreadPool::findTask(Worker* self) {
+  Task* task = nullptr;
+  if (!self->queue.pop(&task)) {
+    task = takeFromInjection(self);
+    if (task == nullptr) task = stealFromOthers(self);
+  }
+  if (task != nullptr) queuedTasks_.fetch_sub(1);
+  return task;
+}
+
+ThreadPool::Task* ThreadPool::takeFromInjection(Worker* self) {
+  if (injectionSize_.load(std::memory_order_relaxed) == 0) return nullptr;
+
+  Task* task = nullptr;
+  size_t batch = 0;
+  {
+    MutexLockGuard lock(mutex_);
+    if (injection_.empty()) return nullptr;
+    task = injection_.front();
+    injection_.pop_front();
+    // 多取一批放入自己的队列，减少对注入队列的锁竞争，其他空闲线程可以从这里窃取
+    batch = std::min(injection_.size() / workers_.size(), kMaxInjectionBatch);
+    for (size_t i = 0; i < batch; ++i) {
+      self->queue.push(injection_.front());
+      injection_.pop_front();
+    }
+    injectionSize_.fetch_sub(static_cast<int64_t>(batch + 1),
+                             std::memory_order_relaxed);
+  }
+  if (batch > 0) {  // 搬运的任务相当于新提交到自己队列中的任务
+    pushCount_.fetch_add(1);
+    wakeUpOne();
+  }
+  return task;
+}
+
+ThreadPool::Task* ThreadPool::stealFromOthers(Worker* self) {
+  size_t n = workers_.size();
+  size_t start = nextRandom(&self->seed) % n;
+  Task* task = nullptr;
+  for (size_t i = 0; i < n; ++i) {
+    Worker* victim = workers_[(start + i) % n].get();
+    if (victim != self && victim->queue.steal(&task)) return task;
+  }
+  return nullptr;
+}
+
+void ThreadPool::runTask(Task* task) {
+  try {
+    (*task)();
+  } catch (const std::exception& ex) {
+    LOG_FATAL << "exception caught in ThreadPool " << name_ << ": "
+              << ex.what();
+  } catch (...) {
+    LOG_FATAL << "unknown exception caught in ThreadPool " << name_;
+  }
+  delete task;
+}
@@ -0,0 +1,126 @@
+#ifndef _JMUDUO_THREAD_POOL_H_
+#define _JMUDUO_THREAD_POOL_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../noncopyable.h"
+#include "Condition.h"
+#include "Mutex.h"
+#include "Thread.h"
+#include "WorkStealingQueue.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 计算线程池，用于把耗时的计算从 IO 线程（如 MessageCallback）中卸载出去
+ * 1. 每个工作线程有一个 Chase-Lev 双端队列，工作线程中提交的任务（如递归拆分的子任务）
+ *    放入自己的队列，无锁无竞争
+ * 2. 其他线程（如 IO 线程）提交的任务放入一个全局的注入队列，由 mutex_ 保护
+ * 3. 工作线程依次从自己的队列、注入队列、随机选取的其他工作线程的队列中取任务，
+ *    都为空时在条件变量上睡眠
+ *
+ * 用法：
+ *   ThreadPool pool("compute");
+ *   pool.start(4);
+ *   pool.run(task);                       // 不关心结果
+ *   auto f = pool.submit(compute);        // std::future 获取结果
+ *   pool.submit(compute, loop, onDone);   // 结果通过 loop->runInLoop 交给 onDone
+ */
+class ThreadPool : noncopyable {
+ public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(const std::string& name = std::string("ThreadPool"));
+  // 析构时会先执行完所有已提交的任务
+  ~ThreadPool();
+
+  // 启动 numThreads 个工作线程。线程数为 0 时，所有任务都在提交者线程中直接执行
+  void start(int numThreads);
+  // 等待所有已提交的任务执行完毕，然后结束所有工作线程
+  void stop();
+
+  // 提交任务，可以在任意线程调用
+  void run(Task task);
+
+  /**
+   * @brief 提交任务，返回获取结果的 std::future，任务抛出的异常也由 future 传递
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<std::decay_t<F>&>> submit(F&& f) {
+    using R = std::invoke_result_t<std::decay_t<F>&>;
+    // std::packaged_task 不可复制，而 Task 是 std::function，所以用 shared_ptr 包装
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> result = task->get_future();
+    run([task] { (*task)(); });
+    return result;
+  }
+
+  /**
+   * @brief 提交任务，在工作线程中计算完成后通过 loop->runInLoop 把结果交给 done，
+   * 即 done(result) 或 done()（f 返回 void 时）在 loop 所在的 IO 线程中执行，
+   * 不需要在回调中加锁。
+   * Loop 作为模板参数而不是直接使用 EventLoop，使 base 库不依赖 reactor
+   */
+  template <typename F, typename Loop, typename Callback>
+  void submit(F&& f, Loop* loop, Callback&& done) {
+    using R = std::invoke_result_t<std::decay_t<F>&>;
+    run([f = std::forward<F>(f), loop,
+         done = std::forward<Callback>(done)]() mutable {
+      if constexpr (std::is_void_v<R>) {
+        f();
+        loop->runInLoop(done);
+      } else {
+        // 结果用 shared_ptr 包装，可以是只能移动的类型
+        auto result = std::make_shared<R>(f());
+        loop->runInLoop([done, result] { done(std::move(*result)); });
+      }
+    });
+  }
+
+  const std::string& name() const { return name_; }
+  int numThreads() const { return static_cast<int>(workers_.size()); }
+  // 已提交还未开始执行的任务数
+  int64_t queuedTasks() const {
+    return queuedTasks_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Worker;
+
+  void workerThread(Worker* self);
+  // 依次从自己的队列、注入队列、其他工作线程的队列中取一个任务
+  Task* findTask(Worker* self);
+  Task* takeFromInjection(Worker* self);
+  Task* stealFromOthers(Worker* self);
+  // 执行并释放任务
+  void runTask(Task* task);
+  // 有新任务时，如果有睡眠的工作线程，唤醒其中一个
+  void wakeUpOne();
+
+  const std::string name_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  MutexLock mutex_;  // 保护注入队列和睡眠/唤醒
+  Condition cond_;
+  std::deque<Task*> injection_;         // @GuardedBy mutex_ 其他线程提交的任务
+  bool running_;                        // @GuardedBy mutex_
+  std::atomic<int64_t> injectionSize_;  // 注入队列的长度，不加锁判断是否为空
+  std::atomic<int64_t> queuedTasks_;    // 所有队列中还未取出的任务总数
+  std::atomic<int64_t> pushCount_;      // 提交的任务总数，工作线程据此判断能否睡眠
+  std::atomic<int> sleepers_;  // 在条件变量上睡眠（或即将睡眠）的工作线程数
+
+  static __thread Worker* t_currentWorker;  // 当前线程对应的工作线程
+};
+
+}  // namespace jmuduo
+
+#endif
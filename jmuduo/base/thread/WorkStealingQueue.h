@@ -0,0 +1,128 @@
+#ifndef _JMUDUO_WORK_STEALING_QUEUE_H_
+#define _JMUDUO_WORK_STEALING_QUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief Chase-Lev 工作窃取双端队列
+ * 1. 只有队列的拥有者线程可以在底部 push/pop，后进先出，缓存局部性好
+ * 2. 其他线程可以并发地从顶部 steal，先进先出，偷走的是最早提交、通常粒度最大的任务
+ * 3. 拥有者和窃取者只在队列中剩最后一个元素时才用 CAS 竞争，平时 push/pop 无锁无 CAS
+ * 实现参考 Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * https://fzn.fr/readings/ppopp13.pdf
+ *
+ * @tparam T 元素类型，必须是可平凡复制的小对象，通常是指针
+ */
+template <typename T>
+class WorkStealingQueue : noncopyable {
+ public:
+  explicit WorkStealingQueue(int64_t capacity = 1024)
+      : top_(0), bottom_(0), array_(new Array(capacity)) {
+    garbage_.emplace_back(array_.load(std::memory_order_relaxed));
+  }
+
+  // 只能由拥有者线程调用，队列满时扩容
+  void push(T x) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) a = grow(a, t, b);
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // 只能由拥有者线程调用，从底部取出最后 push 的元素，队列为空时返回 false
+  bool pop(T* x) {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    bool ok = true;
+    if (t <= b) {
+      *x = a->get(b);
+      if (t == b) {  // 最后一个元素，和窃取者竞争
+        ok = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {  // 队列为空
+      ok = false;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return ok;
+  }
+
+  // 可以由任意线程调用，从顶部偷取最早 push 的元素，队列为空或竞争失败时返回 false
+  bool steal(T* x) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t < b) {
+      Array* a = array_.load(std::memory_order_acquire);
+      *x = a->get(t);
+      return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  // 队列中元素个数的近似值
+  int64_t size() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return b >= t ? b - t : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  // 环形数组，容量是 2 的幂
+  struct Array {
+    explicit Array(int64_t cap)
+        : capacity(roundUp(cap)),
+          mask(capacity - 1),
+          data(new std::atomic<T>[capacity]) {}
+
+    static int64_t roundUp(int64_t n) {
+      int64_t cap = 1;
+      while (cap < n) cap <<= 1;
+      return cap;
+    }
+
+    void put(int64_t i, T x) { data[i & mask].store(x, std::memory_order_relaxed); }
+    T get(int64_t i) const { return data[i & mask].load(std::memory_order_relaxed); }
+
+    const int64_t capacity;
+    const int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> data;
+  };
+
+  // 容量翻倍。旧数组可能还在被窃取者读取，所以不能立即释放，留到队列析构时释放
+  Array* grow(Array* a, int64_t t, int64_t b) {
+    Array* bigger = new Array(a->capacity * 2);
+    for (int64_t i = t; i < b; ++i) bigger->put(i, a->get(i));
+    garbage_.emplace_back(bigger);
+    array_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+  // top_ 和 bottom_ 分别被窃取者和拥有者频繁修改，放在不同的缓存行中避免伪共享
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  alignas(64) std::atomic<Array*> array_;
+  std::vector<std::unique_ptr<Array>> garbage_;  // 拥有所有分配过的数组
+};
+
+}  // namespace jmuduo
+
+#endif
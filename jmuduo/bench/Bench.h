@@ -0,0 +1,119 @@
+#ifndef _JMUDUO_BENCH_H_
+#define _JMUDUO_BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <cmath>
+#include <string>
+
+#include "../base/metrics/Histogram.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+namespace bench {
+
+/**
+ * 基准测试的公共工具。每个测试用例输出一行 JSON（JSON Lines），字段是扁平的键值，
+ * 其中 bench 和 case 标识用例，其余是参数和结果，便于用脚本逐行比较不同版本的结果：
+ *   {"bench":"pingpong","case":"conn10_size4096","connections":10,...,"mib_per_sec":812.5}
+ * 时间的单位：耗时用 ns 或 us 后缀标明，速率用 per_sec 后缀
+ * 结果输出到 stdout，日志用 stderrOutput 输出到 stderr，避免混入结果中
+ */
+
+// 单调时钟，纳秒
+inline int64_t nowNanos() {
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+
+// 日志后端，在 main 中用 Logger::setOutput(bench::stderrOutput) 安装
+inline void stderrOutput(const char* msg, int len) { fwrite(msg, 1, len, stderr); }
+
+// 阻止编译器优化掉没有使用的计算结果
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief 一个用例的结果，print 时输出为一行 JSON
+ */
+class Result : noncopyable {
+ public:
+  Result(const char* bench, const std::string& name) : line_("{") {
+    set("bench", bench);
+    set("case", name);
+  }
+
+  Result& set(const char* key, const std::string& value) {
+    appendKey(key);
+    line_ += '"';
+    for (char c : value) {
+      if (c == '"' || c == '\\') line_ += '\\';
+      line_ += c;
+    }
+    line_ += '"';
+    return *this;
+  }
+  Result& set(const char* key, const char* value) {
+    return set(key, std::string(value));
+  }
+  Result& set(const char* key, int64_t value) {
+    appendKey(key);
+    line_ += std::to_string(value);
+    return *this;
+  }
+  Result& set(const char* key, int value) {
+    return set(key, static_cast<int64_t>(value));
+  }
+  Result& set(const char* key, size_t value) {
+    return set(key, static_cast<int64_t>(value));
+  }
+  // inf、nan（如耗时为 0 时的速率）不是合法的 JSON 数值，输出为 null
+  Result& set(const char* key, double value) {
+    appendKey(key);
+    if (!std::isfinite(value)) {
+      line_ += "null";
+      return *this;
+    }
+    char buf[32];
+    snprintf(buf, sizeof buf, "%.6g", value);
+    line_ += buf;
+    return *this;
+  }
+
+  // 以纳秒记录的延迟分布，输出为 <prefix>_p50_us 等以微秒为单位的字段
+  Result& setLatency(const std::string& prefix, const HistogramSnapshot& h) {
+    set((prefix + "_count").c_str(), static_cast<int64_t>(h.count()));
+    set((prefix + "_mean_us").c_str(), h.mean() / 1e3);
+    set((prefix + "_p50_us").c_str(), h.percentile(50) / 1e3);
+    set((prefix + "_p90_us").c_str(), h.percentile(90) / 1e3);
+    set((prefix + "_p99_us").c_str(), h.percentile(99) / 1e3);
+    set((prefix + "_p999_us").c_str(), h.percentile(99.9) / 1e3);
+    set((prefix + "_max_us").c_str(), h.max() / 1e3);
+    return *this;
+  }
+
+  void print() {
+    printf("%s}\n", line_.c_str());
+    fflush(stdout);
+  }
+
+ private:
+  void appendKey(const char* key) {
+    if (line_.size() > 1) line_ += ',';
+    line_ += '"';
+    line_ += key;
+    line_ += "\":";
+  }
+
+  std::string line_;
+};
+
+}  // namespace bench
+}  // namespace jmuduo
+
+#endif
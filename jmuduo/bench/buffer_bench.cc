@@ -0,0 +1,140 @@
+/**
+ * Buffer 的微基准测试，每个用例重复 3 轮，取最快一轮每次操作的耗时：
+ * 1. append_small：逐次追加 16 字节，每 1024 次 retrieveAll
+ * 2. append_large：逐次追加 4KB 直到 1MB，再 retrieveAll（包括扩容）
+ * 3. prepend_header：追加 256 字节的消息后在前面加 4 字节的长度头，再取出（编解码器的用法）
+ * 4. read_int32：依次读取网络字节序的 int32
+ * 5. find_crlf：在 4KB 的数据中查找结尾的 CRLF
+ * 6. read_fd：从 socketpair 读取 64KB 到 Buffer（readv + 栈上的额外缓冲区）
+ *
+ * 用法：./buffer_bench [每轮的次数倍数]
+ */
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+// 每次操作的耗时，纳秒，3 轮中最快的一轮
+double measure(int64_t ops, const std::function<void()>& round) {
+  double best = 0;
+  for (int i = 0; i < 3; ++i) {
+    int64_t start = bench::nowNanos();
+    round();
+    double perOp = double(bench::nowNanos() - start) / ops;
+    if (i == 0 || perOp < best) best = perOp;
+  }
+  return best;
+}
+
+void report(const char* name, int64_t ops, double nsPerOp, size_t bytesPerOp) {
+  bench::Result r("buffer", name);
+  r.set("ops", ops).set("ns_per_op", nsPerOp);
+  if (bytesPerOp > 0) r.set("mib_per_sec", bytesPerOp / nsPerOp * 1e9 / 1024 / 1024);
+  r.print();
+}
+
+int main(int argc, char* argv[]) {
+  int64_t scale = argc > 1 ? atoi(argv[1]) : 1;
+  Logger::setOutput(bench::stderrOutput);
+
+  {
+    const int64_t ops = scale * 4 * 1024 * 1024;
+    char data[16] = {};
+    Buffer buf;
+    double ns = measure(ops, [&] {
+      for (int64_t i = 0; i < ops; ++i) {
+        buf.append(data, sizeof data);
+        if ((i & 1023) == 1023) buf.retrieveAll();
+      }
+      buf.retrieveAll();
+    });
+    report("append_small", ops, ns, sizeof data);
+  }
+
+  {
+    const int64_t ops = scale * 64 * 1024;
+    std::string data(4096, 'x');
+    double ns = measure(ops, [&] {
+      for (int64_t i = 0; i < ops; i += 256) {
+        Buffer buf;  // 每 1MB 重新分配，包括扩容的开销
+        for (int j = 0; j < 256; ++j) buf.append(data);
+        bench::doNotOptimize(buf.peek());
+      }
+    });
+    report("append_large", ops, ns, data.size());
+  }
+
+  {
+    const int64_t ops = scale * 1024 * 1024;
+    std::string message(256, 'x');
+    Buffer buf;
+    double ns = measure(ops, [&] {
+      for (int64_t i = 0; i < ops; ++i) {
+        buf.append(message);
+        buf.prependInt32(static_cast<int32_t>(message.size()));
+        int32_t len = buf.readInt32();
+        buf.retrieve(len);
+      }
+    });
+    report("prepend_header", ops, ns, message.size());
+  }
+
+  {
+    const int64_t ops = scale * 4 * 1024 * 1024;
+    Buffer buf;
+    double ns = measure(ops, [&] {
+      int64_t sum = 0;
+      for (int64_t i = 0; i < ops; i += 1024) {
+        for (int j = 0; j < 1024; ++j) buf.appendInt32(j);
+        for (int j = 0; j < 1024; ++j) sum += buf.readInt32();
+      }
+      bench::doNotOptimize(sum);
+    });
+    report("read_int32", ops, ns, 0);
+  }
+
+  {
+    const int64_t ops = scale * 256 * 1024;
+    Buffer buf;
+    buf.append(std::string(4094, 'x'));
+    buf.append("\r\n");
+    double ns = measure(ops, [&] {
+      for (int64_t i = 0; i < ops; ++i) bench::doNotOptimize(buf.findCRLF());
+    });
+    report("find_crlf", ops, ns, buf.readableBytes());
+  }
+
+  {
+    const int64_t ops = scale * 16 * 1024;
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      perror("socketpair");
+      return 1;
+    }
+    std::string data(65536, 'x');
+    Buffer buf;
+    double ns = measure(ops, [&] {
+      // 64KB 小于 socketpair 默认的缓冲区大小，一次写入不会阻塞
+      for (int64_t i = 0; i < ops; ++i) {
+        if (::write(fds[0], data.data(), data.size()) !=
+            static_cast<ssize_t>(data.size()))
+          abort();
+        int err = 0;
+        while (buf.readableBytes() < data.size() && buf.readFd(fds[1], &err) > 0) {
+        }
+        buf.retrieveAll();
+      }
+    });
+    report("read_fd", ops, ns, data.size());
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+}
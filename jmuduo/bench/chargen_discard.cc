@@ -0,0 +1,150 @@
+/**
+ * 单向带宽测试：同一进程中运行 chargen 服务端和 discard 客户端。客户端连接后发送块大小，
+ * 服务端收到后以及每次输出缓冲区发送完毕（WriteCompleteCallback）时发送一块 chunk 字节的数据，
+ * 发送速度不超过客户端的接收速度；客户端丢弃收到的数据，统计每秒收到的字节数
+ *
+ * 用法：./chargen_discard [秒数] [IO 线程数] [连接数] [块大小]
+ * 服务端和客户端各使用 IO 线程数个线程（0 表示都在各自的主线程中）；
+ * 不指定连接数和块大小时，测试 {1, 8} 个连接 x {4096, 65536} 字节的组合
+ */
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/EventLoopThreadPool.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9973;
+
+using Chunk = std::shared_ptr<const std::string>;
+
+void sendChunk(const TcpConnectionPtr& conn) {
+  if (auto chunk = std::any_cast<Chunk>(conn->getMutableContext()))
+    conn->send(**chunk);
+}
+
+struct alignas(64) Counter {
+  std::atomic<int64_t> bytes{0};
+};
+
+void runCase(EventLoop* loop, EventLoopThreadPool* pool, int threads,
+             double seconds, int connections, size_t chunk) {
+  std::unique_ptr<Counter[]> counters(new Counter[connections]);
+  std::atomic<int> connected{0};
+  std::atomic<int> disconnected{0};
+  auto totalBytes = [&] {
+    int64_t sum = 0;
+    for (int i = 0; i < connections; ++i)
+      sum += counters[i].bytes.load(std::memory_order_relaxed);
+    return sum;
+  };
+
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < connections; ++i) {
+    clients.emplace_back(new TcpClient(
+        pool->getNextLoop(), InetAddress("127.0.0.1", kPort), "discard"));
+    Counter* counter = &counters[i];
+    clients.back()->setConnectionCallback([&](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        Buffer request;
+        request.appendInt64(chunk);
+        conn->send(&request);
+        connected.fetch_add(1);
+      } else {
+        disconnected.fetch_add(1);
+      }
+    });
+    clients.back()->setMessageCallback(
+        [counter](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+          counter->bytes.store(
+              counter->bytes.load(std::memory_order_relaxed) + buf->readableBytes(),
+              std::memory_order_relaxed);
+          buf->retrieveAll();
+        });
+    clients.back()->connect();
+  }
+
+  int64_t start = 0, startBytes = 0, end = 0, endBytes = 0;
+  std::function<void()> check;
+  check = [&] {
+    if (start == 0) {
+      if (connected.load() < connections) {
+        loop->runAfter(0.01, check);
+        return;
+      }
+      start = bench::nowNanos();
+      startBytes = totalBytes();
+      loop->runAfter(seconds, check);
+    } else if (end == 0) {
+      end = bench::nowNanos();
+      endBytes = totalBytes();
+      // 客户端关闭连接后服务端的 read 返回 0，服务端随之关闭
+      for (auto& client : clients) client->disconnect();
+      loop->runAfter(0.01, check);
+    } else if (disconnected.load() < connections) {
+      loop->runAfter(0.01, check);
+    } else {
+      loop->quit();
+    }
+  };
+  loop->runAfter(0.01, check);
+  loop->loop();
+  clients.clear();
+
+  double elapsed = (end - start) / 1e9;
+  bench::Result("chargen_discard", "conn" + std::to_string(connections) +
+                                       "_chunk" + std::to_string(chunk))
+      .set("threads", threads)
+      .set("connections", connections)
+      .set("chunk_size", chunk)
+      .set("seconds", elapsed)
+      .set("mib_per_sec", (endBytes - startBytes) / elapsed / 1024 / 1024)
+      .print();
+}
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setThreadNum(threads);
+  // 收到块大小后开始发送，之后输出缓冲区每发送完一块就再发送一块
+  server.setWriteCompleteCallback(sendChunk);
+  server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    if (!conn->getContext().has_value() && buf->readableBytes() >= sizeof(int64_t)) {
+      conn->setContext(std::make_shared<const std::string>(buf->readInt64(), 'x'));
+      sendChunk(conn);
+    }
+    buf->retrieveAll();
+  });
+  serverLoop->call([&server] { server.start(); }).get();
+
+  EventLoop loop;
+  EventLoopThreadPool pool(&loop);
+  pool.setThreadNum(threads);
+  pool.start();
+
+  if (argc > 4) {
+    runCase(&loop, &pool, threads, seconds, atoi(argv[3]), atoi(argv[4]));
+    return 0;
+  }
+  for (int connections : {1, 8})
+    for (size_t chunk : {4096, 65536})
+      runCase(&loop, &pool, threads, seconds, connections, chunk);
+}
@@ -0,0 +1,140 @@
+/**
+ * echo 延迟测试：同一进程中运行 echo 服务端和客户端，每个连接同时只有一个请求在途（闭环），
+ * 请求的前 8 个字节是发送时间，收到完整的回显后记录往返时间，再发送下一个请求。
+ * 输出往返时间的分位数和每秒完成的请求数；开始计时前先预热一段时间，预热期间的请求不计入
+ *
+ * 用法：./echo_latency [秒数] [服务端 IO 线程数] [连接数] [消息长度]
+ * 客户端运行在主线程中；不指定连接数和消息长度时，测试 {1, 16} 个连接 x {64, 4096} 字节的组合
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9972;
+const double kWarmup = 0.2;
+
+void runCase(EventLoop* loop, int serverThreads, double seconds,
+             int connections, size_t size) {
+  size = std::max(size, sizeof(int64_t));
+  std::string message(size, 'x');
+  auto sendRequest = [&message](const TcpConnectionPtr& conn) {
+    int64_t now = bench::nowNanos();
+    memcpy(&message[0], &now, sizeof now);
+    conn->send(message);
+  };
+
+  // 只在主线程中访问
+  Histogram rtt;
+  bool recording = false;
+  int connected = 0;
+  int disconnected = 0;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < connections; ++i) {
+    clients.emplace_back(
+        new TcpClient(loop, InetAddress("127.0.0.1", kPort), "echo_latency"));
+    clients.back()->setConnectionCallback([&](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        ++connected;
+        sendRequest(conn);
+      } else {
+        ++disconnected;
+      }
+    });
+    clients.back()->setMessageCallback(
+        [&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          while (buf->readableBytes() >= size) {
+            int64_t sent;
+            memcpy(&sent, buf->peek(), sizeof sent);
+            buf->retrieve(size);
+            if (recording) rtt.record(bench::nowNanos() - sent);
+            sendRequest(conn);
+          }
+        });
+    clients.back()->connect();
+  }
+
+  int64_t start = 0, end = 0;
+  std::function<void()> check;
+  check = [&] {
+    if (start == 0) {
+      if (connected < connections) {
+        loop->runAfter(0.01, check);
+        return;
+      }
+      // 连接全部建立后预热，然后开始记录
+      start = -1;
+      loop->runAfter(kWarmup, check);
+    } else if (start < 0) {
+      start = bench::nowNanos();
+      recording = true;
+      loop->runAfter(seconds, check);
+    } else if (end == 0) {
+      end = bench::nowNanos();
+      recording = false;
+      for (auto& client : clients) client->disconnect();
+      loop->runAfter(0.01, check);
+    } else if (disconnected < connections) {
+      loop->runAfter(0.01, check);
+    } else {
+      loop->quit();
+    }
+  };
+  loop->runAfter(0.01, check);
+  loop->loop();
+  clients.clear();
+
+  HistogramSnapshot s = rtt.snapshot();
+  double elapsed = (end - start) / 1e9;
+  bench::Result("echo_latency", "conn" + std::to_string(connections) +
+                                    "_size" + std::to_string(size))
+      .set("server_threads", serverThreads)
+      .set("connections", connections)
+      .set("message_size", size)
+      .set("seconds", elapsed)
+      .set("requests_per_sec", s.count() / elapsed)
+      .setLatency("rtt", s)
+      .print();
+}
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  int serverThreads = argc > 2 ? atoi(argv[2]) : 0;
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setThreadNum(serverThreads);
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback(
+      [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+  serverLoop->call([&server] { server.start(); }).get();
+
+  EventLoop loop;
+  if (argc > 4) {
+    runCase(&loop, serverThreads, seconds, atoi(argv[3]), atoi(argv[4]));
+    return 0;
+  }
+  for (int connections : {1, 16})
+    for (size_t size : {64, 4096})
+      runCase(&loop, serverThreads, seconds, connections, size);
+}
@@ -0,0 +1,537 @@
+/**
+ * 多线程的压测客户端，连接平均分配到 EventLoopThreadPool 的各个事件循环，每个事件循环
+ * 由一个 Worker 负责发送请求和统计，直方图和计数器只在所属的 IO 线程中更新，结束时汇总
+ * 1. closed（闭环）：每个连接同时有 depth 个请求在途，收到一个响应立即发送下一个请求。
+ *    服务端停顿时客户端也停止发送，停顿期间本应发出的请求的延迟没有被记录（协同遗漏），
+ *    latency 用 Histogram::recordWithExpectedInterval 按期望的请求间隔补记这些样本，
+ *    期望间隔由 -i 指定，不指定时取预热期间往返时间的中位数
+ * 2. open（开环）：每个 Worker 按 rate / 线程数 的速率在固定的时间点产生请求，不受响应
+ *    快慢的影响，交给在途请求少于 depth 的连接发送，都没有空闲时排队等待。
+ *    latency 从请求预定的发送时间开始计算，包括排队的时间，没有协同遗漏
+ * service 是从实际发送到收到响应的时间，即没有修正的往返时间
+ *
+ * 协议：
+ * 1. echo：请求是 payload 字节的数据，收到相同长度的回显为一个响应，适用于 jmuduo 的
+ *    echo 服务端，如 test/tcpclient_echo、bench/pingpong 的服务端
+ * 2. http：请求是 GET path 的长连接请求，按 Content-Length 解析响应。服务端关闭连接
+ *    （如 pool/webserver 每个响应后都关闭连接）时自动重连并继续发送；
+ *    pool/webserver 不支持 pipeline，depth 必须为 1
+ *
+ * 用法：./loadgen [-h host] [-p port] [-c 连接数] [-t IO 线程数] [-m closed|open]
+ *                 [-r 每秒请求数] [-d 每个连接的在途请求数] [-s payload 字节数]
+ *                 [-P echo|http] [-u path] [-D 秒数] [-w 预热秒数] [-i 期望间隔 us]
+ * 不指定端口时在进程内启动 echo（9974）和 HttpServer（9975）服务端，不带参数时测试
+ * 闭环/开环 x echo/http 的组合。压测其他服务端：
+ *   ./loadgen -p 9981 -c 1000 -t 4 -m open -r 50000 -d 4
+ *   ./webserver 127.0.0.1 12345 & ./loadgen -p 12345 -P http -u /hw.html -c 50 2>/dev/null
+ * 日志输出到 stderr（如 webserver 关闭连接时发送 RST 产生的错误日志），stdout 只有结果。
+ * 几千个连接需要足够的文件描述符（ulimit -n），启动时会把软限制提高到硬限制
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../http/HttpRequest.h"
+#include "../http/HttpResponse.h"
+#include "../http/HttpServer.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/EventLoopThreadPool.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+const uint16_t kEchoPort = 9974;
+const uint16_t kHttpPort = 9975;
+// 开环模式两次产生请求之间的最小间隔，速率较高时每次产生多个请求
+const double kMinTick = 50e-6;
+
+struct Options {
+  std::string host = "127.0.0.1";
+  uint16_t port = 0;  // 0 表示使用进程内的服务端
+  int connections = 100;
+  int threads = 0;
+  bool open = false;
+  double rate = 20000;
+  int depth = 1;
+  size_t payload = 64;
+  bool http = false;
+  std::string path = "/";
+  double seconds = 1;
+  double warmup = 0.2;
+  double expectedInterval = 0;  // us，0 表示取预热期间的中位数
+};
+
+// 一个 Worker 的计数，在所属的 IO 线程中更新
+struct WorkerStats {
+  int64_t completed = 0;   // 计时期间完成的请求数
+  int64_t errors = 0;      // 非 2xx 的 HTTP 响应
+  int64_t dropped = 0;     // 连接断开时丢失的在途请求
+  int64_t unfinished = 0;  // 计时结束时还未完成（在途或排队）的请求
+  int64_t connects = 0;    // 建立连接的次数，包括重连
+  int64_t maxBacklog = 0;  // 开环模式排队的最大请求数
+  int64_t expectedIntervalNanos = 0;
+};
+
+class Worker;
+
+struct Request {
+  int64_t intended;  // 预定的发送时间，闭环模式等于 sent
+  int64_t sent;
+};
+
+// 一个压测连接，只在所属 Worker 的事件循环中访问
+class Session : noncopyable {
+ public:
+  Session(Worker* worker, EventLoop* loop, const InetAddress& addr,
+          const Options& opt, const std::string& request);
+
+  void start() { client_.connect(); }
+  // 停止重连并关闭连接
+  void stop() {
+    client_.stop();
+    client_.disconnect();
+  }
+
+  // 连接已建立、服务端没有要求关闭且在途请求少于 depth
+  bool ready() const {
+    return conn_ && !closing_ && static_cast<int>(inflight_.size()) < depth_;
+  }
+  void send(int64_t intended) {
+    inflight_.push_back({intended, bench::nowNanos()});
+    conn_->send(request_);
+  }
+  bool connected() const { return conn_ != nullptr; }
+  const std::deque<Request>& inflight() const { return inflight_; }
+
+ private:
+  void onConnection(const TcpConnectionPtr& conn);
+  void onMessage(Buffer* buf);
+  // 从 buf 中取出一个完整的 HTTP 响应，不完整时返回 false
+  bool parseHttpResponse(Buffer* buf, bool* ok);
+
+  Worker* worker_;
+  TcpClient client_;
+  const std::string& request_;
+  const bool http_;
+  const int depth_;
+  TcpConnectionPtr conn_;
+  bool closing_;  // 服务端的响应带有 Connection: close，等待重连
+  std::deque<Request> inflight_;
+};
+
+// 一个事件循环中的所有连接的请求调度和统计。开环模式的定时器持有 Worker，
+// 停止后最后一个定时器到期时才析构
+class Worker : noncopyable, public std::enable_shared_from_this<Worker> {
+ public:
+  Worker(EventLoop* loop, const Options& opt, int numWorkers)
+      : loop_(loop),
+        open_(opt.open),
+        interval_(static_cast<int64_t>(1e9 * numWorkers / opt.rate)),
+        expectedOption_(static_cast<int64_t>(opt.expectedInterval * 1e3)),
+        running_(false),
+        recording_(false),
+        recordStart_(0),
+        next_(0),
+        nextSession_(0) {}
+
+  EventLoop* loop() const { return loop_; }
+  void add(Session* s) { sessions_.push_back(s); }
+
+  // 以下在 IO 线程中调用
+  void startLoad() {
+    running_ = true;
+    if (open_) {
+      next_ = bench::nowNanos();
+      tick();
+    } else {
+      for (Session* s : sessions_) fill(s);
+    }
+  }
+
+  void startRecording() {
+    stats_.expectedIntervalNanos =
+        expectedOption_ > 0 ? expectedOption_ : warmup_.snapshot().percentile(50);
+    recordStart_ = bench::nowNanos();
+    recording_ = true;
+  }
+
+  void stopLoad() {
+    running_ = false;
+    recording_ = false;
+    for (Session* s : sessions_)
+      for (const Request& req : s->inflight())
+        if (req.intended >= recordStart_) ++stats_.unfinished;
+    stats_.unfinished += static_cast<int64_t>(backlog_.size());
+    backlog_.clear();
+  }
+
+  int64_t connectedSessions() const {
+    return std::count_if(sessions_.begin(), sessions_.end(),
+                         [](Session* s) { return s->connected(); });
+  }
+  const WorkerStats& stats() const { return stats_; }
+  const Histogram& latency() const { return latency_; }
+  const Histogram& service() const { return service_; }
+
+  // 以下由 Session 回调
+  void onConnected(Session* s) {
+    ++stats_.connects;
+    fill(s);
+  }
+
+  void onResponse(Session* s, const Request& req, bool ok) {
+    int64_t now = bench::nowNanos();
+    if (recording_ && req.intended >= recordStart_) {
+      ++stats_.completed;
+      if (!ok) ++stats_.errors;
+      service_.record(now - req.sent);
+      if (open_)
+        latency_.record(now - req.intended);
+      else
+        latency_.recordWithExpectedInterval(now - req.sent,
+                                            stats_.expectedIntervalNanos);
+    } else if (running_ && !open_) {
+      warmup_.record(now - req.sent);
+    }
+    fill(s);
+  }
+
+  void onDisconnected(size_t lost) {
+    if (recording_) stats_.dropped += static_cast<int64_t>(lost);
+  }
+
+ private:
+  // 在连接上补足请求：闭环模式补足 depth 个，开环模式发送排队的请求
+  void fill(Session* s) {
+    if (!running_) return;
+    while (s->ready()) {
+      if (!open_) {
+        s->send(bench::nowNanos());
+      } else if (!backlog_.empty()) {
+        s->send(backlog_.front());
+        backlog_.pop_front();
+      } else {
+        break;
+      }
+    }
+  }
+
+  // 开环模式：产生所有预定时间已到的请求，再在下一个预定时间唤醒
+  void tick() {
+    if (!running_) return;
+    int64_t now = bench::nowNanos();
+    for (; next_ <= now; next_ += interval_) issue(next_);
+    stats_.maxBacklog =
+        std::max(stats_.maxBacklog, static_cast<int64_t>(backlog_.size()));
+    double delay = std::max((next_ - bench::nowNanos()) / 1e9, kMinTick);
+    loop_->runAfter(delay, [self = shared_from_this()] { self->tick(); });
+  }
+
+  // 交给下一个空闲的连接发送，都不空闲时排队
+  void issue(int64_t intended) {
+    if (backlog_.empty()) {
+      for (size_t i = 0; i < sessions_.size(); ++i) {
+        Session* s = sessions_[nextSession_];
+        nextSession_ = (nextSession_ + 1) % sessions_.size();
+        if (s->ready()) {
+          s->send(intended);
+          return;
+        }
+      }
+    }
+    backlog_.push_back(intended);
+  }
+
+  EventLoop* loop_;
+  const bool open_;
+  const int64_t interval_;  // 开环模式本 Worker 两个请求的间隔
+  const int64_t expectedOption_;
+  std::vector<Session*> sessions_;
+  bool running_;
+  bool recording_;
+  int64_t recordStart_;
+  int64_t next_;  // 开环模式下一个请求的预定发送时间
+  size_t nextSession_;
+  std::deque<int64_t> backlog_;  // 开环模式排队的请求的预定发送时间
+  WorkerStats stats_;
+  Histogram warmup_;
+  Histogram latency_;
+  Histogram service_;
+};
+
+Session::Session(Worker* worker, EventLoop* loop, const InetAddress& addr,
+                 const Options& opt, const std::string& request)
+    : worker_(worker),
+      client_(loop, addr, "loadgen"),
+      request_(request),
+      http_(opt.http),
+      depth_(opt.depth),
+      closing_(false) {
+  client_.enableRetry();
+  client_.setConnectionCallback(
+      [this](const TcpConnectionPtr& conn) { onConnection(conn); });
+  client_.setMessageCallback(
+      [this](const TcpConnectionPtr&, Buffer* buf, Timestamp) { onMessage(buf); });
+}
+
+void Session::onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    conn->setTcpNoDelay(true);
+    conn_ = conn;
+    closing_ = false;
+    worker_->onConnected(this);
+  } else {
+    conn_.reset();
+    worker_->onDisconnected(inflight_.size());
+    inflight_.clear();
+  }
+}
+
+void Session::onMessage(Buffer* buf) {
+  bool ok = true;
+  while (!inflight_.empty()) {
+    if (http_) {
+      if (!parseHttpResponse(buf, &ok)) break;
+    } else {
+      if (buf->readableBytes() < request_.size()) break;
+      buf->retrieve(request_.size());
+    }
+    Request req = inflight_.front();
+    inflight_.pop_front();
+    worker_->onResponse(this, req, ok);
+  }
+}
+
+bool Session::parseHttpResponse(Buffer* buf, bool* ok) {
+  // 响应头以空行结束
+  const char* end = static_cast<const char*>(
+      memmem(buf->peek(), buf->readableBytes(), "\r\n\r\n", 4));
+  if (end == nullptr) return false;
+  end += 4;
+  size_t bodyLength = 0;
+  for (const char* line = buf->peek(); line < end;) {
+    const char* crlf = static_cast<const char*>(memmem(line, end - line, "\r\n", 2));
+    if (::strncasecmp(line, "Content-Length:", 15) == 0)
+      bodyLength = strtoul(line + 15, nullptr, 10);
+    else if (::strncasecmp(line, "Connection:", 11) == 0 &&
+             memmem(line, crlf - line, "close", 5) != nullptr)
+      closing_ = true;
+    line = crlf + 2;
+  }
+  size_t total = end - buf->peek() + bodyLength;
+  if (buf->readableBytes() < total) return false;
+  // "HTTP/1.1 200 OK"
+  *ok = buf->readableBytes() > 9 && buf->peek()[9] == '2';
+  buf->retrieve(total);
+  return true;
+}
+
+void runCase(EventLoop* loop, EventLoopThreadPool* pool, const Options& opt) {
+  const std::string request =
+      opt.http ? "GET " + opt.path + " HTTP/1.1\r\nHost: " + opt.host +
+                     "\r\nConnection: keep-alive\r\n\r\n"
+               : std::string(opt.payload, 'x');
+  uint16_t port = opt.port > 0 ? opt.port : opt.http ? kHttpPort : kEchoPort;
+  InetAddress addr(opt.host, port);
+
+  std::vector<EventLoop*> loops = pool->getAllLoops();
+  std::vector<std::shared_ptr<Worker>> workers;
+  for (EventLoop* ioLoop : loops)
+    workers.push_back(
+        std::make_shared<Worker>(ioLoop, opt, static_cast<int>(loops.size())));
+  std::vector<std::unique_ptr<Session>> sessions;
+  for (int i = 0; i < opt.connections; ++i) {
+    Worker* worker = workers[i % workers.size()].get();
+    sessions.emplace_back(new Session(worker, worker->loop(), addr, opt, request));
+    worker->add(sessions.back().get());
+  }
+  for (auto& s : sessions) s->start();
+
+  // 在各个 Worker 的事件循环中执行
+  auto forEachWorker = [&](void (Worker::*f)()) {
+    for (auto& w : workers) w->loop()->call([w = w.get(), f] { (w->*f)(); }).get();
+  };
+  auto sum = [&](int64_t (*f)(const Worker*)) {
+    int64_t n = 0;
+    for (auto& w : workers) n += w->loop()->call([w = w.get(), f] { return f(w); }).get();
+    return n;
+  };
+  auto connects = [](const Worker* w) { return w->stats().connects; };
+  auto live = [](const Worker* w) { return w->connectedSessions(); };
+
+  // 全部连接建立（最多等待 5 秒）后预热，然后计时
+  int64_t deadline = bench::nowNanos() + 5000 * 1000 * 1000LL;
+  int64_t connected = 0, start = 0, end = 0;
+  std::function<void()> check;
+  check = [&] {
+    if (start == 0) {
+      connected = sum(connects);
+      if (connected < opt.connections && bench::nowNanos() < deadline) {
+        loop->runAfter(0.01, check);
+        return;
+      }
+      start = -1;
+      forEachWorker(&Worker::startLoad);
+      loop->runAfter(opt.warmup, check);
+    } else if (start < 0) {
+      forEachWorker(&Worker::startRecording);
+      start = bench::nowNanos();
+      loop->runAfter(opt.seconds, check);
+    } else if (end == 0) {
+      end = bench::nowNanos();
+      forEachWorker(&Worker::stopLoad);
+      for (auto& s : sessions) s->stop();
+      deadline = bench::nowNanos() + 2000 * 1000 * 1000LL;
+      loop->runAfter(0.01, check);
+    } else if (sum(live) > 0 && bench::nowNanos() < deadline) {
+      // 等待连接关闭，之后 Session 不会再被回调
+      loop->runAfter(0.01, check);
+    } else {
+      loop->quit();
+    }
+  };
+  loop->runAfter(0.01, check);
+  loop->loop();
+
+  WorkerStats total;
+  HistogramSnapshot latency, service;
+  for (auto& w : workers) {
+    WorkerStats s = w->loop()->call([w = w.get()] { return w->stats(); }).get();
+    total.completed += s.completed;
+    total.errors += s.errors;
+    total.dropped += s.dropped;
+    total.unfinished += s.unfinished;
+    total.maxBacklog = std::max(total.maxBacklog, s.maxBacklog);
+    total.expectedIntervalNanos += s.expectedIntervalNanos / workers.size();
+    latency.merge(w->latency().snapshot());
+    service.merge(w->service().snapshot());
+  }
+  // 连接关闭后 TcpClient 才能析构
+  sessions.clear();
+
+  double elapsed = (end - start) / 1e9;
+  std::string name = std::string(opt.open ? "open" : "closed") + "_" +
+                     (opt.http ? "http" : "echo") + "_c" +
+                     std::to_string(opt.connections) + "_d" +
+                     std::to_string(opt.depth);
+  bench::Result r("loadgen", name);
+  r.set("mode", opt.open ? "open" : "closed")
+      .set("protocol", opt.http ? "http" : "echo")
+      .set("port", static_cast<int>(port))
+      .set("threads", opt.threads)
+      .set("connections", opt.connections)
+      .set("connected", connected)
+      .set("depth", opt.depth);
+  if (!opt.http) r.set("payload", opt.payload);
+  if (opt.open)
+    r.set("target_rate", opt.rate).set("max_backlog", total.maxBacklog);
+  else
+    r.set("expected_interval_us", total.expectedIntervalNanos / 1e3);
+  r.set("seconds", elapsed)
+      .set("requests_per_sec", total.completed / elapsed)
+      .set("errors", total.errors)
+      .set("dropped", total.dropped)
+      .set("unfinished", total.unfinished)
+      .setLatency("latency", latency)
+      .setLatency("service", service)
+      .print();
+}
+
+// 进程内的服务端，在进程退出时不析构，避免和 IO 线程竞争
+void startServers(int threads) {
+  EventLoop* loop = (new EventLoopThread)->startLoop();
+  TcpServer& echo = *new TcpServer(loop, InetAddress(kEchoPort));
+  echo.setThreadNum(threads);
+  echo.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  echo.setMessageCallback(
+      [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+
+  HttpServer& http = *new HttpServer(loop, InetAddress(kHttpPort));
+  http.setThreadNum(threads);
+  http.setHttpCallback([](const HttpRequest&, HttpResponse* resp) {
+    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setStatusMessage("OK");
+    resp->setContentType("text/plain");
+    resp->setBody("helloworld!\n");
+  });
+  loop->call([&] {
+    echo.start();
+    http.start();
+  }).get();
+}
+
+// 提高打开文件数的软限制，每个连接一个描述符，进程内的服务端还需要一个
+void raiseFileLimit() {
+  struct rlimit rl;
+  if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &rl);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Options opt;
+  int c;
+  while ((c = ::getopt(argc, argv, "h:p:c:t:m:r:d:s:P:u:D:w:i:")) != -1) {
+    switch (c) {
+      case 'h': opt.host = optarg; break;
+      case 'p': opt.port = static_cast<uint16_t>(atoi(optarg)); break;
+      case 'c': opt.connections = std::max(atoi(optarg), 1); break;
+      case 't': opt.threads = atoi(optarg); break;
+      case 'm': opt.open = strcmp(optarg, "open") == 0; break;
+      case 'r': opt.rate = std::max(atof(optarg), 1.0); break;
+      case 'd': opt.depth = std::max(atoi(optarg), 1); break;
+      case 's': opt.payload = std::max(atoi(optarg), 1); break;
+      case 'P': opt.http = strcmp(optarg, "http") == 0; break;
+      case 'u': opt.path = optarg; break;
+      case 'D': opt.seconds = atof(optarg); break;
+      case 'w': opt.warmup = atof(optarg); break;
+      case 'i': opt.expectedInterval = atof(optarg); break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-h host] [-p port] [-c connections] [-t threads] "
+                "[-m closed|open] [-r rate] [-d depth] [-s payload] "
+                "[-P echo|http] [-u path] [-D seconds] [-w warmup] "
+                "[-i expected_interval_us]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+  raiseFileLimit();
+  if (opt.port == 0) startServers(opt.threads);
+
+  EventLoop loop;
+  EventLoopThreadPool pool(&loop);
+  pool.setThreadNum(opt.threads);
+  pool.start();
+
+  if (argc > 1) {
+    runCase(&loop, &pool, opt);
+    return 0;
+  }
+  for (bool http : {false, true}) {
+    for (bool open : {false, true}) {
+      opt.http = http;
+      opt.open = open;
+      runCase(&loop, &pool, opt);
+    }
+  }
+}
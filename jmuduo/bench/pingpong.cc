@@ -0,0 +1,149 @@
+/**
+ * pingpong 吞吐量测试：同一进程中运行 echo 服务端和客户端，每个连接建立后客户端发送一条
+ * size 字节的消息，之后双方收到多少就原样发回多少，统计客户端每秒收到的字节数和消息数。
+ * 连接数多时主要测试事件循环的调度开销，消息大时主要测试 Buffer 的拷贝和 read/write
+ *
+ * 用法：./pingpong [秒数] [IO 线程数] [连接数] [消息长度]
+ * 服务端和客户端各使用 IO 线程数个线程（0 表示都在各自的主线程中）；
+ * 不指定连接数和消息长度时，测试 {1, 10, 100} 个连接 x {16, 4096, 65536} 字节的组合
+ */
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/EventLoopThreadPool.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9971;
+
+// 一次测试中所有客户端连接共享的状态
+struct Session {
+  std::string message;
+  std::atomic<int> connected{0};
+  std::atomic<int> disconnected{0};
+  // 每个连接一个计数器，只被连接所在的 IO 线程修改，避免多个线程争用一个缓存行
+  struct alignas(64) Counter {
+    std::atomic<int64_t> bytes{0};
+  };
+  std::unique_ptr<Counter[]> counters;
+
+  int64_t totalBytes(int n) const {
+    int64_t sum = 0;
+    for (int i = 0; i < n; ++i) sum += counters[i].bytes.load(std::memory_order_relaxed);
+    return sum;
+  }
+};
+
+void runCase(EventLoop* loop, EventLoopThreadPool* pool, int threads,
+             double seconds, int connections, size_t size) {
+  Session session;
+  session.message.assign(size, 'x');
+  session.counters.reset(new Session::Counter[connections]);
+
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < connections; ++i) {
+    clients.emplace_back(new TcpClient(
+        pool->getNextLoop(), InetAddress("127.0.0.1", kPort), "pingpong"));
+    Session::Counter* counter = &session.counters[i];
+    clients.back()->setConnectionCallback([&session](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(session.message);
+        session.connected.fetch_add(1);
+      } else {
+        session.disconnected.fetch_add(1);
+      }
+    });
+    clients.back()->setMessageCallback(
+        [counter](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          counter->bytes.store(
+              counter->bytes.load(std::memory_order_relaxed) + buf->readableBytes(),
+              std::memory_order_relaxed);
+          conn->send(buf);
+        });
+    clients.back()->connect();
+  }
+
+  // 等待所有连接建立后开始计时，计时结束后关闭连接，等待全部断开
+  int64_t start = 0, startBytes = 0, end = 0, endBytes = 0;
+  // 定时器没有取消的接口，用每次重新注册的一次性定时器轮询，最后一次不再注册
+  std::function<void()> check;
+  check = [&] {
+    if (start == 0) {
+      if (session.connected.load() < connections) {
+        loop->runAfter(0.01, check);
+        return;
+      }
+      start = bench::nowNanos();
+      startBytes = session.totalBytes(connections);
+      loop->runAfter(seconds, check);
+    } else if (end == 0) {
+      end = bench::nowNanos();
+      endBytes = session.totalBytes(connections);
+      for (auto& client : clients) client->disconnect();
+      loop->runAfter(0.01, check);
+    } else if (session.disconnected.load() < connections) {
+      loop->runAfter(0.01, check);
+    } else {
+      loop->quit();
+    }
+  };
+  loop->runAfter(0.01, check);
+  loop->loop();
+  clients.clear();
+
+  double elapsed = (end - start) / 1e9;
+  double bytes = static_cast<double>(endBytes - startBytes);
+  bench::Result("pingpong", "conn" + std::to_string(connections) + "_size" +
+                                std::to_string(size))
+      .set("threads", threads)
+      .set("connections", connections)
+      .set("message_size", size)
+      .set("seconds", elapsed)
+      .set("mib_per_sec", bytes / elapsed / 1024 / 1024)
+      .set("messages_per_sec", bytes / size / elapsed)
+      .print();
+}
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  int threads = argc > 2 ? atoi(argv[2]) : 0;
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setThreadNum(threads);
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback(
+      [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) { conn->send(buf); });
+  serverLoop->call([&server] { server.start(); }).get();
+
+  EventLoop loop;
+  EventLoopThreadPool pool(&loop);
+  pool.setThreadNum(threads);
+  pool.start();
+
+  if (argc > 4) {
+    runCase(&loop, &pool, threads, seconds, atoi(argv[3]), atoi(argv[4]));
+    return 0;
+  }
+  for (int connections : {1, 10, 100})
+    for (size_t size : {16, 4096, 65536})
+      runCase(&loop, &pool, threads, seconds, connections, size);
+}
@@ -0,0 +1,93 @@
+/**
+ * 跨线程向事件循环投递任务的测试，目标事件循环运行在单独的 IO 线程中：
+ * 1. throughput：p 个线程各投递 n / p 个 functor（runInLoop），统计每秒执行的 functor 数，
+ *    包括加锁入队、eventfd 唤醒和 doPendingFunctors 批量执行的开销
+ * 2. wakeup：一个线程每隔 50us 投递一个 functor，统计从投递到开始执行的延迟，
+ *    即 eventfd 唤醒阻塞在 poll 中的 IO 线程的延迟
+ * 3. call：EventLoop::call(f).get() 的往返延迟
+ *
+ * 用法：./run_in_loop [functor 总数]
+ */
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../base/thread/Thread.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+void spinFor(int64_t nanos) {
+  int64_t end = bench::nowNanos() + nanos;
+  while (bench::nowNanos() < end) {
+  }
+}
+
+void runThroughput(EventLoop* loop, int producers, int total) {
+  int64_t executed = 0;  // 只在 IO 线程中访问
+  int perProducer = total / producers;
+  std::vector<std::unique_ptr<Thread>> threads;
+  int64_t start = bench::nowNanos();
+  for (int i = 0; i < producers; ++i) {
+    threads.emplace_back(new Thread([loop, perProducer, &executed] {
+      for (int j = 0; j < perProducer; ++j) loop->runInLoop([&executed] { ++executed; });
+    }));
+    threads.back()->start();
+  }
+  for (auto& thread : threads) thread->join();
+  // functor 按投递的顺序执行，call 返回时之前投递的都已经执行完
+  int64_t n = loop->call([&executed] { return executed; }).get();
+  double elapsed = (bench::nowNanos() - start) / 1e9;
+
+  bench::Result("run_in_loop", "throughput_p" + std::to_string(producers))
+      .set("producers", producers)
+      .set("functors", n)
+      .set("seconds", elapsed)
+      .set("functors_per_sec", n / elapsed)
+      .print();
+}
+
+void runWakeup(EventLoop* loop, int samples) {
+  Histogram latency;  // 只在 IO 线程中记录
+  for (int i = 0; i < samples; ++i) {
+    int64_t posted = bench::nowNanos();
+    loop->runInLoop([&latency, posted] { latency.record(bench::nowNanos() - posted); });
+    spinFor(50 * 1000);
+  }
+  loop->call([] {}).get();
+
+  bench::Result("run_in_loop", "wakeup")
+      .setLatency("latency", latency.snapshot())
+      .print();
+}
+
+void runCall(EventLoop* loop, int samples) {
+  Histogram latency;
+  for (int i = 0; i < samples; ++i) {
+    int64_t start = bench::nowNanos();
+    int x = loop->call([i] { return i; }).get();
+    bench::doNotOptimize(x);
+    latency.record(bench::nowNanos() - start);
+  }
+
+  bench::Result("run_in_loop", "call")
+      .setLatency("roundtrip", latency.snapshot())
+      .print();
+}
+
+int main(int argc, char* argv[]) {
+  int total = argc > 1 ? atoi(argv[1]) : 1000 * 1000;
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+
+  EventLoopThread thread;
+  EventLoop* loop = thread.startLoop();
+  for (int producers : {1, 4}) runThroughput(loop, producers, total);
+  runWakeup(loop, 10000);
+  runCall(loop, 10000);
+}
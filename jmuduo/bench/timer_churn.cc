@@ -0,0 +1,108 @@
+/**
+ * 定时器队列的测试，都在主线程的事件循环中运行：
+ * 1. insert：在事件循环中一次添加 n 个到期时间随机分布在 [0.2s, 0.7s) 的定时器，统计每次
+ *    runAfter 的耗时，全部到期后统计定时器的延迟（实际运行时间减去到期时间）。
+ *    最早的到期时间晚于添加完成的时间，延迟中不包括添加本身阻塞事件循环的时间
+ * 2. churn：保持 k 个定时器，每个定时器到期后立即以 [0.1ms, 10ms) 的随机延迟重新添加自己，
+ *    模拟大量连接的超时定时器不断更新，统计每秒到期的定时器数和延迟
+ *
+ * 用法：./timer_churn [秒数]
+ */
+#include <stdlib.h>
+
+#include <functional>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/EventLoop.h"
+#include "Bench.h"
+
+using namespace jmuduo;
+
+// 线性同余随机数，返回 [0, 1)
+double uniform(uint64_t* state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (*state >> 11) * (1.0 / (1ULL << 53));
+}
+
+void recordLateness(Histogram* h, int64_t expected) {
+  int64_t late = bench::nowNanos() - expected;
+  h->record(late > 0 ? late : 0);
+}
+
+void runInsert(EventLoop* loop, int n) {
+  Histogram lateness;
+  uint64_t seed = 1;
+  int fired = 0;
+  int64_t insertNanos = 0;
+  loop->runInLoop([&] {
+    int64_t start = bench::nowNanos();
+    for (int i = 0; i < n; ++i) {
+      double delay = 0.2 + uniform(&seed) * 0.5;
+      int64_t expected = bench::nowNanos() + static_cast<int64_t>(delay * 1e9);
+      loop->runAfter(delay, [&, expected] {
+        recordLateness(&lateness, expected);
+        if (++fired == n) loop->quit();
+      });
+    }
+    insertNanos = bench::nowNanos() - start;
+  });
+  loop->loop();
+
+  bench::Result("timer_churn", "insert" + std::to_string(n))
+      .set("timers", n)
+      .set("insert_ns", static_cast<double>(insertNanos) / n)
+      .setLatency("lateness", lateness.snapshot())
+      .print();
+}
+
+void runChurn(EventLoop* loop, int k, double seconds) {
+  Histogram lateness;
+  uint64_t seed = 2;
+  bool running = true;
+  int outstanding = 0;
+  int64_t fired = 0;
+
+  std::function<void()> arm;
+  arm = [&] {
+    double delay = 0.0001 + uniform(&seed) * 0.0099;
+    int64_t expected = bench::nowNanos() + static_cast<int64_t>(delay * 1e9);
+    ++outstanding;
+    loop->runAfter(delay, [&, expected] {
+      recordLateness(&lateness, expected);
+      ++fired;
+      --outstanding;
+      if (running)
+        arm();
+      else if (outstanding == 0)
+        loop->quit();
+    });
+  };
+  for (int i = 0; i < k; ++i) arm();
+
+  int64_t start = bench::nowNanos(), end = 0, firedAtEnd = 0;
+  loop->runAfter(seconds, [&] {
+    end = bench::nowNanos();
+    firedAtEnd = fired;
+    running = false;
+  });
+  loop->loop();
+
+  double elapsed = (end - start) / 1e9;
+  bench::Result("timer_churn", "churn" + std::to_string(k))
+      .set("timers", k)
+      .set("seconds", elapsed)
+      .set("fires_per_sec", firedAtEnd / elapsed)
+      .setLatency("lateness", lateness.snapshot())
+      .print();
+}
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+  Logger::setOutput(bench::stderrOutput);
+
+  EventLoop loop;
+  for (int n : {10000, 100000}) runInsert(&loop, n);
+  for (int k : {100, 10000}) runChurn(&loop, k, seconds);
+}
@@ -0,0 +1,90 @@
+#include "HttpContext.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "../reactor/Buffer.h"
+
+using namespace jmuduo;
+
+bool HttpContext::processRequestLine(const char* begin, const char* end) {
+  const char* start = begin;
+  const char* space = std::find(start, end, ' ');
+  if (space == end || !request_.setMethod(start, space)) return false;
+
+  start = space + 1;
+  space = std::find(start, end, ' ');
+  if (space == end) return false;
+  const char* question = std::find(start, space, '?');
+  if (question != space) {
+    request_.setPath(start, question);
+    request_.setQuery(question + 1, space);
+  } else {
+    request_.setPath(start, space);
+  }
+
+  start = space + 1;
+  if (end - start != 8 || !std::equal(start, end - 1, "HTTP/1.")) return false;
+  if (*(end - 1) == '1') {
+    request_.setVersion(HttpRequest::kHttp11);
+  } else if (*(end - 1) == '0') {
+    request_.setVersion(HttpRequest::kHttp10);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool HttpContext::processHeadersEnd() {
+  if (!request_.getHeader("Transfer-Encoding").empty()) return false;
+  std::string length = request_.getHeader("Content-Length");
+  if (length.empty()) {
+    state_ = kGotAll;
+    return true;
+  }
+  char* end;
+  unsigned long long n = strtoull(length.c_str(), &end, 10);
+  if (*end != '\0' || n > kMaxBodyLength) return false;
+  bodyLength_ = n;
+  state_ = bodyLength_ > 0 ? kExpectBody : kGotAll;
+  return true;
+}
+
+bool HttpContext::parseRequest(Buffer* buf, Timestamp receiveTime) {
+  while (state_ != kGotAll) {
+    if (state_ == kExpectBody) {
+      if (buf->readableBytes() < bodyLength_) break;
+      request_.setBody(buf->peek(), buf->peek() + bodyLength_);
+      buf->retrieve(bodyLength_);
+      state_ = kGotAll;
+      break;
+    }
+
+    // 请求行和头部都以 "\r\n" 结尾
+    const char* crlf = buf->findCRLF(scanned_);
+    if (crlf == nullptr) {
+      size_t readable = buf->readableBytes();
+      if (readable > kMaxLineLength) return false;
+      // '\r' 可能是最后一个字节
+      scanned_ = readable > 0 ? readable - 1 : 0;
+      break;
+    }
+    scanned_ = 0;
+
+    const char* begin = buf->peek();
+    if (state_ == kExpectRequestLine) {
+      if (!processRequestLine(begin, crlf)) return false;
+      request_.setReceiveTime(receiveTime);
+      state_ = kExpectHeaders;
+    } else if (crlf == begin) {  // 空行，头部结束
+      if (!processHeadersEnd()) return false;
+    } else {
+      const char* colon = std::find(begin, crlf, ':');
+      if (colon == crlf) return false;
+      request_.addHeader(begin, colon, crlf);
+    }
+    buf->retrieveUntil(crlf + 2);
+  }
+  return true;
+}
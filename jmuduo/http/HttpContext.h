@@ -0,0 +1,70 @@
+#ifndef _JMUDUO_HTTP_CONTEXT_H_
+#define _JMUDUO_HTTP_CONTEXT_H_
+
+#include <stddef.h>
+
+#include "HttpRequest.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Buffer;
+
+/**
+ * HTTP 请求的增量解析器，保存在每个 TcpConnection 的上下文中
+ * 1. 状态机：请求行 -> 头部 -> 消息体（有 Content-Length 时）-> 完成
+ * 2. 请求可以分多次到达，每次 parseRequest 从上次停下的状态继续，已经解析的行从
+ *    输入缓冲区中取走；不完整的行记录已经查找过的长度，下次只查找新到达的数据
+ * 3. 解析出一个完整的请求后就停止，流水线中的后续请求留在输入缓冲区中，
+ *    调用者处理完当前请求后 reset 再继续解析
+ * 不支持 chunked 编码的请求体
+ */
+class HttpContext : public copyable {
+ public:
+  enum HttpRequestParseState {
+    kExpectRequestLine,
+    kExpectHeaders,
+    kExpectBody,
+    kGotAll,
+  };
+
+  // 请求行和每行头部的最大长度，超过时认为请求出错
+  static const size_t kMaxLineLength = 64 * 1024;
+  // 消息体的最大长度
+  static const size_t kMaxBodyLength = 64 * 1024 * 1024;
+
+  HttpContext() : state_(kExpectRequestLine), scanned_(0), bodyLength_(0) {}
+
+  // 解析 buf 中的数据，请求格式错误时返回 false
+  bool parseRequest(Buffer* buf, Timestamp receiveTime);
+
+  // 是否已经解析出一个完整的请求
+  bool gotAll() const { return state_ == kGotAll; }
+
+  // 开始解析下一个请求
+  void reset() {
+    state_ = kExpectRequestLine;
+    scanned_ = 0;
+    bodyLength_ = 0;
+    HttpRequest dummy;
+    request_.swap(dummy);
+  }
+
+  const HttpRequest& request() const { return request_; }
+  HttpRequest& request() { return request_; }
+
+ private:
+  // 解析请求行 "GET /path?query HTTP/1.1"
+  bool processRequestLine(const char* begin, const char* end);
+  // 头部解析完毕，根据 Content-Length 决定是否需要读取消息体
+  bool processHeadersEnd();
+
+  HttpRequestParseState state_;
+  HttpRequest request_;
+  size_t scanned_;     // 当前行已经查找过 "\r\n" 的长度
+  size_t bodyLength_;  // 消息体的长度
+};
+
+}  // namespace jmuduo
+
+#endif
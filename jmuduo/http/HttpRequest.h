@@ -0,0 +1,118 @@
+#ifndef _JMUDUO_HTTP_REQUEST_H_
+#define _JMUDUO_HTTP_REQUEST_H_
+
+#include <assert.h>
+#include <ctype.h>
+#include <strings.h>
+
+#include <map>
+#include <string>
+
+#include "../base/datetime/Timestamp.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+// HTTP 头部的字段名不区分大小写
+struct CaseInsensitiveLess {
+  bool operator()(const std::string& a, const std::string& b) const {
+    return ::strcasecmp(a.c_str(), b.c_str()) < 0;
+  }
+};
+
+/**
+ * HTTP 请求，由 HttpContext 解析得到
+ */
+class HttpRequest : public copyable {
+ public:
+  enum Method { kInvalid, kGet, kPost, kHead, kPut, kDelete };
+  enum Version { kUnknown, kHttp10, kHttp11 };
+  using Headers = std::map<std::string, std::string, CaseInsensitiveLess>;
+
+  HttpRequest() : method_(kInvalid), version_(kUnknown) {}
+
+  void setVersion(Version v) { version_ = v; }
+  Version getVersion() const { return version_; }
+
+  // 设置请求方法，不支持的方法返回 false
+  bool setMethod(const char* start, const char* end) {
+    assert(method_ == kInvalid);
+    std::string m(start, end);
+    if (m == "GET") {
+      method_ = kGet;
+    } else if (m == "POST") {
+      method_ = kPost;
+    } else if (m == "HEAD") {
+      method_ = kHead;
+    } else if (m == "PUT") {
+      method_ = kPut;
+    } else if (m == "DELETE") {
+      method_ = kDelete;
+    } else {
+      method_ = kInvalid;
+    }
+    return method_ != kInvalid;
+  }
+  Method method() const { return method_; }
+  const char* methodString() const {
+    switch (method_) {
+      case kGet: return "GET";
+      case kPost: return "POST";
+      case kHead: return "HEAD";
+      case kPut: return "PUT";
+      case kDelete: return "DELETE";
+      default: return "UNKNOWN";
+    }
+  }
+
+  void setPath(const char* start, const char* end) { path_.assign(start, end); }
+  const std::string& path() const { return path_; }
+
+  // 请求目标中 '?' 之后的部分，不包括 '?'
+  void setQuery(const char* start, const char* end) { query_.assign(start, end); }
+  const std::string& query() const { return query_; }
+
+  void setReceiveTime(Timestamp t) { receiveTime_ = t; }
+  Timestamp receiveTime() const { return receiveTime_; }
+
+  // 添加一行头部 "field: value"，[start, colon) 为字段名，去掉值两端的空白
+  void addHeader(const char* start, const char* colon, const char* end) {
+    std::string field(start, colon);
+    ++colon;
+    while (colon < end && isspace(static_cast<unsigned char>(*colon))) ++colon;
+    while (end > colon && isspace(static_cast<unsigned char>(end[-1]))) --end;
+    headers_[field] = std::string(colon, end);
+  }
+  // 返回字段的值，不存在时返回空字符串。字段名不区分大小写
+  std::string getHeader(const std::string& field) const {
+    auto it = headers_.find(field);
+    return it == headers_.end() ? std::string() : it->second;
+  }
+  const Headers& headers() const { return headers_; }
+
+  void setBody(const char* start, const char* end) { body_.assign(start, end); }
+  const std::string& body() const { return body_; }
+
+  void swap(HttpRequest& that) {
+    std::swap(method_, that.method_);
+    std::swap(version_, that.version_);
+    path_.swap(that.path_);
+    query_.swap(that.query_);
+    std::swap(receiveTime_, that.receiveTime_);
+    headers_.swap(that.headers_);
+    body_.swap(that.body_);
+  }
+
+ private:
+  Method method_;
+  Version version_;
+  std::string path_;
+  std::string query_;
+  Timestamp receiveTime_;
+  Headers headers_;
+  std::string body_;
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -0,0 +1,35 @@
+#include "HttpResponse.h"
+
+#include <stdio.h>
+
+#include "../reactor/Buffer.h"
+
+using namespace jmuduo;
+
+void HttpResponse::appendToBuffer(Buffer* output, bool includeBody) const {
+  char buf[64];
+  int n = snprintf(buf, sizeof buf, "HTTP/1.1 %d ", statusCode_);
+  output->append(buf, n);
+  output->append(statusMessage_);
+  output->append("\r\n", 2);
+
+  // 客户端根据 Content-Length 确定消息体的结束位置，才能在同一连接上接收下一个响应
+  n = snprintf(buf, sizeof buf, "Content-Length: %zu\r\n", body_.size());
+  output->append(buf, n);
+  if (closeConnection_) {
+    output->append("Connection: close\r\n", 19);
+  } else {
+    // HTTP/1.0 的客户端需要显式的 Keep-Alive 才能复用连接
+    output->append("Connection: Keep-Alive\r\n", 24);
+  }
+
+  for (const auto& header : headers_) {
+    output->append(header.first);
+    output->append(": ", 2);
+    output->append(header.second);
+    output->append("\r\n", 2);
+  }
+
+  output->append("\r\n", 2);
+  if (includeBody) output->append(body_);
+}
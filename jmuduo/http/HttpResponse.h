@@ -0,0 +1,61 @@
+#ifndef _JMUDUO_HTTP_RESPONSE_H_
+#define _JMUDUO_HTTP_RESPONSE_H_
+
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Buffer;
+
+/**
+ * HTTP 响应，由用户回调填写，HttpServer 把它直接序列化到输出 Buffer 中
+ */
+class HttpResponse : public copyable {
+ public:
+  enum HttpStatusCode {
+    kUnknown,
+    k200Ok = 200,
+    k301MovedPermanently = 301,
+    k400BadRequest = 400,
+    k404NotFound = 404,
+  };
+
+  explicit HttpResponse(bool close)
+      : statusCode_(kUnknown), closeConnection_(close) {}
+
+  void setStatusCode(HttpStatusCode code) { statusCode_ = code; }
+  void setStatusMessage(const std::string& message) { statusMessage_ = message; }
+
+  // 发送响应后是否关闭连接
+  void setCloseConnection(bool on) { closeConnection_ = on; }
+  bool closeConnection() const { return closeConnection_; }
+
+  void setContentType(const std::string& contentType) {
+    addHeader("Content-Type", contentType);
+  }
+  void addHeader(const std::string& key, const std::string& value) {
+    headers_[key] = value;
+  }
+
+  void setBody(std::string body) { body_ = std::move(body); }
+  const std::string& body() const { return body_; }
+
+  // 把响应序列化到 output 中，自动添加 Content-Length 和 Connection。
+  // HEAD 请求的响应 includeBody 为 false：保留 Content-Length，不输出消息体
+  void appendToBuffer(Buffer* output, bool includeBody = true) const;
+
+ private:
+  std::map<std::string, std::string> headers_;
+  HttpStatusCode statusCode_;
+  std::string statusMessage_;
+  bool closeConnection_;
+  std::string body_;
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -0,0 +1,76 @@
+#include "HttpServer.h"
+
+#include <strings.h>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "HttpContext.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+
+using namespace jmuduo;
+using namespace std::placeholders;
+
+namespace {
+
+void defaultHttpCallback(const HttpRequest&, HttpResponse* resp) {
+  resp->setStatusCode(HttpResponse::k404NotFound);
+  resp->setStatusMessage("Not Found");
+  resp->setCloseConnection(true);
+}
+
+}  // namespace
+
+HttpServer::HttpServer(EventLoop* loop, const InetAddress& listenAddr)
+    : server_(loop, listenAddr), httpCallback_(defaultHttpCallback) {
+  server_.setConnectionCallback(std::bind(&HttpServer::onConnection, this, _1));
+  server_.setMessageCallback(
+      std::bind(&HttpServer::onMessage, this, _1, _2, _3));
+}
+
+void HttpServer::start() {
+  LOG_INFO << "HttpServer starts";
+  server_.start();
+}
+
+void HttpServer::onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    conn->setContext(HttpContext());
+  }
+}
+
+void HttpServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                           Timestamp receiveTime) {
+  HttpContext* context = std::any_cast<HttpContext>(conn->getMutableContext());
+  // 同一次 read 中所有请求的响应合并后一次发送
+  Buffer output;
+  bool close = false;
+  while (!close) {
+    if (!context->parseRequest(buf, receiveTime)) {
+      static const char kBadRequest[] =
+          "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n"
+          "Connection: close\r\n\r\n";
+      output.append(kBadRequest, sizeof kBadRequest - 1);
+      close = true;
+      break;
+    }
+    if (!context->gotAll()) break;
+    close = onRequest(context->request(), &output);
+    context->reset();
+  }
+  if (output.readableBytes() > 0) conn->send(&output);
+  // 关闭写端，输出缓冲区中的数据发送完毕后才会真正关闭
+  if (close) conn->shutdown();
+}
+
+bool HttpServer::onRequest(const HttpRequest& req, Buffer* output) {
+  const std::string connection = req.getHeader("Connection");
+  bool close =
+      ::strcasecmp(connection.c_str(), "close") == 0 ||
+      (req.getVersion() == HttpRequest::kHttp10 &&
+       ::strcasecmp(connection.c_str(), "Keep-Alive") != 0);
+  HttpResponse response(close);
+  httpCallback_(req, &response);
+  response.appendToBuffer(output, req.method() != HttpRequest::kHead);
+  return response.closeConnection();
+}
@@ -0,0 +1,51 @@
+#ifndef _JMUDUO_HTTP_SERVER_H_
+#define _JMUDUO_HTTP_SERVER_H_
+
+#include <functional>
+#include <string>
+
+#include "../reactor/TcpServer.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class HttpRequest;
+class HttpResponse;
+
+/**
+ * 简单的 HTTP/1.1 服务器，用户在 HttpCallback 中根据请求填写响应
+ * 1. 基于 TcpServer，可以用 setThreadNum 使用多个 IO 线程
+ * 2. 每个连接的 TcpConnection 上下文中保存一个 HttpContext，请求可以分多次到达
+ * 3. 支持长连接：HTTP/1.1 默认保持连接，除非请求带有 "Connection: close"；
+ *    HTTP/1.0 只有带 "Connection: Keep-Alive" 时保持连接
+ * 4. 支持流水线：一次 read 读到的多个请求依次处理，所有响应序列化到同一个 Buffer
+ *    中一次发送
+ * 回调在 IO 线程中执行，不应该阻塞
+ */
+class HttpServer : noncopyable {
+ public:
+  using HttpCallback = std::function<void(const HttpRequest&, HttpResponse*)>;
+
+  HttpServer(EventLoop* loop, const InetAddress& listenAddr);
+
+  EventLoop* getLoop() const { return server_.getLoop(); }
+
+  // 设置处理请求的用户回调，未设置时所有请求都返回 404
+  void setHttpCallback(const HttpCallback& cb) { httpCallback_ = cb; }
+  void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
+  void start();
+
+ private:
+  void onConnection(const TcpConnectionPtr& conn);
+  void onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                 Timestamp receiveTime);
+  // 处理一个完整的请求，响应追加到 output 中，返回是否需要关闭连接
+  bool onRequest(const HttpRequest& req, Buffer* output);
+
+  TcpServer server_;
+  HttpCallback httpCallback_;
+};
+
+}  // namespace jmuduo
+
+#endif
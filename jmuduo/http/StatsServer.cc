@@ -0,0 +1,403 @@
+#include "StatsServer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#include "../base/logging/Logging.h"
+#include "../base/metrics/Tracer.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopMetrics.h"
+#include "../reactor/EventLoopThreadPool.h"
+#include "../reactor/PerfCounters.h"
+#include "HttpContext.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+
+using namespace jmuduo;
+using namespace std::placeholders;
+
+namespace {
+
+// 某个服务在一个 IO 线程中的连接，只保存弱引用，不延长连接的生命期
+using ConnectionGroup =
+    std::pair<EventLoop*, std::vector<std::weak_ptr<TcpConnection>>>;
+
+// 在 server 所在线程中取得的数据
+struct ServerSnapshot {
+  std::vector<EventLoop*> loops;  // server 使用的所有事件循环
+  std::vector<ConnectionGroup> groups;
+};
+
+struct BufferUsage {
+  size_t input = 0;    // 输入缓冲区占用的内存
+  size_t output = 0;   // 输出缓冲区占用的内存
+  size_t pending = 0;  // 输出缓冲区中待发送的数据
+};
+
+// 在连接所属的 IO 线程中调用
+BufferUsage bufferUsage(const std::vector<std::weak_ptr<TcpConnection>>& conns) {
+  BufferUsage usage;
+  for (auto& weak : conns) {
+    if (TcpConnectionPtr conn = weak.lock()) {
+      usage.input += conn->inputBuffer()->internalCapacity();
+      usage.output += conn->outputBuffer()->internalCapacity();
+      usage.pending += conn->outputBuffer()->readableBytes();
+    }
+  }
+  return usage;
+}
+
+/* Prometheus 文本格式 */
+std::string label(const char* key, const std::string& value) {
+  std::string s(key);
+  s += "=\"";
+  for (char c : value) {
+    if (c == '\\' || c == '"') s += '\\';
+    s += c;
+  }
+  s += '"';
+  return s;
+}
+
+void appendType(std::string* page, const char* name, const char* type) {
+  *page += "# TYPE ";
+  *page += name;
+  *page += ' ';
+  *page += type;
+  *page += '\n';
+}
+
+void appendSample(std::string* page, const std::string& name,
+                  const std::string& labels, double value) {
+  char buf[32];
+  snprintf(buf, sizeof buf, " %.17g\n", value);
+  *page += name;
+  if (!labels.empty()) {
+    *page += '{';
+    *page += labels;
+    *page += '}';
+  }
+  *page += buf;
+}
+
+// 以纳秒为单位的直方图输出为以秒为单位的 summary
+void appendSummary(std::string* page, const std::string& name,
+                   const std::string& labels, const HistogramSnapshot& h) {
+  static const struct {
+    const char* label;
+    double percentile;
+  } kQuantiles[] = {{"0.5", 50}, {"0.9", 90}, {"0.99", 99}, {"0.999", 99.9}};
+  for (auto& q : kQuantiles) {
+    std::string l = labels.empty() ? "" : labels + ",";
+    appendSample(page, name, l + label("quantile", q.label),
+                 h.percentile(q.percentile) / 1e9);
+  }
+  appendSample(page, name + "_sum", labels, h.sum() / 1e9);
+  appendSample(page, name + "_count", labels, static_cast<double>(h.count()));
+}
+
+}  // namespace
+
+// 一次收集的中间结果，只在 StatsServer 所在线程中访问
+struct StatsServer::Collection {
+  std::vector<std::vector<EventLoop*>> serverLoops;  // 每个服务使用的事件循环
+  std::vector<size_t> connections;                   // 每个服务的连接数
+  std::vector<BufferUsage> buffers;                  // 每个服务的缓冲区
+  std::map<EventLoop*, size_t> timers;               // 每个事件循环的定时器个数
+  size_t pending = 0;  // 还没有返回的 call 的个数
+  CollectCallback done;
+};
+
+StatsServer::StatsServer(EventLoop* loop, const InetAddress& listenAddr)
+    : loop_(loop), server_(loop, listenAddr) {
+  server_.setConnectionCallback(std::bind(&StatsServer::onConnection, this, _1));
+  server_.setMessageCallback(
+      std::bind(&StatsServer::onMessage, this, _1, _2, _3));
+}
+
+void StatsServer::addServer(TcpServer* server) {
+  servers_.push_back(server);
+  stats_.push_back(server->stats());
+  server->getLoop()->enableMetrics();
+}
+
+void StatsServer::addLoop(EventLoop* loop) {
+  loops_.push_back(loop);
+  loop->enableMetrics();
+}
+
+void StatsServer::addConnectionStats(const ConnectionStatsPtr& stats) {
+  stats_.push_back(stats);
+}
+
+void StatsServer::start() {
+  LOG_INFO << "StatsServer starts";
+  server_.start();
+}
+
+/**
+ * 收集分两个阶段，所有的结果都在 loop_ 中处理，所以 Collection 不需要加锁：
+ * 1. 在每个服务所在的线程中取得它的事件循环和按 IO 线程分组的连接；
+ *    在每个事件循环中取得定时器个数
+ * 2. 第 1 阶段返回后，在每个 IO 线程中统计本线程的连接的缓冲区
+ * pending 在发起每个 call 之前增加、在处理其结果之后减少，减到 0 时全部完成
+ */
+void StatsServer::collect(const CollectCallback& cb) {
+  loop_->assertInLoopThread();
+  auto c = std::make_shared<Collection>();
+  c->serverLoops.resize(servers_.size());
+  c->connections.resize(servers_.size());
+  c->buffers.resize(servers_.size());
+  c->done = cb;
+  // 结果可能在 call 中同步返回（被统计的事件循环就是 loop_），先占一个计数，最后释放
+  c->pending = 1;
+
+  auto queryTimers = [this, c](EventLoop* loop) {
+    if (!c->timers.emplace(loop, 0).second) return;  // 已经查询过
+    loop->enableMetrics();
+    ++c->pending;
+    loop->call([loop] { return loop->numTimers(); })
+        .then(loop_, [this, c, loop](size_t n) {
+          c->timers[loop] = n;
+          finish(c);
+        });
+  };
+
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    TcpServer* server = servers_[i];
+    ++c->pending;
+    server->getLoop()
+        ->call([server] {
+          ServerSnapshot snapshot;
+          snapshot.loops.push_back(server->getLoop());
+          for (EventLoop* loop : server->threadPool()->getAllLoops())
+            if (loop != server->getLoop()) snapshot.loops.push_back(loop);
+          std::map<EventLoop*, std::vector<std::weak_ptr<TcpConnection>>> groups;
+          for (auto& conn : server->connectionList())
+            groups[conn->getLoop()].push_back(conn);
+          snapshot.groups.assign(groups.begin(), groups.end());
+          return snapshot;
+        })
+        .then(loop_, [this, c, i, queryTimers](ServerSnapshot snapshot) {
+          for (EventLoop* loop : snapshot.loops) queryTimers(loop);
+          c->serverLoops[i] = std::move(snapshot.loops);
+          for (auto& group : snapshot.groups) {
+            c->connections[i] += group.second.size();
+            ++c->pending;
+            group.first
+                ->call([conns = std::move(group.second)] {
+                  return bufferUsage(conns);
+                })
+                .then(loop_, [this, c, i](BufferUsage usage) {
+                  c->buffers[i].input += usage.input;
+                  c->buffers[i].output += usage.output;
+                  c->buffers[i].pending += usage.pending;
+                  finish(c);
+                });
+          }
+          finish(c);
+        });
+  }
+  for (EventLoop* loop : loops_) queryTimers(loop);
+  finish(c);
+}
+
+void StatsServer::finish(const std::shared_ptr<Collection>& c) {
+  if (--c->pending == 0) {
+    std::string page;
+    render(*c, &page);
+    c->done(page);
+  }
+}
+
+void StatsServer::render(const Collection& c, std::string* page) const {
+  // 事件循环按服务注册的顺序编号，每次收集的编号相同
+  std::vector<EventLoop*> loops;
+  auto addLoop = [&loops](EventLoop* loop) {
+    if (std::find(loops.begin(), loops.end(), loop) == loops.end())
+      loops.push_back(loop);
+  };
+  for (auto& serverLoops : c.serverLoops)
+    for (EventLoop* loop : serverLoops) addLoop(loop);
+  for (EventLoop* loop : loops_) addLoop(loop);
+
+  std::vector<std::string> loopLabels;
+  for (size_t i = 0; i < loops.size(); ++i)
+    loopLabels.push_back(label("loop", std::to_string(i)));
+
+  appendType(page, "jmuduo_loop_timers", "gauge");
+  for (size_t i = 0; i < loops.size(); ++i) {
+    auto it = c.timers.find(loops[i]);
+    appendSample(page, "jmuduo_loop_timers", loopLabels[i],
+                 it != c.timers.end() ? static_cast<double>(it->second) : 0);
+  }
+
+  // EventLoopMetrics 的快照可以在任意线程中读取
+  std::vector<EventLoopMetrics::Snapshot> metrics(loops.size());
+  for (size_t i = 0; i < loops.size(); ++i)
+    if (EventLoopMetrics* m = loops[i]->metrics()) metrics[i] = m->snapshot();
+
+  appendType(page, "jmuduo_loop_iterations_total", "counter");
+  for (size_t i = 0; i < loops.size(); ++i)
+    appendSample(page, "jmuduo_loop_iterations_total", loopLabels[i],
+                 static_cast<double>(metrics[i].iterations));
+  appendType(page, "jmuduo_loop_poll_wait_seconds", "summary");
+  for (size_t i = 0; i < loops.size(); ++i)
+    appendSummary(page, "jmuduo_loop_poll_wait_seconds", loopLabels[i],
+                  metrics[i].pollWait);
+  appendType(page, "jmuduo_loop_busy_seconds", "summary");
+  for (size_t i = 0; i < loops.size(); ++i)
+    appendSummary(page, "jmuduo_loop_busy_seconds", loopLabels[i],
+                  metrics[i].busy);
+  appendType(page, "jmuduo_loop_functor_seconds", "summary");
+  for (size_t i = 0; i < loops.size(); ++i)
+    appendSummary(page, "jmuduo_loop_functor_seconds", loopLabels[i],
+                  metrics[i].functorTime);
+  appendType(page, "jmuduo_loop_timer_lateness_seconds", "summary");
+  for (size_t i = 0; i < loops.size(); ++i)
+    appendSummary(page, "jmuduo_loop_timer_lateness_seconds", loopLabels[i],
+                  metrics[i].timerLateness);
+  appendType(page, "jmuduo_loop_callback_seconds", "summary");
+  for (size_t i = 0; i < loops.size(); ++i) {
+    for (int k = 0; k < Channel::kNumKinds; ++k) {
+      const HistogramSnapshot& h = metrics[i].callback[k];
+      if (h.count() == 0) continue;
+      appendSummary(
+          page, "jmuduo_loop_callback_seconds",
+          loopLabels[i] + "," +
+              label("kind", Channel::kindName(static_cast<Channel::Kind>(k))),
+          h);
+    }
+  }
+
+  // 性能计数器只输出开启了的事件循环（EventLoop::enablePerfCounters）和可用的计数器
+  std::vector<PerfCounters::Snapshot> perf(loops.size());
+  for (size_t i = 0; i < loops.size(); ++i)
+    if (PerfCounters* p = loops[i]->perfCounters()) perf[i] = p->snapshot();
+  appendType(page, "jmuduo_loop_cpu_seconds_total", "counter");
+  for (size_t i = 0; i < loops.size(); ++i) {
+    if (perf[i].samples == 0) continue;
+    std::string l = loopLabels[i] + ",";
+    appendSample(page, "jmuduo_loop_cpu_seconds_total", l + label("mode", "user"),
+                 perf[i].userNanos / 1e9);
+    appendSample(page, "jmuduo_loop_cpu_seconds_total", l + label("mode", "system"),
+                 perf[i].systemNanos / 1e9);
+  }
+  appendType(page, "jmuduo_loop_perf_events_total", "counter");
+  for (size_t i = 0; i < loops.size(); ++i) {
+    if (perf[i].samples == 0) continue;
+    for (int k = 0; k < PerfCounters::kNumCounters; ++k) {
+      if (!perf[i].available[k]) continue;
+      appendSample(page, "jmuduo_loop_perf_events_total",
+                   loopLabels[i] + "," +
+                       label("event", PerfCounters::counterName(
+                                          static_cast<PerfCounters::Counter>(k))),
+                   static_cast<double>(perf[i].values[k]));
+    }
+  }
+
+  appendType(page, "jmuduo_server_connections", "gauge");
+  for (size_t i = 0; i < servers_.size(); ++i)
+    appendSample(page, "jmuduo_server_connections",
+                 label("server", servers_[i]->name()),
+                 static_cast<double>(c.connections[i]));
+  appendType(page, "jmuduo_server_buffer_bytes", "gauge");
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    std::string l = label("server", servers_[i]->name()) + ",";
+    appendSample(page, "jmuduo_server_buffer_bytes", l + label("buffer", "input"),
+                 static_cast<double>(c.buffers[i].input));
+    appendSample(page, "jmuduo_server_buffer_bytes", l + label("buffer", "output"),
+                 static_cast<double>(c.buffers[i].output));
+  }
+  appendType(page, "jmuduo_server_output_pending_bytes", "gauge");
+  for (size_t i = 0; i < servers_.size(); ++i)
+    appendSample(page, "jmuduo_server_output_pending_bytes",
+                 label("server", servers_[i]->name()),
+                 static_cast<double>(c.buffers[i].pending));
+
+  appendType(page, "jmuduo_connections_active", "gauge");
+  for (auto& stats : stats_)
+    appendSample(page, "jmuduo_connections_active", label("class", stats->name()),
+                 static_cast<double>(stats->active()));
+  appendType(page, "jmuduo_connections_total", "counter");
+  for (auto& stats : stats_)
+    appendSample(page, "jmuduo_connections_total", label("class", stats->name()),
+                 static_cast<double>(stats->total()));
+  appendType(page, "jmuduo_read_bytes_total", "counter");
+  for (auto& stats : stats_)
+    appendSample(page, "jmuduo_read_bytes_total", label("class", stats->name()),
+                 static_cast<double>(stats->bytesRead()));
+  appendType(page, "jmuduo_written_bytes_total", "counter");
+  for (auto& stats : stats_)
+    appendSample(page, "jmuduo_written_bytes_total", label("class", stats->name()),
+                 static_cast<double>(stats->bytesWritten()));
+
+  appendType(page, "jmuduo_log_suppressed_total", "counter");
+  appendSample(page, "jmuduo_log_suppressed_total", "",
+               static_cast<double>(Logger::suppressedCount()));
+}
+
+void StatsServer::onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    conn->setContext(HttpContext());
+  }
+}
+
+/**
+ * 每个连接只处理一个请求，响应之后关闭连接。收集是异步的，等待期间停止读取
+ */
+void StatsServer::onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                            Timestamp receiveTime) {
+  HttpContext* context = std::any_cast<HttpContext>(conn->getMutableContext());
+  if (!context->parseRequest(buf, receiveTime)) {
+    static const char kBadRequest[] =
+        "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n"
+        "Connection: close\r\n\r\n";
+    conn->send(kBadRequest, sizeof kBadRequest - 1);
+    conn->shutdown();
+    return;
+  }
+  if (!context->gotAll()) return;
+  conn->stopRead();
+  buf->retrieveAll();
+
+  const std::string& path = context->request().path();
+  if (path == "/trace") {
+    // 跟踪记录由应用调用 Tracer::start 开启，这里只导出，见 Tracer.h
+    HttpResponse response(true);
+    response.setStatusCode(HttpResponse::k200Ok);
+    response.setStatusMessage("OK");
+    response.setContentType("application/json");
+    response.setBody(Tracer::dumpJson());
+    Buffer output;
+    response.appendToBuffer(&output);
+    conn->send(&output);
+    conn->shutdown();
+    return;
+  }
+  if (path != "/metrics" && path != "/") {
+    HttpResponse response(true);
+    response.setStatusCode(HttpResponse::k404NotFound);
+    response.setStatusMessage("Not Found");
+    Buffer output;
+    response.appendToBuffer(&output);
+    conn->send(&output);
+    conn->shutdown();
+    return;
+  }
+  collect([conn](const std::string& page) {
+    HttpResponse response(true);
+    response.setStatusCode(HttpResponse::k200Ok);
+    response.setStatusMessage("OK");
+    response.setContentType("text/plain; version=0.0.4");
+    response.setBody(page);
+    Buffer output;
+    response.appendToBuffer(&output);
+    conn->send(&output);
+    conn->shutdown();
+  });
+}
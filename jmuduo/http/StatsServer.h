@@ -0,0 +1,79 @@
+#ifndef _JMUDUO_STATS_SERVER_H_
+#define _JMUDUO_STATS_SERVER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../reactor/ConnectionStats.h"
+#include "../reactor/TcpServer.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Buffer;
+class EventLoop;
+
+/**
+ * 统计页面服务，在单独的端口上以 Prometheus 文本格式输出（GET /metrics）：
+ * 1. 每个事件循环：定时器个数，以及 EventLoopMetrics 的轮数、忙碌/等待时间和各部分耗时的分位数，
+ *    开启了 PerfCounters 时还有用户态/内核态 CPU 时间和各个性能计数器
+ * 2. 每个 TcpServer：连接数、输入/输出缓冲区占用的内存、输出缓冲区中待发送的数据量
+ * 3. 每个连接类别（ConnectionStats）：当前/累计连接数、读写的字节数
+ * 4. 被采样/限流丢弃的日志条数
+ * GET /trace 以 Chrome trace 的 JSON 格式导出 Tracer 的记录
+ *
+ * 收集数据不加锁，也不会阻塞被统计的事件循环：
+ * - 计数器类的数据（连接类别、EventLoopMetrics、日志）本身是原子变量，直接读取
+ * - 只能在 IO 线程中访问的数据（连接列表、缓冲区、定时器）通过 EventLoop::call 交给各个
+ *   IO 线程计算，结果用 Future::then 异步地交回 StatsServer 所在的事件循环，全部返回后再生成页面
+ * StatsServer 最好使用单独的事件循环（如 EventLoopThread），也可以和被统计的服务共用
+ *
+ *   StatsServer stats(statsLoop, InetAddress(9100));
+ *   stats.addServer(&server);
+ *   stats.start();
+ */
+class StatsServer : noncopyable {
+ public:
+  using CollectCallback = std::function<void(const std::string& page)>;
+
+  StatsServer(EventLoop* loop, const InetAddress& listenAddr);
+
+  /**
+   * 以下注册函数只能在 start 之前或者在 loop 所在线程中调用
+   */
+  // 统计 server 的连接、类别和它使用的所有事件循环（server 所在的和 IO 线程池的），
+  // 并开启这些事件循环的 EventLoopMetrics（IO 线程池在 server 启动后才存在，
+  // 所以也会在每次收集时检查开启）
+  void addServer(TcpServer* server);
+  // 统计其他的事件循环（如 TcpClient 使用的）
+  void addLoop(EventLoop* loop);
+  // 统计用户定义的连接类别
+  void addConnectionStats(const ConnectionStatsPtr& stats);
+
+  void start();
+
+  // 异步地收集统计数据，完成后在 loop 中调用 cb(page)，只能在 loop 所在线程中调用
+  void collect(const CollectCallback& cb);
+
+ private:
+  struct Collection;
+
+  void onConnection(const TcpConnectionPtr& conn);
+  void onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                 Timestamp receiveTime);
+  // 一个 call 的结果处理完毕，全部完成时生成页面
+  void finish(const std::shared_ptr<Collection>& c);
+  void render(const Collection& c, std::string* page) const;
+
+  EventLoop* loop_;
+  TcpServer server_;
+  std::vector<TcpServer*> servers_;
+  std::vector<EventLoop*> loops_;
+  std::vector<ConnectionStatsPtr> stats_;
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -1,21 +1,44 @@
 #include "Acceptor.h"
 
+#include <unistd.h>
+
 #include "EventLoop.h"
-#include "InetAddress.h"
 #include "SocketsOps.h"
 
 using namespace jmuduo;
 
-Acceptor::Acceptor(EventLoop* loop, const InetAddress& listenAddr)
+namespace {
+
+// 文件系统中的 Unix 域 socket 地址在 bind 时创建 socket 文件，
+// 进程退出后文件不会自动删除，再次 bind 同一路径会失败（EADDRINUSE）
+bool isUnixPath(const SockAddr& addr) {
+  return addr.isUnix() && !addr.isAbstract() && !addr.unixName().empty();
+}
+
+}  // namespace
+
+Acceptor::Acceptor(EventLoop* loop, const SockAddr& listenAddr)
     : loop_(loop),
-      acceptorSocket_(sockets::createNonblockingOrDie()),
+      listenAddr_(listenAddr),
+      acceptorSocket_(sockets::createNonblockingOrDie(listenAddr.family())),
       acceptorChannel_(loop, acceptorSocket_.fd()),
       listenning_(false) {
-  acceptorSocket_.setReuseAddr(true);
+  if (isUnixPath(listenAddr)) {
+    ::unlink(listenAddr.unixName().c_str());
+  } else {
+    acceptorSocket_.setReuseAddr(true);
+  }
   acceptorSocket_.bindAddress(listenAddr);
+  acceptorChannel_.setKind(Channel::kAcceptor);
   acceptorChannel_.setReadCallback(std::bind(&Acceptor::handleRead, this));
 }
 
+Acceptor::~Acceptor() {
+  if (isUnixPath(listenAddr_)) {
+    ::unlink(listenAddr_.unixName().c_str());
+  }
+}
+
 void Acceptor::listen() {
   loop_->assertInLoopThread();
   listenning_ = true;
@@ -26,7 +49,7 @@ void Acceptor::listen() {
 
 void Acceptor::handleRead() {
   loop_->assertInLoopThread();
-  InetAddress peerAddr(0);
+  SockAddr peerAddr(0);
   // FIXME loop until no more
   int connfd = acceptorSocket_.accept(&peerAddr);  // 接受新的连接
   if (connfd >= 0) {
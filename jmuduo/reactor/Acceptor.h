@@ -4,22 +4,25 @@
 #include <functional>
 
 #include "Channel.h"
+#include "SockAddr.h"
 #include "Socket.h"
 #include "noncopyable.h"
 
 namespace jmuduo {
 
 class EventLoop;
-class InetAddress;
 
 // 内部对象，TcpServer 使用其来接受新的 socket 连接
+// 监听地址可以是 IPv4、IPv6 或 Unix 域地址。文件系统中的 Unix 域地址在 bind 之前
+// 会删除遗留的同名文件，Acceptor 析构时删除 bind 创建的文件
 class Acceptor : noncopyable {
  public:
-  // sockfd 新连接套接字，listenAddr 新连接地址
+  // sockfd 新连接套接字，peerAddr 新连接的远端地址
   using NewConnectionCallback =
-      std::function<void(int sockfd, const InetAddress& listenAddr)>;
+      std::function<void(int sockfd, const SockAddr& peerAddr)>;
 
-  Acceptor(EventLoop* loop, const InetAddress& listenAddr);
+  Acceptor(EventLoop* loop, const SockAddr& listenAddr);
+  ~Acceptor();
 
   void setNewConnectionCallback(const NewConnectionCallback& cb) {
     newConnectionCallback_ = cb;
@@ -34,6 +37,7 @@ class Acceptor : noncopyable {
   void handleRead();
 
   EventLoop* loop_; // 连接器所属的事件循环
+  const SockAddr listenAddr_; // 监听地址
   Socket acceptorSocket_; // 监听 socket
   Channel acceptorChannel_; // 监听 socket 使用的事件循环信道
   NewConnectionCallback newConnectionCallback_; // 当有新连接到来时的用户回调
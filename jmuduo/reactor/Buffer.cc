@@ -1,9 +1,106 @@
 #include "Buffer.h"
 
+#include <string.h>
 #include <sys/uio.h>
 
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 using namespace jmuduo;
 
+/**
+ * 分隔符的查找。文本协议的一行通常很短，但一次 read 可能读到很多行，也可能读到很长的
+ * 消息体，所以查找需要对短数据开销小、对长数据吞吐高：
+ * 1. findByte 等价于 memchr，直接使用 glibc 的 memchr，其本身已经按 CPU 选择了向量化实现
+ * 2. findCRLF 是两个字节的模式，memmem 对此并不快，这里用 SIMD 一次比较 16/32 个位置：
+ *    把 [p, p+N) 和 [p+1, p+N+1) 分别与 '\r' 和 '\n' 比较，两个结果按位与后
+ *    非零的位就是 "\r\n" 的位置
+ * 3. 运行时检测 CPU，支持 AVX2 时使用 32 字节的向量，否则使用 x86-64 都支持的 SSE2，
+ *    其他平台使用标量实现
+ */
+namespace {
+
+// 标量实现，先用 memchr 找 '\r' 再检查下一个字节
+const char* findCRLFScalar(const char* p, const char* end) {
+  while (end - p >= 2) {
+    const char* cr = static_cast<const char*>(::memchr(p, '\r', end - p - 1));
+    if (cr == nullptr) return nullptr;
+    if (cr[1] == '\n') return cr;
+    p = cr + 1;
+  }
+  return nullptr;
+}
+
+#if defined(__x86_64__)
+
+const char* findCRLFSse2(const char* p, const char* end) {
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  // 每次比较 16 个位置，需要读取 17 个字节
+  while (end - p > 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+    int mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, cr), _mm_cmpeq_epi8(b, lf)));
+    if (mask != 0) return p + __builtin_ctz(mask);
+    p += 16;
+  }
+  return findCRLFScalar(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findCRLFAvx2(const char* p, const char* end) {
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  // 每次比较 64 个位置，两个向量的结果合并后判断，减少分支
+  while (end - p > 64) {
+    const __m256i* v = reinterpret_cast<const __m256i*>(p);
+    const __m256i* w = reinterpret_cast<const __m256i*>(p + 1);
+    __m256i m0 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(v), cr),
+                                  _mm256_cmpeq_epi8(_mm256_loadu_si256(w), lf));
+    __m256i m1 =
+        _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(v + 1), cr),
+                         _mm256_cmpeq_epi8(_mm256_loadu_si256(w + 1), lf));
+    if (!_mm256_testz_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m0, m1))) {
+      uint32_t mask0 = _mm256_movemask_epi8(m0);
+      if (mask0 != 0) return p + __builtin_ctz(mask0);
+      return p + 32 + __builtin_ctz(_mm256_movemask_epi8(m1));
+    }
+    p += 64;
+  }
+  return findCRLFSse2(p, end);
+}
+
+#endif
+
+using FindCRLF = const char* (*)(const char*, const char*);
+
+FindCRLF chooseFindCRLF() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return findCRLFAvx2;
+  return findCRLFSse2;
+#else
+  return findCRLFScalar;
+#endif
+}
+
+}  // namespace
+
+const char* jmuduo::detail::findCRLF(const char* begin, const char* end) {
+  // 局部静态变量，保证在其他编译单元的静态初始化中调用也是安全的
+  static const FindCRLF impl = chooseFindCRLF();
+  return impl(begin, end);
+}
+
+const char* jmuduo::detail::findByte(const char* begin, const char* end,
+                                     char c) {
+  return static_cast<const char*>(::memchr(begin, c, end - begin));
+}
+
 
 /**
  * P208 P315
@@ -18,24 +115,24 @@ using namespace jmuduo;
  *    这么做是高效的，因为每次读数据只需一次 read，而 edge trigger 每次最少两次 read。
  *    再次，这样做照顾了多个连接的公平性，不会因为每个连接上数据量过大而影响其他连接处理消息。
  */
-ssize_t Buffer::readFd(int fd, int* savedErrno) {
+ssize_t Buffer::readFd(int fd, int* savedErrno, size_t maxBytes) {
   // 在栈上开一个临时缓冲区，确保缓冲区足够大，一次 readv 能够读完所有数据
   char extrabuf[65536];
   struct iovec vec[2];  // scatter/gather I/O
-  const size_t writable = writableBytes();
+  const size_t writable = std::min(writableBytes(), maxBytes);
   // 先使用 buffer_
   vec[0].iov_base = begin() + writerIndex_;
   vec[0].iov_len = writable;
   // 写满 buffer_ 后再使用 extrabuf
   vec[1].iov_base = extrabuf;
-  vec[1].iov_len = sizeof extrabuf;
-  ssize_t n = readv(fd, vec, 2); 
+  vec[1].iov_len = std::min(sizeof extrabuf, maxBytes - writable);
+  ssize_t n = readv(fd, vec, vec[1].iov_len > 0 ? 2 : 1);
   if (n < 0) { // 读取失败
     *savedErrno = errno;
   } else if (static_cast<size_t>(n) <= writable) { // 只使用了 buffer_
     writerIndex_ += n;
   } else { // buffer_ 写满了，使用了 extrabuf
-    writerIndex_ += buffer_.size();
+    writerIndex_ = buffer_.size();
     append(extrabuf, n - writable); // 将 extrabuf 中的数据添加到缓冲区
   }
   // TODO 缓冲区还是有可能不够大，如果 n==writable+sizeof extrabuf，就再读一次
@@ -2,6 +2,9 @@
 #define _JMUDUO_BUFFER_H_
 
 #include <assert.h>
+#include <endian.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <string>
 #include <vector>
@@ -10,6 +13,13 @@
 
 namespace jmuduo {
 
+namespace detail {
+// 在 [begin, end) 中查找，返回第一个匹配的位置，找不到时返回 nullptr。
+// 定义在 Buffer.cc 中，运行时根据 CPU 选择 AVX2/SSE2/标量实现
+const char* findCRLF(const char* begin, const char* end);
+const char* findByte(const char* begin, const char* end, char c);
+}  // namespace detail
+
 /**
  * 可变长度的缓冲区，用于非阻塞 IO 的读写缓冲
  * 可读区域的前部总是保留了一小段可写区域，方便在可读区域的前方写入，
@@ -41,7 +51,7 @@ class Buffer : copyable {
   void swap(Buffer& rhs) {
     buffer_.swap(rhs.buffer_);
     std::swap(readerIndex_, rhs.readerIndex_);
-    std::swap(writerIndex_, writerIndex_);
+    std::swap(writerIndex_, rhs.writerIndex_);
   }
 
   size_t readableBytes() const { return writerIndex_ - readerIndex_; }
@@ -50,6 +60,9 @@ class Buffer : copyable {
 
   size_t prependableBytes() const { return readerIndex_; }
 
+  // 缓冲区占用的内存
+  size_t internalCapacity() const { return buffer_.capacity(); }
+
   /* 读取操作 */
 
   // 返回可读区域的起始地址
@@ -60,7 +73,11 @@ class Buffer : copyable {
   // 表达式中两个函数的执行顺序是不确定的
   void retrieve(size_t len) {
     assert(len <= readableBytes());
-    readerIndex_ += len;
+    if (len < readableBytes()) {
+      readerIndex_ += len;
+    } else {  // 全部读完时两个索引复位，腾出前部可写区域
+      retrieveAll();
+    }
   }
 
   // 读取 [peek(), end) 范围内的内容
@@ -70,6 +87,12 @@ class Buffer : copyable {
     retrieve(end - peek());
   }
 
+  // 读取网络字节序的整数，可读区域的长度必须足够
+  void retrieveInt64() { retrieve(sizeof(int64_t)); }
+  void retrieveInt32() { retrieve(sizeof(int32_t)); }
+  void retrieveInt16() { retrieve(sizeof(int16_t)); }
+  void retrieveInt8() { retrieve(sizeof(int8_t)); }
+
   // 读取所有字符，两个索引复位
   void retrieveAll() {
     readerIndex_ = kCheapPrepend;
@@ -83,6 +106,56 @@ class Buffer : copyable {
     return str;
   }
 
+  /**
+   * 以网络字节序（大端）读写整数，用于消息的长度头、类型等定长字段。
+   * 数据在缓冲区中不一定对齐，所以用 memcpy 读写
+   */
+  // 返回可读区域开头的整数，不移动可读索引
+  int64_t peekInt64() const {
+    assert(readableBytes() >= sizeof(int64_t));
+    int64_t be64 = 0;
+    ::memcpy(&be64, peek(), sizeof be64);
+    return be64toh(be64);
+  }
+  int32_t peekInt32() const {
+    assert(readableBytes() >= sizeof(int32_t));
+    int32_t be32 = 0;
+    ::memcpy(&be32, peek(), sizeof be32);
+    return be32toh(be32);
+  }
+  int16_t peekInt16() const {
+    assert(readableBytes() >= sizeof(int16_t));
+    int16_t be16 = 0;
+    ::memcpy(&be16, peek(), sizeof be16);
+    return be16toh(be16);
+  }
+  int8_t peekInt8() const {
+    assert(readableBytes() >= sizeof(int8_t));
+    return *peek();
+  }
+
+  // 读取并返回可读区域开头的整数
+  int64_t readInt64() {
+    int64_t result = peekInt64();
+    retrieveInt64();
+    return result;
+  }
+  int32_t readInt32() {
+    int32_t result = peekInt32();
+    retrieveInt32();
+    return result;
+  }
+  int16_t readInt16() {
+    int16_t result = peekInt16();
+    retrieveInt16();
+    return result;
+  }
+  int8_t readInt8() {
+    int8_t result = peekInt8();
+    retrieveInt8();
+    return result;
+  }
+
   /* 写入操作 */
 
   // 写入一个字符串
@@ -98,6 +171,21 @@ class Buffer : copyable {
   void append(const void* /*restrict*/ data, size_t len) {
     append(static_cast<const char*>(data), len);
   }
+  // 写入网络字节序的整数
+  void appendInt64(int64_t x) {
+    int64_t be64 = htobe64(x);
+    append(&be64, sizeof be64);
+  }
+  void appendInt32(int32_t x) {
+    int32_t be32 = htobe32(x);
+    append(&be32, sizeof be32);
+  }
+  void appendInt16(int16_t x) {
+    int16_t be16 = htobe16(x);
+    append(&be16, sizeof be16);
+  }
+  void appendInt8(int8_t x) { append(&x, sizeof x); }
+
   // 确保可写区域足够大
   void ensureWritableBytes(size_t len) {
     if (writableBytes() < len) {  // 可写区域太小，需要扩容
@@ -119,19 +207,58 @@ class Buffer : copyable {
     const char* d = static_cast<const char*>(data);
     std::copy(d, d + len, begin() + readerIndex_);
   }
+  // 在可读区域前写入网络字节序的整数，如消息的长度头，避免先写长度头再拷贝消息体
+  void prependInt64(int64_t x) {
+    int64_t be64 = htobe64(x);
+    prepend(&be64, sizeof be64);
+  }
+  void prependInt32(int32_t x) {
+    int32_t be32 = htobe32(x);
+    prepend(&be32, sizeof be32);
+  }
+  void prependInt16(int16_t x) {
+    int16_t be16 = htobe16(x);
+    prepend(&be16, sizeof be16);
+  }
+  void prependInt8(int8_t x) { prepend(&x, sizeof x); }
+
   // 手动收缩缓冲区的大小，为了避免频繁分配内存，vector 缓冲区只会自动扩容，不会自动收缩
   // 收缩后的缓冲区大小为 prependableBytes + readableBytes + reserve
   void shrink(size_t reserve) {
     std::vector<char> buf(kCheapPrepend + readableBytes() + reserve);
-    std::copy(peek(), peek() + readableBytes(), buf.begin() + kCheapPrepend);
-    buf.swap(buf);
+    size_t readable = readableBytes();
+    std::copy(peek(), peek() + readable, buf.begin() + kCheapPrepend);
+    buffer_.swap(buf);
+    readerIndex_ = kCheapPrepend;
+    writerIndex_ = readerIndex_ + readable;
+  }
+
+  /**
+   * 查找操作，用于文本协议的分行。offset 为开始查找的位置相对 peek() 的偏移，
+   * 数据不完整时，调用者记录已经查找过的长度，下次收到数据后从那里继续，
+   * 避免每次 handleRead 都从头查找一遍。偏移在缓冲区扩容或移动数据后仍然有效，
+   * 但在 retrieve 之后失效
+   * 找到时返回指向匹配位置的指针，找不到时返回 nullptr
+   */
+  // 查找 "\r\n"，返回指向 '\r' 的指针。
+  // 找不到时 '\r' 可能是最后一个字节，应该从 readableBytes() - 1 继续查找
+  const char* findCRLF(size_t offset = 0) const {
+    assert(offset <= readableBytes());
+    return detail::findCRLF(peek() + offset, beginWrite());
+  }
+  // 查找 '\n'
+  const char* findEOL(size_t offset = 0) const { return findByte('\n', offset); }
+  // 查找字节 c
+  const char* findByte(char c, size_t offset = 0) const {
+    assert(offset <= readableBytes());
+    return detail::findByte(peek() + offset, beginWrite(), c);
   }
 
   /**
-   * @brief 读取 fd 上的数据到缓冲区中
+   * @brief 读取 fd 上的数据到缓冲区中，最多读取 maxBytes 个字节
    * @return 成功时返回读取的字节数，失败时返回负数，并在 savedErrno 中保存错误原因
    */
-  ssize_t readFd(int fd, int* savedErrno);
+  ssize_t readFd(int fd, int* savedErrno, size_t maxBytes = SIZE_MAX);
 
 
  private:
@@ -15,6 +15,7 @@ const int Channel::kWriteEvent = POLLOUT;
 Channel::Channel(EventLoop *loop, int fd)
     : loop_(loop),
       fd_(fd),
+      kind_(kOther),
       events_(0),
       revents_(0),
       index_(-1),
@@ -25,6 +26,12 @@ Channel::~Channel() {
   assert(!eventHandling_);
 }
 
+const char* Channel::kindName(Kind kind) {
+  static const char* const kNames[kNumKinds] = {
+      "other", "wakeup", "timer", "acceptor", "connector", "connection", "udp"};
+  return kind >= 0 && kind < kNumKinds ? kNames[kind] : "unknown";
+}
+
 void Channel::update() {
   loop_->updateChannel(this);
 }
@@ -22,6 +22,19 @@ class Channel : noncopyable {
   // 定义可读事件事件回调函数的类型
   using ReadEventCallback = std::function<void(Timestamp)>;
 
+  // 信道的用途，事件循环的统计数据（见 EventLoopMetrics）按用途分别记录回调的耗时
+  enum Kind {
+    kOther,
+    kWakeup,      // EventLoop 的 eventfd
+    kTimer,       // TimerQueue 的 timerfd
+    kAcceptor,    // 监听 socket
+    kConnector,   // 正在发起连接的 socket
+    kConnection,  // TcpConnection
+    kUdp,         // UdpSocket
+    kNumKinds,
+  };
+  static const char* kindName(Kind kind);
+
   Channel(EventLoop*, int fd);
   ~Channel();
 
@@ -38,6 +51,8 @@ class Channel : noncopyable {
   void setCloseCallback(const EventCallback& cb) { closeCallback_ = cb; };
 
   int fd() const { return fd_; }
+  Kind kind() const { return kind_; }
+  void setKind(Kind kind) { kind_ = kind; }
   int events() const { return events_; }
   void set_revents(int revents) { revents_ = revents; }
   // 判断信道是否不监听任何事件
@@ -48,6 +63,10 @@ class Channel : noncopyable {
     events_ |= kReadEvent;
     update();
   }
+  void disableReading() {
+    events_ &= ~kReadEvent;
+    update();
+  }
   void enableWriting() {
     events_ |= kWriteEvent;
     update();
@@ -60,6 +79,7 @@ class Channel : noncopyable {
     events_ = kNoneEvent;
     update();
   }
+  bool isReading() const { return events_ & kReadEvent; }
   // 是否监听了可写事件，
   // 由于 muduo 采用 level trigger，只有在有数据需要写入时才监听可写事件
   bool isWriting() const {
@@ -82,6 +102,7 @@ class Channel : noncopyable {
 
   EventLoop* loop_; // 每个 Channel 对象都属于某个线程的 EventLoop
   const int fd_; // 每个 Channel 负责一个 fd 的事件分发，注意该对象不拥有文件描述符
+  Kind kind_;
   int events_; // 监听的事件
   int revents_; // 一次事件循环中返回的事件
   int index_;  // 对象实例在其属于的 poller 的 pollfds_ 中的索引
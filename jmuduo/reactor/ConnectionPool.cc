@@ -0,0 +1,199 @@
+#include "ConnectionPool.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "../base/logging/Logging.h"
+#include "Buffer.h"
+#include "EventLoop.h"
+#include "TcpClient.h"
+#include "TcpConnection.h"
+
+using namespace jmuduo;
+
+namespace {
+
+// 默认编码：请求原样发送，调用者负责加上结尾的 '\n'
+void defaultEncode(uint64_t, std::string_view request, Buffer* buf) {
+  buf->append(request.data(), request.size());
+}
+
+// 默认解码：一行文本（包括 '\n'）为一个响应
+bool defaultDecode(Buffer* buf, uint64_t*, std::string* response) {
+  const char* eol = static_cast<const char*>(
+      memchr(buf->peek(), '\n', buf->readableBytes()));
+  if (eol == nullptr) return false;
+  response->assign(buf->peek(), eol + 1);
+  buf->retrieveUntil(eol + 1);
+  return true;
+}
+
+}  // namespace
+
+// 一条连接和它的未完成请求
+struct ConnectionPool::Slot {
+  struct Pending {
+    uint64_t id;
+    ResponseCallback callback;
+  };
+
+  std::unique_ptr<TcpClient> client;
+  TcpConnectionPtr conn;          // 已建立的连接，断开时为空
+  std::deque<Pending> ordered;    // 有序模式下的未完成请求，按发送顺序
+  std::unordered_map<uint64_t, ResponseCallback> byId;  // 关联编号模式下的未完成请求
+  Buffer output;                  // 编码请求使用的缓冲区
+
+  size_t pending() const { return ordered.size() + byId.size(); }
+};
+
+ConnectionPool::ConnectionPool(EventLoop* loop, const InetAddress& upstream,
+                               const std::string& name, int numConnections)
+    : loop_(loop),
+      name_(name),
+      encoder_(defaultEncode),
+      decoder_(defaultDecode),
+      ordered_(true),
+      maxPending_(SIZE_MAX),
+      nextId_(1),
+      nextSlot_(0) {
+  assert(numConnections > 0);
+  for (int i = 0; i < numConnections; ++i) {
+    auto slot = std::make_unique<Slot>();
+    slot->client.reset(
+        new TcpClient(loop, upstream, name_ + "#" + std::to_string(i)));
+    slot->client->enableRetry();
+    Slot* s = slot.get();
+    slot->client->setConnectionCallback(
+        [this, s](const TcpConnectionPtr& conn) { onConnection(s, conn); });
+    slot->client->setMessageCallback(
+        [this, s](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          onMessage(s, conn, buf);
+        });
+    slots_.push_back(std::move(slot));
+  }
+}
+
+ConnectionPool::~ConnectionPool() {
+  for (auto& slot : slots_) {
+    // 连接可能比连接池活得久（见 TcpClient::~TcpClient），不能再回调连接池
+    if (slot->conn) {
+      slot->conn->setConnectionCallback(ConnectionCallback());
+      slot->conn->setMessageCallback(MessageCallback());
+    }
+    failPending(slot.get());
+  }
+}
+
+void ConnectionPool::setCodec(const Encoder& encoder, const Decoder& decoder,
+                              bool ordered) {
+  encoder_ = encoder;
+  decoder_ = decoder;
+  ordered_ = ordered;
+}
+
+void ConnectionPool::start() {
+  for (auto& slot : slots_) slot->client->connect();
+}
+
+void ConnectionPool::stop() {
+  loop_->assertInLoopThread();
+  for (auto& slot : slots_) {
+    slot->client->stop();
+    slot->client->disconnect();
+    failPending(slot.get());
+  }
+}
+
+bool ConnectionPool::call(std::string_view request, ResponseCallback cb) {
+  loop_->assertInLoopThread();
+  Slot* slot = pickSlot();
+  if (slot == nullptr) return false;
+
+  uint64_t id = nextId_++;
+  encoder_(id, request, &slot->output);
+  if (ordered_)
+    slot->ordered.push_back({id, std::move(cb)});
+  else
+    slot->byId.emplace(id, std::move(cb));
+  // 在 loop_ 中直接发送，不经过 queueInLoop
+  slot->conn->send(&slot->output);
+  return true;
+}
+
+int ConnectionPool::numConnected() const {
+  int n = 0;
+  for (auto& slot : slots_)
+    if (slot->conn) ++n;
+  return n;
+}
+
+size_t ConnectionPool::outstanding() const {
+  size_t n = 0;
+  for (auto& slot : slots_) n += slot->pending();
+  return n;
+}
+
+ConnectionPool::Slot* ConnectionPool::pickSlot() {
+  // 连接数很少（通常不超过几十），线性查找即可
+  Slot* best = nullptr;
+  const size_t n = slots_.size();
+  for (size_t i = 0; i < n; ++i) {
+    Slot* slot = slots_[(nextSlot_ + i) % n].get();
+    if (slot->conn && slot->pending() < maxPending_ &&
+        (best == nullptr || slot->pending() < best->pending())) {
+      best = slot;
+    }
+  }
+  nextSlot_ = (nextSlot_ + 1) % n;
+  return best;
+}
+
+void ConnectionPool::onConnection(Slot* slot, const TcpConnectionPtr& conn) {
+  loop_->assertInLoopThread();
+  if (conn->connected()) {
+    conn->setTcpNoDelay(true);
+    slot->conn = conn;
+  } else {
+    slot->conn.reset();
+    failPending(slot);
+  }
+}
+
+void ConnectionPool::onMessage(Slot* slot, const TcpConnectionPtr& conn,
+                               Buffer* buf) {
+  uint64_t id = 0;
+  std::string response;
+  while (decoder_(buf, &id, &response)) {
+    ResponseCallback cb;
+    if (ordered_) {
+      if (slot->ordered.empty()) {
+        LOG_ERROR << "ConnectionPool::onMessage [" << conn->getName()
+                  << "] - unexpected response";
+        conn->shutdown();
+        return;
+      }
+      cb = std::move(slot->ordered.front().callback);
+      slot->ordered.pop_front();
+    } else {
+      auto it = slot->byId.find(id);
+      if (it == slot->byId.end()) {
+        LOG_ERROR << "ConnectionPool::onMessage [" << conn->getName()
+                  << "] - unknown correlation id " << id;
+        continue;
+      }
+      cb = std::move(it->second);
+      slot->byId.erase(it);
+    }
+    cb(&response);
+  }
+}
+
+void ConnectionPool::failPending(Slot* slot) {
+  // 先取出再回调，回调中可能再次调用 call
+  std::deque<Slot::Pending> ordered;
+  std::unordered_map<uint64_t, ResponseCallback> byId;
+  ordered.swap(slot->ordered);
+  byId.swap(slot->byId);
+  for (auto& p : ordered) p.callback(nullptr);
+  for (auto& p : byId) p.second(nullptr);
+}
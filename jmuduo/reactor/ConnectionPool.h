@@ -0,0 +1,110 @@
+#ifndef _JMUDUO_CONNECTION_POOL_H_
+#define _JMUDUO_CONNECTION_POOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Callbacks.h"
+#include "InetAddress.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Buffer;
+class EventLoop;
+class TcpClient;
+
+/**
+ * 客户端连接池，每个 EventLoop 对一个上游服务保持 numConnections 条长连接
+ * 1. 每条连接同时可以有多个未完成的请求（pipelining），不必等上一个响应返回
+ * 2. 新请求发往未完成请求数最少的连接
+ * 3. 连接断开时，该连接上未完成的请求以失败结束，连接由 TcpClient 自动重连
+ * 连接池只属于一个事件循环，所有操作都在 loop_ 中进行，不需要加锁。
+ * 多个 IO 线程访问同一个上游时，每个线程创建自己的连接池
+ *
+ * 请求和响应的对应关系：
+ * 1. 有序（默认）：上游按请求的顺序返回响应，响应对应连接上最早的未完成请求
+ * 2. 关联编号：连接池为每个请求分配一个编号，由 Encoder 写入请求，Decoder 从响应中取出，
+ *    上游可以乱序返回响应
+ * 默认的编解码为以 '\n' 结尾的文本行
+ *
+ * 用法：
+ *   ConnectionPool pool(loop, upstreamAddr, "upstream", 4);
+ *   pool.start();
+ *   pool.call("GET key\n", [](const std::string* response) {
+ *     if (response) ...;  // nullptr 表示请求失败
+ *   });
+ */
+class ConnectionPool : noncopyable {
+ public:
+  // 请求完成时的回调，请求失败（连接断开）时参数为 nullptr
+  using ResponseCallback = std::function<void(const std::string* response)>;
+  // 把请求编码到 buf 中，id 为连接池分配的关联编号
+  using Encoder =
+      std::function<void(uint64_t id, std::string_view request, Buffer* buf)>;
+  // 从 buf 中取出一个完整的响应和它的关联编号，数据不完整时返回 false
+  using Decoder =
+      std::function<bool(Buffer* buf, uint64_t* id, std::string* response)>;
+
+  ConnectionPool(EventLoop* loop, const InetAddress& upstream,
+                 const std::string& name, int numConnections);
+  ~ConnectionPool();
+
+  /**
+   * @brief 设置编解码，应该在 start 之前调用
+   * @param ordered 为 true 时按顺序对应请求和响应，忽略 Decoder 取出的关联编号
+   */
+  void setCodec(const Encoder& encoder, const Decoder& decoder, bool ordered);
+  // 每条连接最多的未完成请求数，默认不限制
+  void setMaxPendingPerConnection(size_t n) { maxPending_ = n; }
+
+  // 建立所有连接，之后连接断开时会自动重连
+  void start();
+  // 断开所有连接，未完成的请求以失败结束
+  void stop();
+
+  /**
+   * @brief 发送请求，只能在 loop_ 中调用
+   * @return 没有可用的连接（都未建立或未完成的请求数都已达到上限）时返回 false，
+   * 此时不会调用 cb
+   */
+  bool call(std::string_view request, ResponseCallback cb);
+
+  EventLoop* getLoop() const { return loop_; }
+  const std::string& name() const { return name_; }
+  // 已建立的连接数
+  int numConnected() const;
+  // 所有连接上未完成的请求总数
+  size_t outstanding() const;
+
+ private:
+  struct Slot;
+
+  void onConnection(Slot* slot, const TcpConnectionPtr& conn);
+  void onMessage(Slot* slot, const TcpConnectionPtr& conn, Buffer* buf);
+  // 连接断开时，以失败结束该连接上所有未完成的请求
+  void failPending(Slot* slot);
+  // 选出未完成请求数最少的已建立连接，没有可用的连接时返回 nullptr
+  Slot* pickSlot();
+
+  EventLoop* loop_;
+  const std::string name_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  Encoder encoder_;
+  Decoder decoder_;
+  bool ordered_;
+  size_t maxPending_;
+  uint64_t nextId_;  // 下一个请求的关联编号
+  size_t nextSlot_;  // 未完成请求数相同时轮流选择，避免总是选中第一条连接
+};
+
+}  // namespace jmuduo
+
+#endif
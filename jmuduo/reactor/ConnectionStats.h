@@ -0,0 +1,63 @@
+#ifndef _JMUDUO_CONNECTION_STATS_H_
+#define _JMUDUO_CONNECTION_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 一类连接的统计计数，由属于这一类的所有连接共享（可能属于不同的 IO 线程）
+ * TcpServer 为自己的连接建立一个，用户可以用 TcpConnection::setStats 把连接归入别的类别
+ * （如按端口、按用户等级）。计数在读写时用 relaxed 原子操作累加，读取时不需要访问连接，
+ * 任意线程都可以随时读取。各计数器放在不同的缓存行中，避免读、写两个方向互相干扰
+ */
+class ConnectionStats : noncopyable {
+ public:
+  explicit ConnectionStats(const std::string& name)
+      : name_(name), active_(0), total_(0), bytesRead_(0), bytesWritten_(0) {}
+
+  const std::string& name() const { return name_; }
+
+  void connected() {
+    active_.fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void disconnected() { active_.fetch_sub(1, std::memory_order_relaxed); }
+  void addBytesRead(size_t n) {
+    bytesRead_.fetch_add(n, std::memory_order_relaxed);
+  }
+  void addBytesWritten(size_t n) {
+    bytesWritten_.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  // 当前的连接数
+  int64_t active() const { return active_.load(std::memory_order_relaxed); }
+  // 累计的连接数
+  int64_t total() const { return total_.load(std::memory_order_relaxed); }
+  uint64_t bytesRead() const {
+    return bytesRead_.load(std::memory_order_relaxed);
+  }
+  uint64_t bytesWritten() const {
+    return bytesWritten_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const std::string name_;
+  alignas(64) std::atomic<int64_t> active_;
+  std::atomic<int64_t> total_;
+  alignas(64) std::atomic<uint64_t> bytesRead_;
+  alignas(64) std::atomic<uint64_t> bytesWritten_;
+};
+
+using ConnectionStatsPtr = std::shared_ptr<ConnectionStats>;
+
+}  // namespace jmuduo
+
+#endif
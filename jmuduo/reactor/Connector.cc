@@ -0,0 +1,189 @@
+#include "Connector.h"
+
+#include <assert.h>
+#include <errno.h>
+
+#include <algorithm>
+
+#include "../base/logging/Logging.h"
+#include "Channel.h"
+#include "EventLoop.h"
+#include "SocketsOps.h"
+
+using namespace jmuduo;
+
+const double Connector::kInitRetryDelay = 0.5;
+const double Connector::kMaxRetryDelay = 30.0;
+
+Connector::Connector(EventLoop* loop, const InetAddress& serverAddr)
+    : loop_(loop),
+      serverAddr_(serverAddr),
+      connect_(false),
+      state_(kDisconnected),
+      retryDelay_(kInitRetryDelay) {
+  LOG_DEBUG << "Connector ctor[" << this << "]";
+}
+
+Connector::~Connector() {
+  LOG_DEBUG << "Connector dtor[" << this << "]";
+  assert(!channel_);
+}
+
+void Connector::start() {
+  connect_ = true;
+  // FIXME: unsafe 如果 Connector 在 startInLoop 执行前被销毁
+  loop_->runInLoop(std::bind(&Connector::startInLoop, this));
+}
+
+void Connector::startInLoop() {
+  loop_->assertInLoopThread();
+  assert(state_ == kDisconnected);
+  if (connect_) {
+    connect();
+  } else {
+    LOG_DEBUG << "do not connect";
+  }
+}
+
+void Connector::restart() {
+  loop_->assertInLoopThread();
+  setState(kDisconnected);
+  retryDelay_ = kInitRetryDelay;
+  connect_ = true;
+  startInLoop();
+}
+
+void Connector::stop() {
+  connect_ = false;
+  // 已经注册的重试定时器到期后会看到 connect_ 为 false，不再连接
+  loop_->queueInLoop(std::bind(&Connector::stopInLoop, shared_from_this()));
+}
+
+void Connector::stopInLoop() {
+  loop_->assertInLoopThread();
+  if (state_ == kConnecting) {
+    setState(kDisconnected);
+    int sockfd = removeAndResetChannel();
+    retry(sockfd);  // connect_ 为 false，只会关闭 sockfd
+  }
+}
+
+void Connector::connect() {
+  int sockfd = sockets::createNonblockingOrDie(serverAddr_.family());
+  int ret = sockets::connect(sockfd, serverAddr_.getSockAddr(),
+                             serverAddr_.length());
+  int savedErrno = (ret == 0) ? 0 : errno;
+  switch (savedErrno) {
+    case 0:
+    case EINPROGRESS:  // 正在连接
+    case EINTR:
+    case EISCONN:  // 已经连接
+      connecting(sockfd);
+      break;
+
+    case EAGAIN:  // 临时端口用完了
+    case EADDRINUSE:
+    case EADDRNOTAVAIL:
+    case ECONNREFUSED:
+    case ENETUNREACH:
+      // 暂时性的错误，重试
+      retry(sockfd);
+      break;
+
+    case EACCES:
+    case EPERM:
+    case EAFNOSUPPORT:
+    case EALREADY:
+    case EBADF:
+    case EFAULT:
+    case ENOTSOCK:
+      // 致命错误，不再重试
+      LOG_SYSERR << "connect error in Connector::startInLoop " << savedErrno;
+      sockets::close(sockfd);
+      break;
+
+    default:
+      LOG_SYSERR << "Unexpected error in Connector::startInLoop " << savedErrno;
+      sockets::close(sockfd);
+      break;
+  }
+}
+
+void Connector::connecting(int sockfd) {
+  setState(kConnecting);
+  assert(!channel_);
+  channel_.reset(new Channel(loop_, sockfd));
+  channel_->setKind(Channel::kConnector);
+  // channel_ 是 Connector 的成员，回调时 Connector 必然存在
+  channel_->setWriteCallback(std::bind(&Connector::handleWrite, this));
+  channel_->setErrorCallback(std::bind(&Connector::handleError, this));
+  // 非阻塞 connect 完成（成功或失败）时 socket 变为可写
+  channel_->enableWriting();
+}
+
+int Connector::removeAndResetChannel() {
+  channel_->disableAll();
+  loop_->removeChannel(channel_.get());
+  int sockfd = channel_->fd();
+  // 当前可能正在 Channel::handleEvent 中，不能在这里销毁 channel_
+  loop_->queueInLoop(std::bind(&Connector::resetChannel, shared_from_this()));
+  return sockfd;
+}
+
+void Connector::resetChannel() { channel_.reset(); }
+
+void Connector::handleWrite() {
+  LOG_TRACE << "Connector::handleWrite state = " << state_;
+  if (state_ == kConnecting) {
+    // 连接已经完成，不再需要监听可写事件，socket 交给 TcpConnection
+    int sockfd = removeAndResetChannel();
+    int err = sockets::getSocketError(sockfd);
+    if (err) {
+      LOG_WARN << "Connector::handleWrite - SO_ERROR = " << err << " "
+               << strerror_tl(err);
+      retry(sockfd);
+    } else if (sockets::isSelfConnect(sockfd)) {
+      LOG_WARN << "Connector::handleWrite - Self connect";
+      retry(sockfd);
+    } else {
+      setState(kConnected);
+      if (connect_) {
+        newConnectionCallback_(sockfd);
+      } else {
+        sockets::close(sockfd);
+      }
+    }
+  } else {
+    // 连接失败时 poll 同时返回 POLLERR 和 POLLOUT，handleError 已经处理过了
+    assert(state_ == kDisconnected);
+  }
+}
+
+void Connector::handleError() {
+  LOG_ERROR << "Connector::handleError state = " << state_;
+  if (state_ == kConnecting) {
+    int sockfd = removeAndResetChannel();
+    int err = sockets::getSocketError(sockfd);
+    LOG_TRACE << "SO_ERROR = " << err << " " << strerror_tl(err);
+    retry(sockfd);
+  }
+}
+
+void Connector::retry(int sockfd) {
+  sockets::close(sockfd);
+  setState(kDisconnected);
+  if (connect_) {
+    LOG_INFO << "Connector::retry - Retry connecting to "
+             << serverAddr_.toHostPort() << " in " << retryDelay_
+             << " seconds. ";
+    // 定时器回调持有 weak_ptr，Connector 销毁后不再重试
+    std::weak_ptr<Connector> weakSelf(shared_from_this());
+    loop_->runAfter(retryDelay_, [weakSelf] {
+      ConnectorPtr self = weakSelf.lock();
+      if (self) self->startInLoop();
+    });
+    retryDelay_ = std::min(retryDelay_ * 2, kMaxRetryDelay);
+  } else {
+    LOG_DEBUG << "do not connect";
+  }
+}
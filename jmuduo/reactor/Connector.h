@@ -0,0 +1,83 @@
+#ifndef _JMUDUO_CONNECTOR_H_
+#define _JMUDUO_CONNECTOR_H_
+
+#include <functional>
+#include <memory>
+
+#include "InetAddress.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Channel;
+class EventLoop;
+
+/**
+ * 主动发起 TCP 连接，供 TcpClient 使用。Connector 只负责建立 socket 连接，
+ * 连接建立后把 sockfd 交给用户回调，不负责创建 TcpConnection
+ *
+ * 非阻塞 connect 的流程：
+ * 1. connect 返回 EINPROGRESS 表示正在连接，此时用 Channel 监听 socket 的可写事件
+ * 2. socket 可写时，用 getsockopt(SO_ERROR) 判断连接是否成功，还要排除自连接
+ * 3. 连接失败时关闭 socket，按指数退避的时间间隔（0.5s 起，翻倍，最长 30s）重试，
+ *    因为 socket 连接失败后不能再次使用，每次重试都要创建新的 socket
+ * 见 high-performance-network-server/client_unblockconnect.c
+ *
+ * 重试使用 runAfter 注册定时器，定时器回调持有 weak_ptr，Connector 销毁后不会被调用，
+ * 所以 Connector 必须由 shared_ptr 管理
+ */
+class Connector : noncopyable, public std::enable_shared_from_this<Connector> {
+ public:
+  // 连接建立后的回调，由用户负责 sockfd 的生命期
+  using NewConnectionCallback = std::function<void(int sockfd)>;
+
+  Connector(EventLoop* loop, const InetAddress& serverAddr);
+  ~Connector();
+
+  void setNewConnectionCallback(const NewConnectionCallback& cb) {
+    newConnectionCallback_ = cb;
+  }
+
+  const InetAddress& serverAddress() const { return serverAddr_; }
+
+  // 开始连接，可以在任意线程调用
+  void start();
+  // 重置重试间隔并重新连接，只能在 loop_ 线程调用
+  void restart();
+  // 停止连接和重试，可以在任意线程调用
+  void stop();
+
+ private:
+  enum States { kDisconnected, kConnecting, kConnected };
+  static const double kInitRetryDelay;  // 初始重试间隔，单位秒
+  static const double kMaxRetryDelay;   // 最长重试间隔，单位秒
+
+  void setState(States s) { state_ = s; }
+  void startInLoop();
+  void stopInLoop();
+  // 发起一次非阻塞 connect
+  void connect();
+  // 正在连接，监听 socket 的可写事件
+  void connecting(int sockfd);
+  void handleWrite();
+  void handleError();
+  // 关闭 sockfd，如果还需要连接，等待一段时间后重试
+  void retry(int sockfd);
+  // 停止监听并移除 channel_，返回其 sockfd
+  int removeAndResetChannel();
+  void resetChannel();
+
+  EventLoop* loop_;           // 发起连接的事件循环
+  InetAddress serverAddr_;    // 要连接的地址
+  bool connect_;              // FIXME: use atomic variable 是否需要连接
+  States state_;              // FIXME: use atomic variable
+  std::unique_ptr<Channel> channel_;  // 正在连接时监听可写事件的信道
+  NewConnectionCallback newConnectionCallback_;
+  double retryDelay_;         // 下一次重试的间隔，单位秒
+};
+
+using ConnectorPtr = std::shared_ptr<Connector>;
+
+}  // namespace jmuduo
+
+#endif
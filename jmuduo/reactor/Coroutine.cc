@@ -0,0 +1,105 @@
+#include "Coroutine.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <exception>
+
+#include "../base/logging/Logging.h"
+#include "Buffer.h"
+#include "EventLoop.h"
+#include "TcpConnection.h"
+
+using namespace jmuduo;
+
+void CoTask::promise_type::unhandled_exception() noexcept {
+  try {
+    throw;
+  } catch (const std::exception& ex) {
+    LOG_FATAL << "exception caught in coroutine: " << ex.what();
+  } catch (...) {
+    LOG_FATAL << "unknown exception caught in coroutine";
+  }
+}
+
+void ReadAwaiter::await_suspend(std::coroutine_handle<> h) {
+  conn_->getLoop()->assertInLoopThread();
+  assert(conn_->readAwaiter_ == nullptr);  // 同时只能有一个协程等待读
+  handle_ = h;
+  conn_->readAwaiter_ = this;
+}
+
+bool ReadAwaiter::satisfied() {
+  const Buffer& buf = conn_->inputBuffer_;
+  bool closed = conn_->state_ == TcpConnection::kDisconnected;
+  switch (mode_) {
+    case kSome:
+      return buf.readableBytes() > 0 || closed;
+    case kExactly:
+      return buf.readableBytes() >= n_ || closed;
+    case kUntil: {
+      // 只查找新到达的数据，分隔符可能跨越新旧数据的边界
+      size_t readable = buf.readableBytes();
+      size_t start = scanned_ >= delimiter_.size()
+                         ? scanned_ - delimiter_.size() + 1
+                         : 0;
+      if (start < readable) {
+        // 常见的分隔符使用向量化的查找
+        const void* found;
+        if (delimiter_ == "\r\n")
+          found = buf.findCRLF(start);
+        else if (delimiter_.size() == 1)
+          found = buf.findByte(delimiter_[0], start);
+        else
+          found = ::memmem(buf.peek() + start, readable - start,
+                           delimiter_.data(), delimiter_.size());
+        if (found != nullptr) {
+          n_ = static_cast<const char*>(found) - buf.peek() + delimiter_.size();
+          return true;
+        }
+      }
+      scanned_ = readable;
+      return closed;
+    }
+  }
+  return closed;
+}
+
+std::string ReadAwaiter::retrieve() {
+  Buffer& buf = conn_->inputBuffer_;
+  // kUntil 找到分隔符时 n_ 为数据长度，否则为 0
+  if (n_ == 0 || buf.readableBytes() < n_) return std::string();
+  std::string result(buf.peek(), n_);
+  buf.retrieve(n_);
+  return result;
+}
+
+Buffer* ReadAwaiter::buffer() {
+  Buffer* buf = &conn_->inputBuffer_;
+  return buf->readableBytes() > 0 ? buf : nullptr;
+}
+
+bool WriteAwaiter::await_ready() {
+  conn_->getLoop()->assertInLoopThread();
+  if (conn_->state_ != TcpConnection::kConnected) return true;
+  if (buffer_ != nullptr) {
+    conn_->sendInLoop(buffer_->peek(), buffer_->readableBytes());
+    buffer_->retrieveAll();
+  } else {
+    conn_->sendInLoop(data_, len_);
+  }
+  // 数据已经全部写入 socket，不需要挂起
+  return conn_->outputBuffer_.readableBytes() == 0;
+}
+
+void WriteAwaiter::await_suspend(std::coroutine_handle<> h) {
+  assert(conn_->writeAwaiter_ == nullptr);  // 同时只能有一个协程等待写
+  handle_ = h;
+  conn_->writeAwaiter_ = this;
+}
+
+bool WriteAwaiter::await_resume() { return conn_->connected(); }
+
+void SleepAwaiter::await_suspend(std::coroutine_handle<> h) {
+  loop_->runAfter(seconds_, [h] { h.resume(); });
+}
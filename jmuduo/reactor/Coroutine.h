@@ -0,0 +1,148 @@
+#ifndef _JMUDUO_COROUTINE_H_
+#define _JMUDUO_COROUTINE_H_
+
+#include <stddef.h>
+
+#include <coroutine>
+#include <string>
+#include <string_view>
+
+namespace jmuduo {
+
+class Buffer;
+class EventLoop;
+class TcpConnection;
+
+/**
+ * C++20 协程接口，用顺序的代码代替 MessageCallback/WriteCompleteCallback/runAfter
+ * 组成的回调链来编写多步骤的协议：
+ *
+ *   CoTask session(TcpConnectionPtr conn) {
+ *     std::string header = co_await conn->readUntil("\r\n");
+ *     std::string body = co_await conn->readExactly(len);
+ *     co_await conn->write(reply);
+ *     co_await conn->getLoop()->sleep(1.0);
+ *   }
+ *   server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+ *     if (conn->connected()) session(conn);
+ *   });
+ *
+ * 1. 协程总是运行在连接所属的 IO 线程中。等待的条件满足时，协程直接在事件处理函数
+ *    （handleRead/handleWrite/定时器回调）中被恢复执行，不经过 queueInLoop
+ * 2. 等待体（awaiter）是协程帧中的临时对象，TcpConnection 只保存指向它的指针，
+ *    每次 co_await 不需要额外分配内存
+ * 3. 条件已经满足时（如缓冲区中已有足够的数据）co_await 不会挂起协程
+ * 4. 每个连接同时最多有一个协程在等待读，一个协程在等待写
+ * 5. 协程的参数应该是 TcpConnectionPtr 的值，保证协程运行期间连接对象存活
+ */
+
+/**
+ * @brief 分离式的协程任务：调用协程函数时立即开始执行，执行完毕时自动销毁协程帧，
+ * 调用者不需要也不能等待其结束
+ */
+struct CoTask {
+  struct promise_type {
+    CoTask get_return_object() noexcept { return CoTask(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    // 协程中未捕获的异常，打印日志并终止程序
+    void unhandled_exception() noexcept;
+  };
+};
+
+/**
+ * @brief 等待连接的输入缓冲区中有满足条件的数据，由 TcpConnection::read* 返回
+ * 连接断开时恢复协程，此时 readExactly/readUntil 返回空字符串，readSome 返回 nullptr
+ */
+class ReadAwaiter {
+ public:
+  enum Mode {
+    kSome,     // 有任意数据
+    kExactly,  // 有 n 个字节
+    kUntil,    // 有以 delimiter 结尾的数据
+  };
+
+  ReadAwaiter(TcpConnection* conn, Mode mode, size_t n,
+              std::string_view delimiter)
+      : conn_(conn), mode_(mode), n_(n), delimiter_(delimiter), scanned_(0) {}
+
+  bool await_ready() { return satisfied(); }
+  void await_suspend(std::coroutine_handle<> h);
+
+ protected:
+  friend class TcpConnection;
+
+  // 输入缓冲区中的数据是否满足条件，或者连接已经断开
+  bool satisfied();
+  // 满足条件时取出数据，连接已断开时返回空字符串
+  std::string retrieve();
+  Buffer* buffer();
+
+  TcpConnection* conn_;
+  Mode mode_;
+  size_t n_;                    // kExactly: 字节数 kUntil: 找到的数据长度
+  std::string_view delimiter_;  // kUntil 的分隔符，调用者保证其在等待期间有效
+  size_t scanned_;              // kUntil 已经查找过的长度，避免重复查找
+  std::coroutine_handle<> handle_;
+};
+
+// co_await 结果为读到的字符串
+struct StringReadAwaiter : ReadAwaiter {
+  using ReadAwaiter::ReadAwaiter;
+  std::string await_resume() { return retrieve(); }
+};
+
+// co_await 结果为连接的输入缓冲区，由调用者取走其中的数据
+struct BufferReadAwaiter : ReadAwaiter {
+  using ReadAwaiter::ReadAwaiter;
+  Buffer* await_resume() { return buffer(); }
+};
+
+/**
+ * @brief 发送数据并等待输出缓冲区被清空，相当于 WriteCompleteCallback，
+ * 由 TcpConnection::write 返回。co_await 结果为连接是否仍然有效
+ * 数据在 co_await 时立即发送或拷贝到输出缓冲区，之后调用者可以释放数据
+ */
+class WriteAwaiter {
+ public:
+  WriteAwaiter(TcpConnection* conn, const void* data, size_t len)
+      : conn_(conn), data_(data), len_(len), buffer_(nullptr) {}
+  // 发送 buffer 中的全部数据并清空 buffer
+  WriteAwaiter(TcpConnection* conn, Buffer* buffer)
+      : conn_(conn), data_(nullptr), len_(0), buffer_(buffer) {}
+
+  bool await_ready();
+  void await_suspend(std::coroutine_handle<> h);
+  bool await_resume();
+
+ private:
+  friend class TcpConnection;
+
+  TcpConnection* conn_;
+  const void* data_;
+  size_t len_;
+  Buffer* buffer_;
+  std::coroutine_handle<> handle_;
+};
+
+/**
+ * @brief 在事件循环中等待一段时间，由 EventLoop::sleep 返回
+ */
+class SleepAwaiter {
+ public:
+  SleepAwaiter(EventLoop* loop, double seconds)
+      : loop_(loop), seconds_(seconds) {}
+
+  bool await_ready() const { return seconds_ <= 0; }
+  void await_suspend(std::coroutine_handle<> h);
+  void await_resume() const {}
+
+ private:
+  EventLoop* loop_;
+  double seconds_;
+};
+
+}  // namespace jmuduo
+
+#endif
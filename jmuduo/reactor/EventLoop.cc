@@ -1,8 +1,11 @@
 #include "EventLoop.h"
 #include "Channel.h"
+#include "EventLoopMetrics.h"
+#include "PerfCounters.h"
 #include "Poller.h"
 #include "TimerQueue.h"
 #include "../base/logging/Logging.h"
+#include "../base/metrics/Tracer.h"
 
 #include <assert.h>
 #include <sys/eventfd.h>
@@ -14,6 +17,7 @@ using namespace jmuduo;
 // 线程独立变量，保存当前线程下的 事件循环对象指针
 __thread EventLoop* t_loopInThisThread = nullptr;
 const int kPollTimeMs = 10000; // poll 等待时间
+const double kPerfSampleInterval = 0.1; // 读取性能计数器的间隔，秒
 
 EventLoop* EventLoop::getEventLoopOfCurrentThread() {
   return t_loopInThisThread;
@@ -48,7 +52,9 @@ EventLoop::EventLoop()
     poller_(new Poller(this)),
     timerQueue_(new TimerQueue(this)),
     wakeupFd_(createEventfd()),
-    wakeupChannel_(new Channel(this, wakeupFd_)) {
+    wakeupChannel_(new Channel(this, wakeupFd_)),
+    metrics_(nullptr),
+    perfCounters_(nullptr) {
   LOG_TRACE << "EventLoop created " << this << " in thread " << threadId_;
 
   if (t_loopInThisThread) { // 一个线程下只能有一个事件循环
@@ -58,6 +64,7 @@ EventLoop::EventLoop()
     t_loopInThisThread = this;
 
 
+  wakeupChannel_->setKind(Channel::kWakeup);
   wakeupChannel_->setReadCallback(std::bind(&EventLoop::handleRead, this));
   // 事件循环运行期间一直监听唤醒信号
   wakeupChannel_->enableReading();
@@ -66,6 +73,8 @@ EventLoop::EventLoop()
 EventLoop::~EventLoop() {
   assert(!looping_);  // 对象销毁时事件循环必须已经停止
   ::close(wakeupFd_);
+  delete metrics_.load();
+  delete perfCounters_.load();
   t_loopInThisThread = nullptr;
 }
 
@@ -77,6 +86,14 @@ void EventLoop::loop() {
 
   while (!quit_)  {
     activeChannels_.clear(); // 每一轮事件循环前清空活动信道列表
+    if (PerfCounters* perf = perfCounters_.load(std::memory_order_relaxed))
+      samplePerfCounters(perf);
+    // 没有开启统计和跟踪时，每轮只多两次可预测的判断
+    EventLoopMetrics* metrics = metrics_.load(std::memory_order_acquire);
+    if (metrics != nullptr || Tracer::enabled()) {
+      loopInstrumented(metrics, Tracer::enabled());
+      continue;
+    }
     pollReturnTime_ = poller_->poll(kPollTimeMs, &activeChannels_); // 等待事件到来
     for(auto it : activeChannels_) // 遍历处理每一个活动信道的事件
       it->handleEvent(pollReturnTime_);
@@ -88,6 +105,73 @@ void EventLoop::loop() {
   looping_ = false;
 }
 
+/**
+ * 开启统计或跟踪时的一轮事件循环，和 loop 中的流程相同，每个事件回调前后各读一次时钟
+ * （前一个回调的结束时间就是后一个回调的开始时间），统计和跟踪共用读到的时间。
+ * 跟踪记录的区间：一轮事件循环 "iteration" 包含 "poll"（参数为活动信道数）、
+ * 按信道用途命名的事件回调（参数为 fd）和 doPendingFunctors 中的区间
+ */
+void EventLoop::loopInstrumented(EventLoopMetrics* metrics, bool tracing) {
+  int64_t pollStart = EventLoopMetrics::nowNanos();
+  pollReturnTime_ = poller_->poll(kPollTimeMs, &activeChannels_);
+  int64_t busyStart = EventLoopMetrics::nowNanos();
+  if (tracing)
+    Tracer::record("poll", pollStart, busyStart, activeChannels_.size());
+  int64_t start = busyStart;
+  for (auto it : activeChannels_) {
+    // 回调中信道可能被销毁，事先取出用途和 fd
+    Channel::Kind kind = it->kind();
+    int fd = it->fd();
+    it->handleEvent(pollReturnTime_);
+    int64_t end = EventLoopMetrics::nowNanos();
+    if (metrics != nullptr) metrics->recordCallback(kind, end - start);
+    if (tracing) Tracer::record(Channel::kindName(kind), start, end, fd);
+    start = end;
+  }
+  doPendingFunctors();
+  int64_t end = EventLoopMetrics::nowNanos();
+  if (metrics != nullptr)
+    metrics->recordIteration(busyStart - pollStart, end - busyStart,
+                             activeChannels_.size());
+  if (tracing) Tracer::record("iteration", pollStart, end);
+}
+
+void EventLoop::enableMetrics() {
+  if (metrics_.load(std::memory_order_acquire) != nullptr) return;
+  EventLoopMetrics* metrics = new EventLoopMetrics;
+  EventLoopMetrics* expected = nullptr;
+  // 多个线程同时开启时只有一个成功
+  if (!metrics_.compare_exchange_strong(expected, metrics,
+                                        std::memory_order_acq_rel))
+    delete metrics;
+}
+
+void EventLoop::enablePerfCounters() {
+  // perf_event_open 只能统计调用它的线程，必须在 IO 线程中打开
+  runInLoop([this] {
+    if (perfCounters_.load(std::memory_order_relaxed) != nullptr) return;
+    PerfCounters* perf = new PerfCounters;
+    if (!perf->valid()) {
+      LOG_WARN << "EventLoop::enablePerfCounters - perf events unavailable, "
+                  "only CPU time is sampled";
+    }
+    perf->sample();
+    lastPerfSample_ = Timestamp::now();
+    perfCounters_.store(perf, std::memory_order_release);
+  });
+}
+
+/**
+ * 在两轮事件循环之间读取，避免读到一个回调的中间。用上一次 poll 返回的时间判断间隔，
+ * 不需要再读时钟；事件循环空闲时最多 kPollTimeMs 读取一次，这期间计数器基本不变
+ */
+void EventLoop::samplePerfCounters(PerfCounters* perf) {
+  if (timeDifference(pollReturnTime_, lastPerfSample_) >= kPerfSampleInterval) {
+    perf->sample();
+    lastPerfSample_ = pollReturnTime_;
+  }
+}
+
 void EventLoop::quit() {
   quit_ = true;
   /**
@@ -125,6 +209,17 @@ void EventLoop::queueInLoop(const Functor& cb) {
     wakeup();
 }
 
+void EventLoop::runBeforePoll(Functor cb) {
+  assertInLoopThread();
+  beforePollFunctors_.push_back(std::move(cb));
+  // 事件循环还没有开始时，保证第一次 poll 不会阻塞
+  if (!looping_) wakeup();
+}
+
+void detail::runInLoop(EventLoop* loop, std::function<void()> cb) {
+  loop->runInLoop(cb);
+}
+
 TimerId EventLoop::runAt(const Timestamp time, const TimerCallback& cb) {
   return timerQueue_->addTimer(cb, time, 0.0);
 }
@@ -139,6 +234,10 @@ TimerId EventLoop::runEvery(double interval, const TimerCallback& cb) {
   return timerQueue_->addTimer(cb, time, interval);
 }
 
+size_t EventLoop::numTimers() const {
+  return timerQueue_->size();
+}
+
 void EventLoop::abortNotInLoopThread() {
   LOG_FATAL << "EventLoop::abortNotInLoopThread - EventLoop " << this
             << " was created in threadId_ = " << threadId_
@@ -185,6 +284,11 @@ void EventLoop::handleRead() {
 void EventLoop::doPendingFunctors() {
   std::vector<Functor> functors;
   callingPendingFunctors_ = true;
+  EventLoopMetrics* metrics = metrics_.load(std::memory_order_relaxed);
+  bool tracing = Tracer::enabled();
+  int64_t start =
+      metrics != nullptr || tracing ? EventLoopMetrics::nowNanos() : 0;
+  size_t batch = 0;
   
   /**
    * 没有直接在临界区中依次执行 functors，而是 swap 到局部变量中
@@ -204,8 +308,44 @@ void EventLoop::doPendingFunctors() {
    * 在这里重新注册 functor 时调用到 queueInLoop 会唤醒事件循环，这样就保证了
    * 及时处理 functor，而且 IO 事件总能被处理。
    */
-  for(auto &func : functors)
-    func();
+  runFunctors(functors, "functor", tracing);
+  batch += functors.size();
+
+  /**
+   * runBeforePoll 注册的函数在所有 functor 之后执行，这样 functor 中产生的工作
+   * （如跨线程转移过来的 send）也能被合并。它们注册新的 functor 时同样会唤醒事件循环；
+   * 它们再次调用 runBeforePoll 时，新注册的函数在下一轮执行，也需要唤醒
+   */
+  if (!beforePollFunctors_.empty()) {
+    functors.clear();
+    functors.swap(beforePollFunctors_);
+    runFunctors(functors, "beforePoll", tracing);
+    batch += functors.size();
+    if (!beforePollFunctors_.empty()) wakeup();
+  }
   callingPendingFunctors_ = false;
+  if (batch > 0 && (metrics != nullptr || tracing)) {
+    int64_t end = EventLoopMetrics::nowNanos();
+    if (metrics != nullptr) metrics->recordFunctors(batch, end - start);
+    if (tracing) Tracer::record("functors", start, end, batch);
+  }
+}
+
+/**
+ * 依次执行 functors，开启跟踪时每个 functor 记录一个区间 name
+ */
+void EventLoop::runFunctors(std::vector<Functor>& functors, const char* name,
+                            bool tracing) {
+  if (!tracing) {
+    for (auto& func : functors) func();
+    return;
+  }
+  int64_t start = Tracer::now();
+  for (auto& func : functors) {
+    func();
+    int64_t end = Tracer::now();
+    Tracer::record(name, start, end);
+    start = end;
+  }
 }
 
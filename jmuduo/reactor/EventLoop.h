@@ -2,20 +2,26 @@
 #define _JMUDUO_EVENTLOOP_H_
 
 #include <sys/types.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <functional>
+#include <type_traits>
 
 #include "../base/noncopyable.h"
 #include "../base/thread/Thread.h"
 #include "../base/thread/Mutex.h"
 #include "Callbacks.h"
+#include "Coroutine.h"
+#include "Future.h"
 #include "TimerId.h"
 
 namespace jmuduo
 {
 
 class Channel;
+class EventLoopMetrics;
+class PerfCounters;
 class Poller;
 class TimerQueue;
 
@@ -51,6 +57,57 @@ class EventLoop : noncopyable {
    * 可以在别的线程中调用
    */
   void queueInLoop(const Functor& cb);
+  /**
+   * @brief 在本轮事件循环的最后（所有 IO 回调和 functors 之后，下一次 poll 之前）
+   * 运行回调函数 cb，用于合并一轮事件处理中产生的工作，如 TcpConnection 延迟的写。
+   * 和 queueInLoop 不同，不加锁，只能在 IO 线程中调用
+   */
+  void runBeforePoll(Functor cb);
+
+  /**
+   * @brief 在本事件循环中执行 f，返回获取其结果的 Future，见 Future.h
+   * 如果在本事件循环所在的 IO 线程中调用，f 会被立即同步执行
+   * 可以在别的线程中调用
+   */
+  template <typename F>
+  Future<std::invoke_result_t<std::decay_t<F>&>> call(F&& f) {
+    using R = std::invoke_result_t<std::decay_t<F>&>;
+    // 共享状态的两个引用计数分别属于返回的 Future 和待执行的 functor
+    auto* state = new detail::CallState<std::decay_t<F>, R>(std::forward<F>(f));
+    runInLoop([state] {
+      state->run();
+      state->release();
+    });
+    return Future<R>(state);
+  }
+
+  /**
+   * @brief 开启本事件循环的运行统计，见 EventLoopMetrics。默认关闭，开启后每个事件回调
+   * 多读一次单调时钟（vDSO，约 20ns）。重复调用无影响
+   * 可以在别的线程中调用
+   */
+  void enableMetrics();
+  /**
+   * @brief 本事件循环的运行统计，没有开启时返回 nullptr
+   * 可以在别的线程中调用 metrics()->snapshot()，开启后对象和事件循环的生命期相同
+   */
+  EventLoopMetrics* metrics() const {
+    return metrics_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 开启本事件循环所在线程的性能计数器，见 PerfCounters。计数器只能在 IO 线程中打开，
+   * 所以是异步的；开启后在两轮事件循环之间每隔 kPerfSampleInterval 秒读取一次。
+   * perf 不可用时打印警告，只有 CPU 时间可用。重复调用无影响，可以在别的线程中调用
+   */
+  void enablePerfCounters();
+  /**
+   * @brief 本事件循环的性能计数器，没有开启时返回 nullptr
+   * 可以在别的线程中调用 perfCounters()->snapshot()，开启后对象和事件循环的生命期相同
+   */
+  PerfCounters* perfCounters() const {
+    return perfCounters_.load(std::memory_order_acquire);
+  }
 
   /* 定时器操作接口 */
   /**
@@ -73,8 +130,15 @@ class EventLoop : noncopyable {
    * @return TimerId 用于取消定时器
    */
   TimerId runEvery(double interval, const TimerCallback& cb);
+  /**
+   * @brief 在协程中等待 seconds 秒，co_await loop->sleep(1.0)，见 Coroutine.h
+   */
+  SleepAwaiter sleep(double seconds) { return SleepAwaiter(this, seconds); }
+
   // TODO 取消定时器
   // void cancel(TimerId TimerId);
+  // 还没有到期的定时器个数，只能在 IO 线程中调用
+  size_t numTimers() const;
 
   /* 只能在库内部使用的方法 */
   // 唤醒阻塞的事件循环
@@ -109,6 +173,12 @@ private:
   void handleRead();
   // 处理本次事件循环中注册的 functors
   void doPendingFunctors();
+  // 开启统计或跟踪（见 Tracer）时的一轮事件循环，metrics 可能为空
+  void loopInstrumented(EventLoopMetrics* metrics, bool tracing);
+  static void runFunctors(std::vector<Functor>& functors, const char* name,
+                          bool tracing);
+  // 距离上次读取超过 kPerfSampleInterval 时读取性能计数器
+  void samplePerfCounters(PerfCounters* perf);
 
   bool looping_; /* atomic，当前事件循环是否正在运行 */
   bool quit_; /* atomic 事件循环是否需要退出 */
@@ -124,6 +194,10 @@ private:
   const std::unique_ptr<Channel> wakeupChannel_; // 监听唤醒事件的信道
   MutexLock mutex_; // 保护 pendingFunctors_ 多线程操作
   std::vector<Functor> pendingFunctors_; // @GuardedBy 等待在事件循环中运行的函数列表
+  std::vector<Functor> beforePollFunctors_; // 在本轮事件循环最后运行的函数，只在 IO 线程中访问
+  std::atomic<EventLoopMetrics*> metrics_; // 运行统计，开启后不再改变，析构时删除
+  std::atomic<PerfCounters*> perfCounters_; // 性能计数器，开启后不再改变，析构时删除
+  Timestamp lastPerfSample_; // 上一次读取性能计数器的时间，只在 IO 线程中访问
 };
 
 } // namespace mudu
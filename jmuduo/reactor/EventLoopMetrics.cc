@@ -0,0 +1,38 @@
+#include "EventLoopMetrics.h"
+
+#include <time.h>
+
+using namespace jmuduo;
+
+void EventLoopMetrics::Snapshot::merge(const Snapshot& other) {
+  iterations += other.iterations;
+  pollWait.merge(other.pollWait);
+  busy.merge(other.busy);
+  activeChannels.merge(other.activeChannels);
+  functorBatch.merge(other.functorBatch);
+  functorTime.merge(other.functorTime);
+  timerLateness.merge(other.timerLateness);
+  for (int i = 0; i < Channel::kNumKinds; ++i)
+    callback[i].merge(other.callback[i]);
+}
+
+EventLoopMetrics::Snapshot EventLoopMetrics::snapshot() const {
+  Snapshot s;
+  s.iterations = iterations_.load(std::memory_order_relaxed);
+  s.pollWait = pollWait_.snapshot();
+  s.busy = busy_.snapshot();
+  s.activeChannels = activeChannels_.snapshot();
+  s.functorBatch = functorBatch_.snapshot();
+  s.functorTime = functorTime_.snapshot();
+  s.timerLateness = timerLateness_.snapshot();
+  for (int i = 0; i < Channel::kNumKinds; ++i)
+    s.callback[i] = callback_[i].snapshot();
+  return s;
+}
+
+int64_t EventLoopMetrics::nowNanos() {
+  struct timespec ts;
+  // vDSO 实现，不陷入内核
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
@@ -0,0 +1,78 @@
+#ifndef _JMUDUO_EVENT_LOOP_METRICS_H_
+#define _JMUDUO_EVENT_LOOP_METRICS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "../base/metrics/Histogram.h"
+#include "Channel.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 一个事件循环的运行统计，由 EventLoop::enableMetrics 开启
+ * 时间的单位都是纳秒（CLOCK_MONOTONIC），每轮事件循环分为两段：
+ *   poll 阻塞等待（pollWait） -> 处理 IO 事件、functors 和 runBeforePoll 的函数（busy）
+ * busy 的时间长说明事件循环过载，新到的事件要等待更久才能被处理；
+ * 按信道用途分开的回调耗时和 functors 的耗时可以找出占用事件循环的是哪一部分
+ *
+ * 只有事件循环所在的 IO 线程写入，任意线程可以随时调用 snapshot 读取，不加锁
+ */
+class EventLoopMetrics : noncopyable {
+ public:
+  struct Snapshot {
+    uint64_t iterations = 0;              // 事件循环的轮数
+    HistogramSnapshot pollWait;           // poll 阻塞的时间
+    HistogramSnapshot busy;               // 一轮事件处理的时间
+    HistogramSnapshot activeChannels;     // 每轮 poll 返回的活动信道数
+    HistogramSnapshot functorBatch;       // 每轮执行的 functor 个数（不为 0 时记录）
+    HistogramSnapshot functorTime;        // 每轮执行 functors 的时间（不为 0 个时记录）
+    HistogramSnapshot timerLateness;      // 定时器实际运行时间减去到期时间
+    HistogramSnapshot callback[Channel::kNumKinds];  // 按信道用途的事件回调耗时
+
+    // 累加另一个事件循环的统计，用于汇总线程池
+    void merge(const Snapshot& other);
+  };
+
+  EventLoopMetrics() : iterations_(0) {}
+
+  Snapshot snapshot() const;
+
+  // 单调时钟，纳秒
+  static int64_t nowNanos();
+
+  /* 以下由 EventLoop 和 TimerQueue 在 IO 线程中调用 */
+  void recordIteration(int64_t pollWait, int64_t busy, size_t activeChannels) {
+    iterations_.store(iterations_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    pollWait_.record(pollWait);
+    busy_.record(busy);
+    activeChannels_.record(activeChannels);
+  }
+  void recordCallback(Channel::Kind kind, int64_t nanos) {
+    callback_[kind].record(nanos);
+  }
+  void recordFunctors(size_t batch, int64_t nanos) {
+    functorBatch_.record(batch);
+    functorTime_.record(nanos);
+  }
+  void recordTimerLateness(int64_t nanos) {
+    timerLateness_.record(nanos > 0 ? nanos : 0);
+  }
+
+ private:
+  std::atomic<uint64_t> iterations_;
+  Histogram pollWait_;
+  Histogram busy_;
+  Histogram activeChannels_;
+  Histogram functorBatch_;
+  Histogram functorTime_;
+  Histogram timerLateness_;
+  Histogram callback_[Channel::kNumKinds];
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -39,4 +39,11 @@ EventLoop* EventLoopThreadPool::getNextLoop() {
   }
 
   return loop;
-}
\ No newline at end of file
+}
+
+std::vector<EventLoop*> EventLoopThreadPool::getAllLoops() {
+  baseLoop_->assertInLoopThread();
+  if (loops_.empty())
+    return std::vector<EventLoop*>(1, baseLoop_);
+  return loops_;
+}
@@ -3,13 +3,14 @@
 
 #include <vector>
 #include <memory>
+#include <type_traits>
 
 #include "noncopyable.h"
+#include "EventLoop.h"
 
 
 namespace jmuduo {
   
-class EventLoop;
 class EventLoopThread;
 
 /**
@@ -25,6 +26,21 @@ class EventLoopThreadPool : noncopyable {
   void start();
   // 从线程池选取下一个事件循环对象，目前采用最简单的 round-robin 算法选取
   EventLoop* getNextLoop();
+  // 返回所有 IO 线程的事件循环，没有 IO 线程时返回 baseLoop
+  std::vector<EventLoop*> getAllLoops();
+
+  /**
+   * @brief 扇出：在所有 IO 线程的事件循环中执行 f，返回每个事件循环的结果，
+   * 结果的顺序和 getAllLoops 相同。可以用 whenAll 在某个事件循环中汇总结果：
+   *   whenAll(pool->callAll(countConnections), baseLoop,
+   *           [](std::vector<size_t> counts) { ... });
+   */
+  template <typename F>
+  std::vector<Future<std::invoke_result_t<F&>>> callAll(const F& f) {
+    std::vector<Future<std::invoke_result_t<F&>>> futures;
+    for (EventLoop* loop : getAllLoops()) futures.push_back(loop->call(f));
+    return futures;
+  }
 
  private:
   EventLoop* baseLoop_; // IO 线程池由某个 TcpServer 所有，指向 TcpServer 所在的事件循环
@@ -0,0 +1,256 @@
+#ifndef _JMUDUO_FUTURE_H_
+#define _JMUDUO_FUTURE_H_
+
+#include <assert.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/noncopyable.h"
+
+namespace jmuduo {
+
+class EventLoop;
+
+template <typename R>
+class Future;
+
+/**
+ * 跨线程的请求/响应：EventLoop::call(f) 在 IO 线程中执行 f，返回 Future 获取结果。
+ * 结果可以阻塞等待获取，也可以通过 then 交给另一个事件循环中的回调：
+ *
+ *   Future<size_t> f = ioLoop->call([] { return numConnections(); });
+ *   size_t n = f.get();  // 阻塞等待，不能在 ioLoop 所在线程中调用
+ *
+ *   ioLoop->call(query).then(baseLoop, [](size_t n) { ... });  // 在 baseLoop 中执行
+ *
+ * 和 std::promise/std::future 相比：
+ * 1. 共享状态、待执行的函数和结果存放在同一个侵入式引用计数的对象中，
+ *    每次 call 只有这一次内存分配，交给 runInLoop 的 functor 只捕获一个指针，不会再分配
+ * 2. 阻塞等待使用 C++20 的 std::atomic::wait，不需要 mutex 和 condition
+ * 3. 支持在指定的事件循环中执行的后续回调（continuation）
+ */
+
+namespace detail {
+
+// 代替 void 类型的结果
+struct Unit {};
+
+// 定义在 EventLoop.cc 中，使 Future.h 不依赖 EventLoop 的完整定义
+void runInLoop(EventLoop* loop, std::function<void()> cb);
+
+/**
+ * @brief Future 的共享状态，由 Future 和结果的生产者共同持有
+ */
+template <typename R>
+class FutureState : noncopyable {
+ public:
+  using Value = std::conditional_t<std::is_void_v<R>, Unit, R>;
+  using Continuation = std::function<void(Value&&)>;
+
+  FutureState() : refs_(2), status_(kEmpty), loop_(nullptr) {}
+  virtual ~FutureState() = default;
+
+  void addRef() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+  }
+
+  // 生产者设置结果，唤醒等待的线程或者派发后续回调
+  void setValue(Value&& value) {
+    value_.emplace(std::move(value));
+    int prev = status_.fetch_or(kReady, std::memory_order_acq_rel);
+    if (prev & kContinuation)
+      dispatch();
+    else
+      status_.notify_all();
+  }
+
+  // 设置后续回调，结果已经就绪时立即派发
+  void setContinuation(EventLoop* loop, Continuation cb) {
+    loop_ = loop;
+    continuation_ = std::move(cb);
+    int prev = status_.fetch_or(kContinuation, std::memory_order_acq_rel);
+    if (prev & kReady) dispatch();
+  }
+
+  bool ready() const { return status_.load(std::memory_order_acquire) & kReady; }
+
+  void wait() const {
+    int s;
+    while (!((s = status_.load(std::memory_order_acquire)) & kReady))
+      status_.wait(s, std::memory_order_acquire);
+  }
+
+  Value& value() {
+    assert(ready());
+    return *value_;
+  }
+
+ private:
+  enum Status : int {
+    kEmpty = 0,
+    kReady = 1,         // 结果已经就绪
+    kContinuation = 2,  // 已经设置了后续回调
+  };
+
+  // 结果和后续回调都就绪时，由后设置的一方调用，所以只会派发一次
+  void dispatch() {
+    addRef();
+    runInLoop(loop_, [this] {
+      continuation_(std::move(*value_));
+      release();
+    });
+  }
+
+  std::atomic<int> refs_;
+  std::atomic<int> status_;
+  std::optional<Value> value_;
+  EventLoop* loop_;             // 执行后续回调的事件循环
+  Continuation continuation_;
+};
+
+/**
+ * @brief EventLoop::call 使用的共享状态，同时保存待执行的函数
+ */
+template <typename F, typename R>
+class CallState : public FutureState<R> {
+ public:
+  explicit CallState(F&& func) : func_(std::move(func)) {}
+  explicit CallState(const F& func) : func_(func) {}
+
+  void run() {
+    if constexpr (std::is_void_v<R>) {
+      func_();
+      this->setValue(Unit());
+    } else {
+      this->setValue(func_());
+    }
+  }
+
+ private:
+  F func_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief 异步结果，只能移动，结果只能被 get 或 then 取走一次
+ */
+template <typename R>
+class Future {
+ public:
+  using State = detail::FutureState<R>;
+
+  Future() : state_(nullptr) {}
+  // 接管 state 的一个引用计数
+  explicit Future(State* state) : state_(state) {}
+  Future(Future&& rhs) noexcept : state_(rhs.state_) { rhs.state_ = nullptr; }
+  Future& operator=(Future&& rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      state_ = rhs.state_;
+      rhs.state_ = nullptr;
+    }
+    return *this;
+  }
+  Future(const Future&) = delete;
+  Future& operator=(const Future&) = delete;
+  ~Future() { reset(); }
+
+  bool valid() const { return state_ != nullptr; }
+  bool ready() const { return state_->ready(); }
+  // 阻塞等待结果就绪。不能在产生结果的事件循环所在线程中调用，否则会死锁
+  void wait() const { state_->wait(); }
+
+  // 阻塞等待并取走结果
+  R get() {
+    assert(valid());
+    state_->wait();
+    if constexpr (std::is_void_v<R>) {
+      reset();
+    } else {
+      R result(std::move(state_->value()));
+      reset();
+      return result;
+    }
+  }
+
+  /**
+   * @brief 结果就绪后在 loop 所在线程中执行 cb(result)（R 为 void 时执行 cb()），
+   * 之后本 Future 不再有效
+   */
+  template <typename Callback>
+  void then(EventLoop* loop, Callback&& cb) {
+    assert(valid());
+    if constexpr (std::is_void_v<R>) {
+      state_->setContinuation(
+          loop, [cb = std::forward<Callback>(cb)](detail::Unit&&) mutable {
+            cb();
+          });
+    } else {
+      state_->setContinuation(loop, std::forward<Callback>(cb));
+    }
+    reset();
+  }
+
+ private:
+  void reset() {
+    if (state_ != nullptr) {
+      state_->release();
+      state_ = nullptr;
+    }
+  }
+
+  State* state_;
+};
+
+/**
+ * @brief 扇入：所有 futures 的结果都就绪后，在 loop 所在线程中执行
+ * cb(std::vector<R> results)，结果的顺序和 futures 相同（R 为 void 时执行 cb()）
+ * 每个结果的后续回调都在 loop 中执行，所以汇总结果时不需要加锁
+ */
+template <typename R, typename Callback>
+void whenAll(std::vector<Future<R>> futures, EventLoop* loop, Callback&& cb) {
+  using Value = typename Future<R>::State::Value;
+  struct Gather {
+    std::vector<Value> results;
+    size_t remaining;
+    std::decay_t<Callback> callback;
+
+    void done() {
+      if constexpr (std::is_void_v<R>) {
+        callback();
+      } else {
+        callback(std::move(results));
+      }
+    }
+  };
+  auto gather = std::make_shared<Gather>(
+      Gather{std::vector<Value>(futures.size()), futures.size(),
+             std::forward<Callback>(cb)});
+
+  if (futures.empty()) {
+    detail::runInLoop(loop, [gather] { gather->done(); });
+    return;
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    auto collect = [gather, i](Value&& value) {
+      gather->results[i] = std::move(value);
+      if (--gather->remaining == 0) gather->done();
+    };
+    if constexpr (std::is_void_v<R>)
+      futures[i].then(loop, [collect]() mutable { collect(detail::Unit()); });
+    else
+      futures[i].then(loop, collect);
+  }
+}
+
+}  // namespace jmuduo
+
+#endif
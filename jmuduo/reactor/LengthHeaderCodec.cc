@@ -0,0 +1,111 @@
+#include "LengthHeaderCodec.h"
+
+#include <assert.h>
+#include <endian.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "../base/logging/Logging.h"
+#include "Buffer.h"
+#include "TcpConnection.h"
+
+using namespace jmuduo;
+
+LengthHeaderCodec::LengthHeaderCodec(const FrameCallback& cb, int headerLen,
+                                     size_t maxMessageLen)
+    : frameCallback_(cb),
+      headerLen_(headerLen),
+      // 消息的最大长度不能超过长度头能表示的范围
+      maxMessageLen_(headerLen == 8 ? maxMessageLen
+                                    : std::min<uint64_t>(
+                                          maxMessageLen,
+                                          (uint64_t(1) << (8 * headerLen)) - 1)) {
+  assert(headerLen == 1 || headerLen == 2 || headerLen == 4 || headerLen == 8);
+  // 长度头能放进 Buffer 的前部可写区域
+  static_assert(Buffer::kCheapPrepend >= sizeof(int64_t));
+}
+
+uint64_t LengthHeaderCodec::peekLength(const char* data) const {
+  switch (headerLen_) {
+    case 1:
+      return static_cast<uint8_t>(*data);
+    case 2: {
+      uint16_t be16;
+      ::memcpy(&be16, data, sizeof be16);
+      return be16toh(be16);
+    }
+    case 4: {
+      uint32_t be32;
+      ::memcpy(&be32, data, sizeof be32);
+      return be32toh(be32);
+    }
+    default: {
+      uint64_t be64;
+      ::memcpy(&be64, data, sizeof be64);
+      return be64toh(be64);
+    }
+  }
+}
+
+void LengthHeaderCodec::onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                                  Timestamp receiveTime) {
+  // 先用指针遍历所有完整的消息，最后一次性移动可读索引
+  const char* begin = buf->peek();
+  const char* end = begin + buf->readableBytes();
+  const char* p = begin;
+  while (end - p >= headerLen_) {
+    uint64_t len = peekLength(p);
+    if (len > maxMessageLen_) {
+      LOG_ERROR << "LengthHeaderCodec::onMessage [" << conn->getName()
+                << "] - invalid length " << len;
+      // 之后的数据无法再分包，丢弃并断开连接
+      buf->retrieveAll();
+      conn->shutdown();
+      return;
+    }
+    if (static_cast<uint64_t>(end - p - headerLen_) < len) break;
+    const char* message = p + headerLen_;
+    p = message + len;
+    // 回调期间 buf 不会被修改，message 一直有效
+    frameCallback_(conn, std::string_view(message, len), receiveTime);
+  }
+  buf->retrieve(p - begin);
+}
+
+void LengthHeaderCodec::encode(Buffer* buf) const {
+  uint64_t len = buf->readableBytes();
+  assert(len <= maxMessageLen_);
+  if (buf->prependableBytes() < static_cast<size_t>(headerLen_)) {
+    // 前部可写区域已经被占用（如 MessageDispatcher 写入了类型），只能拷贝一次
+    Buffer tmp;
+    tmp.append(buf->peek(), buf->readableBytes());
+    buf->swap(tmp);
+  }
+  switch (headerLen_) {
+    case 1:
+      buf->prependInt8(static_cast<int8_t>(len));
+      break;
+    case 2:
+      buf->prependInt16(static_cast<int16_t>(len));
+      break;
+    case 4:
+      buf->prependInt32(static_cast<int32_t>(len));
+      break;
+    default:
+      buf->prependInt64(static_cast<int64_t>(len));
+      break;
+  }
+}
+
+void LengthHeaderCodec::send(const TcpConnectionPtr& conn, Buffer* buf) {
+  encode(buf);
+  conn->send(buf);
+}
+
+void LengthHeaderCodec::send(const TcpConnectionPtr& conn,
+                             std::string_view message) {
+  Buffer buf;
+  buf.append(message.data(), message.size());
+  send(conn, &buf);
+}
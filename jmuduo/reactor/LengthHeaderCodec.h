@@ -0,0 +1,72 @@
+#ifndef _JMUDUO_LENGTH_HEADER_CODEC_H_
+#define _JMUDUO_LENGTH_HEADER_CODEC_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <string_view>
+
+#include "Callbacks.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class Buffer;
+
+/**
+ * 长度头分包的编解码器，每条消息的格式为：
+ *   +----------------------+-------------------+
+ *   | len (网络字节序整数) |  payload(len 字节) |
+ *   +----------------------+-------------------+
+ * 长度头可以是 1/2/4/8 字节
+ *
+ * 解码：作为 TcpConnection 的 MessageCallback，一次 read 读到的所有完整消息都在
+ * 一次 onMessage 中处理。交给用户的消息直接指向输入缓冲区，没有拷贝，只在回调期间有效
+ * 编码：在 Buffer 的前部可写区域（kCheapPrepend）写入长度头，不需要移动消息体
+ *
+ * 用法：
+ *   LengthHeaderCodec codec(onFrame);
+ *   server.setMessageCallback(std::bind(&LengthHeaderCodec::onMessage, &codec, _1, _2, _3));
+ *   Buffer buf;
+ *   buf.append(payload);
+ *   codec.send(conn, &buf);
+ */
+class LengthHeaderCodec : noncopyable {
+ public:
+  // 收到一条完整的消息，message 指向输入缓冲区，回调返回后失效
+  using FrameCallback = std::function<void(
+      const TcpConnectionPtr&, std::string_view message, Timestamp)>;
+
+  /**
+   * @param headerLen 长度头的字节数，1/2/4/8
+   * @param maxMessageLen 消息的最大长度，超过时认为对方出错，断开连接，
+   * 不能超过长度头能表示的范围
+   */
+  explicit LengthHeaderCodec(const FrameCallback& cb, int headerLen = 4,
+                             size_t maxMessageLen = 64 * 1024 * 1024);
+
+  // 拆分 buf 中所有完整的消息，不完整的数据留在 buf 中等待下一次 read
+  void onMessage(const TcpConnectionPtr& conn, Buffer* buf,
+                 Timestamp receiveTime);
+
+  // 在 buf 前加上长度头后发送 buf 中的全部数据，并清空 buf
+  void send(const TcpConnectionPtr& conn, Buffer* buf);
+  // 发送一条消息
+  void send(const TcpConnectionPtr& conn, std::string_view message);
+
+  // 在 buf 前加上长度头，用于把多条消息合并到一个 Buffer 后一起发送
+  void encode(Buffer* buf) const;
+  int headerLen() const { return headerLen_; }
+
+ private:
+  // 读取 data 开头的长度头
+  uint64_t peekLength(const char* data) const;
+
+  FrameCallback frameCallback_;
+  const int headerLen_;
+  const size_t maxMessageLen_;
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -0,0 +1,27 @@
+#include "MessageDispatcher.h"
+
+#include <endian.h>
+#include <string.h>
+
+#include "Buffer.h"
+
+using namespace jmuduo;
+
+void MessageDispatcher::onFrame(const TcpConnectionPtr& conn,
+                                std::string_view message,
+                                Timestamp receiveTime) {
+  if (message.size() >= sizeof(uint16_t)) {
+    uint16_t be16;
+    ::memcpy(&be16, message.data(), sizeof be16);
+    auto it = handlers_.find(be16toh(be16));
+    if (it != handlers_.end()) {
+      it->second(conn, message.substr(sizeof be16), receiveTime);
+      return;
+    }
+  }
+  defaultHandler_(conn, message, receiveTime);
+}
+
+void MessageDispatcher::encode(uint16_t type, Buffer* buf) {
+  buf->prependInt16(static_cast<int16_t>(type));
+}
@@ -0,0 +1,57 @@
+#ifndef _JMUDUO_MESSAGE_DISPATCHER_H_
+#define _JMUDUO_MESSAGE_DISPATCHER_H_
+
+#include <stdint.h>
+
+#include <string_view>
+#include <unordered_map>
+
+#include "LengthHeaderCodec.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * 按消息类型分发 LengthHeaderCodec 拆分出的消息，消息的格式为：
+ *   +------------------------+---------+
+ *   | type (2 字节网络字节序) | payload |
+ *   +------------------------+---------+
+ * 每种类型注册一个处理函数，未注册的类型交给默认处理函数。
+ * 处理函数收到的 payload 同样直接指向输入缓冲区
+ *
+ * 用法：
+ *   MessageDispatcher dispatcher(onUnknown);
+ *   dispatcher.registerHandler(kLogin, onLogin);
+ *   LengthHeaderCodec codec(std::bind(&MessageDispatcher::onFrame, &dispatcher, _1, _2, _3));
+ *   ...
+ *   buf.append(payload);
+ *   MessageDispatcher::encode(kLogin, &buf);
+ *   codec.send(conn, &buf);
+ */
+class MessageDispatcher : noncopyable {
+ public:
+  using Handler = LengthHeaderCodec::FrameCallback;
+
+  explicit MessageDispatcher(const Handler& defaultHandler)
+      : defaultHandler_(defaultHandler) {}
+
+  // 注册 type 类型消息的处理函数，应该在收到消息之前调用
+  void registerHandler(uint16_t type, const Handler& handler) {
+    handlers_[type] = handler;
+  }
+
+  // 作为 LengthHeaderCodec 的 FrameCallback，取出类型后分发 payload
+  void onFrame(const TcpConnectionPtr& conn, std::string_view message,
+               Timestamp receiveTime);
+
+  // 在 buf 前写入消息类型
+  static void encode(uint16_t type, Buffer* buf);
+
+ private:
+  std::unordered_map<uint16_t, Handler> handlers_;
+  Handler defaultHandler_;  // 未注册的类型和不完整的消息
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -0,0 +1,136 @@
+#include "PerfCounters.h"
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../base/logging/Logging.h"
+
+using namespace jmuduo;
+
+namespace {
+
+struct CounterConfig {
+  uint32_t type;
+  uint64_t config;
+  const char* name;
+};
+
+const CounterConfig kConfigs[PerfCounters::kNumCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache_misses"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch_misses"},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task_clock"},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context_switches"},
+};
+
+// 打开调用线程（pid = 0）在任意 CPU（cpu = -1）上的计数器，失败时返回 -1。
+// 没有权限统计内核态事件时只统计用户态，userOnly 设为 true
+int openCounter(const CounterConfig& c, bool* userOnly) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = c.type;
+  attr.config = c.config;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  int fd = static_cast<int>(
+      ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+  *userOnly = false;
+  if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+    attr.exclude_kernel = 1;
+    fd = static_cast<int>(
+        ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    *userOnly = fd >= 0;
+  }
+  if (fd < 0) {
+    LOG_DEBUG << "perf_event_open " << c.name << " failed: " << strerror(errno);
+  }
+  return fd;
+}
+
+int64_t toNanos(const struct timeval& tv) {
+  return static_cast<int64_t>(tv.tv_sec) * 1000 * 1000 * 1000 +
+         static_cast<int64_t>(tv.tv_usec) * 1000;
+}
+
+double ratio(uint64_t a, uint64_t b) { return b == 0 ? 0 : double(a) / b; }
+
+}  // namespace
+
+const char* PerfCounters::counterName(Counter counter) {
+  return counter >= 0 && counter < kNumCounters ? kConfigs[counter].name
+                                                : "unknown";
+}
+
+double PerfCounters::Snapshot::ipc() const {
+  return ratio(values[kInstructions], values[kCycles]);
+}
+
+double PerfCounters::Snapshot::cacheMissesPerKiloInstructions() const {
+  return ratio(values[kCacheMisses], values[kInstructions]) * 1000;
+}
+
+double PerfCounters::Snapshot::branchMissesPerKiloInstructions() const {
+  return ratio(values[kBranchMisses], values[kInstructions]) * 1000;
+}
+
+double PerfCounters::Snapshot::systemRatio() const {
+  return ratio(systemNanos, userNanos + systemNanos);
+}
+
+PerfCounters::PerfCounters()
+    : userNanos_(0), systemNanos_(0), samples_(0) {
+  for (int i = 0; i < kNumCounters; ++i) {
+    fds_[i] = openCounter(kConfigs[i], &userOnly_[i]);
+    values_[i] = 0;
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_)
+    if (fd >= 0) ::close(fd);
+}
+
+bool PerfCounters::valid() const {
+  for (int fd : fds_)
+    if (fd >= 0) return true;
+  return false;
+}
+
+void PerfCounters::sample() {
+  for (int i = 0; i < kNumCounters; ++i) {
+    if (fds_[i] < 0) continue;
+    uint64_t data[3];  // value, time_enabled, time_running
+    if (::read(fds_[i], data, sizeof data) != sizeof data) continue;
+    uint64_t value = data[0];
+    // 计数器被轮换使用时按计数的时间比例换算
+    if (data[2] > 0 && data[2] < data[1])
+      value = static_cast<uint64_t>(double(value) * data[1] / data[2]);
+    values_[i].store(value, std::memory_order_relaxed);
+  }
+  struct rusage usage;
+  if (::getrusage(RUSAGE_THREAD, &usage) == 0) {
+    userNanos_.store(toNanos(usage.ru_utime), std::memory_order_relaxed);
+    systemNanos_.store(toNanos(usage.ru_stime), std::memory_order_relaxed);
+  }
+  samples_.fetch_add(1, std::memory_order_release);
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot() const {
+  Snapshot s;
+  s.samples = samples_.load(std::memory_order_acquire);
+  for (int i = 0; i < kNumCounters; ++i) {
+    s.available[i] = fds_[i] >= 0;
+    s.userOnly[i] = userOnly_[i];
+    s.values[i] = values_[i].load(std::memory_order_relaxed);
+  }
+  s.userNanos = userNanos_.load(std::memory_order_relaxed);
+  s.systemNanos = systemNanos_.load(std::memory_order_relaxed);
+  return s;
+}
@@ -0,0 +1,79 @@
+#ifndef _JMUDUO_PERF_COUNTERS_H_
+#define _JMUDUO_PERF_COUNTERS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 一个线程的硬件/软件性能计数器（perf_event_open），由 EventLoop::enablePerfCounters
+ * 在事件循环所在的 IO 线程中创建，只统计这个线程
+ *
+ * 1. 计数器由内核累加，IO 线程在事件循环的两轮之间（每隔一段时间）读取一次并保存到原子变量中，
+ *    任意线程可以随时调用 snapshot 读取最近一次的结果，不加锁、不访问计数器
+ * 2. 除了 perf 计数器，同时读取线程的用户态/内核态 CPU 时间（getrusage），
+ *    IPC 低、cache miss 多说明是访存瓶颈，内核态时间占比高说明是系统调用瓶颈
+ * 3. 各计数器分别打开，不可用的计数器（没有权限、虚拟机中没有 PMU、内核不支持）只标记为
+ *    不可用，其余的照常工作；全都不可用时 valid() 为 false，仍然可以读取 CPU 时间。
+ *    硬件计数器数量不足被内核轮换使用时，按实际计数的时间比例换算
+ * 4. 先打开包括内核态事件的计数器；perf_event_paranoid >= 2（多数发行版的默认值）时
+ *    非特权进程没有权限，退而只统计用户态，由 Snapshot::userOnly 标明
+ */
+class PerfCounters : noncopyable {
+ public:
+  enum Counter {
+    kCycles,           // CPU 周期
+    kInstructions,     // 完成的指令数
+    kCacheMisses,      // 最后一级缓存未命中
+    kBranchMisses,     // 分支预测失败
+    kTaskClock,        // 线程占用 CPU 的时间，纳秒（软件计数器）
+    kContextSwitches,  // 上下文切换次数（软件计数器）
+    kNumCounters
+  };
+  static const char* counterName(Counter counter);
+
+  struct Snapshot {
+    uint64_t values[kNumCounters] = {};
+    bool available[kNumCounters] = {};
+    bool userOnly[kNumCounters] = {};  // 只统计了用户态的事件（exclude_kernel）
+    int64_t userNanos = 0;    // 用户态 CPU 时间
+    int64_t systemNanos = 0;  // 内核态 CPU 时间
+    uint64_t samples = 0;     // 读取的次数，为 0 时以上都没有意义
+
+    // 每周期指令数，硬件计数器不可用时为 0
+    double ipc() const;
+    // 每千条指令的未命中次数，硬件计数器不可用时为 0
+    double cacheMissesPerKiloInstructions() const;
+    double branchMissesPerKiloInstructions() const;
+    // 内核态时间占 CPU 时间的比例
+    double systemRatio() const;
+  };
+
+  // 打开调用线程的计数器
+  PerfCounters();
+  ~PerfCounters();
+
+  // 是否至少有一个 perf 计数器可用
+  bool valid() const;
+
+  // 读取计数器，只能在创建它的线程中调用
+  void sample();
+  // 最近一次 sample 的结果，可以在任意线程中调用
+  Snapshot snapshot() const;
+
+ private:
+  int fds_[kNumCounters];
+  bool userOnly_[kNumCounters];
+  std::atomic<uint64_t> values_[kNumCounters];
+  std::atomic<int64_t> userNanos_;
+  std::atomic<int64_t> systemNanos_;
+  std::atomic<uint64_t> samples_;
+};
+
+}  // namespace jmuduo
+
+#endif
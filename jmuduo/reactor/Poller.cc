@@ -78,6 +78,7 @@ void Poller::updateChannel(Channel* channel) {
     assert(idx >= 0 && idx < static_cast<int>(channels_.size()));
     struct pollfd& pollfd = pollfds_[idx];
     assert(pollfd.fd == channel->fd() || pollfd.fd == -channel->fd()-1);
+    pollfd.fd = channel->fd(); // 之前可能被设成了负数，重新监听事件时要恢复
     pollfd.events = static_cast<short>(channel->events());
     pollfd.revents = 0;
     // 若该 channel 此时不监听任何事件，将 fd 设成负数表示忽略这个 pollfd
@@ -96,9 +97,11 @@ void Poller::removeChannel(Channel* channel) {
   assert(0 <= idx && idx < static_cast<int>(pollfds_.size()));
   const struct pollfd& pfd = pollfds_[idx]; // 待删除的 pollfd
   assert(pfd.fd == -channel->fd()-1 && pfd.events == channel->events());
+  (void)pfd;
   // 从 map 中移除
   size_t n = channels_.erase(channel->fd());
   assert(n == 1);
+  (void)n;
   // 从 pollfds_ 中移除
   if (static_cast<size_t>(idx) == pollfds_.size() - 1) {
     // 最后一个，可以直接删除
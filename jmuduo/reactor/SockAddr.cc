@@ -0,0 +1,123 @@
+#include "SockAddr.h"
+
+#include <assert.h>
+#include <stddef.h>  // offsetof
+#include <string.h>
+
+#include <algorithm>
+
+#include "SocketsOps.h"
+
+using namespace jmuduo;
+
+// sockaddr_un 中 sun_path 之前的长度，Unix 域地址的长度是它加上路径的长度
+static const socklen_t kUnixPathOffset = offsetof(struct sockaddr_un, sun_path);
+
+SockAddr::SockAddr(uint16_t port, bool ipv6) : addr_() {
+  if (ipv6) {
+    addr_.in6.sin6_family = AF_INET6;
+    addr_.in6.sin6_addr = in6addr_any;
+    addr_.in6.sin6_port = sockets::hostToNetwork16(port);
+    len_ = sizeof addr_.in6;
+  } else {
+    // INADDR_ANY 指定地址为 0.0.0.0 的地址，事实上表示不确定地址，或“任意地址”
+    addr_.in.sin_family = AF_INET;
+    addr_.in.sin_addr.s_addr = sockets::hostToNetwork32(INADDR_ANY);
+    addr_.in.sin_port = sockets::hostToNetwork16(port);
+    len_ = sizeof addr_.in;
+  }
+}
+
+SockAddr::SockAddr(const std::string& ip, uint16_t port) : addr_() {
+  if (ip.find(':') != std::string::npos) {
+    sockets::fromHostPort(ip.c_str(), port, &addr_.in6);
+    len_ = sizeof addr_.in6;
+  } else {
+    sockets::fromHostPort(ip.c_str(), port, &addr_.in);
+    len_ = sizeof addr_.in;
+  }
+}
+
+SockAddr::SockAddr(const struct sockaddr_in& addr)
+    : addr_(), len_(sizeof addr) {
+  addr_.in = addr;
+}
+
+SockAddr::SockAddr(const struct sockaddr_in6& addr)
+    : addr_(), len_(sizeof addr) {
+  addr_.in6 = addr;
+}
+
+SockAddr::SockAddr(const struct sockaddr* addr, socklen_t len) : addr_() {
+  assert(len <= sizeof addr_);
+  len_ = len < sizeof addr_ ? len : sizeof addr_;
+  ::memcpy(&addr_, addr, len_);
+}
+
+SockAddr SockAddr::unixPath(const std::string& path) {
+  SockAddr addr;
+  // 路径要以 '\0' 结尾
+  assert(path.size() < sizeof addr.addr_.un.sun_path);
+  size_t n = std::min(path.size(), sizeof addr.addr_.un.sun_path - 1);
+  addr.addr_.un.sun_family = AF_UNIX;
+  ::memcpy(addr.addr_.un.sun_path, path.data(), n);
+  addr.len_ = static_cast<socklen_t>(kUnixPathOffset + n + 1);
+  return addr;
+}
+
+SockAddr SockAddr::unixAbstract(const std::string& name) {
+  SockAddr addr;
+  // 抽象地址以 '\0' 开头，之后的 len_ 范围内的字节都是名字，不需要以 '\0' 结尾
+  assert(name.size() < sizeof addr.addr_.un.sun_path);
+  size_t n = std::min(name.size(), sizeof addr.addr_.un.sun_path - 1);
+  addr.addr_.un.sun_family = AF_UNIX;
+  addr.addr_.un.sun_path[0] = '\0';
+  ::memcpy(addr.addr_.un.sun_path + 1, name.data(), n);
+  addr.len_ = static_cast<socklen_t>(kUnixPathOffset + 1 + n);
+  return addr;
+}
+
+bool SockAddr::isAbstract() const {
+  return isUnix() && len_ > kUnixPathOffset && addr_.un.sun_path[0] == '\0';
+}
+
+uint16_t SockAddr::port() const {
+  switch (family()) {
+    case AF_INET:
+      return sockets::networkToHost16(addr_.in.sin_port);
+    case AF_INET6:
+      return sockets::networkToHost16(addr_.in6.sin6_port);
+    default:
+      return 0;
+  }
+}
+
+std::string SockAddr::unixName() const {
+  // accept 返回的客户端地址通常是未命名的，只有 sun_family
+  if (!isUnix() || len_ <= kUnixPathOffset) return std::string();
+  const char* path = addr_.un.sun_path;
+  size_t n = len_ - kUnixPathOffset;
+  if (path[0] == '\0') return std::string(path + 1, n - 1);
+  return std::string(path, ::strnlen(path, n));
+}
+
+std::string SockAddr::toHostPort() const {
+  char buf[sizeof(addr_.un.sun_path) + 16];
+  sockets::toHostPort(buf, sizeof buf, getSockAddr(), len_);
+  return buf;
+}
+
+bool SockAddr::operator==(const SockAddr& rhs) const {
+  if (family() != rhs.family()) return false;
+  switch (family()) {
+    case AF_INET:
+      return addr_.in.sin_port == rhs.addr_.in.sin_port &&
+             addr_.in.sin_addr.s_addr == rhs.addr_.in.sin_addr.s_addr;
+    case AF_INET6:
+      return addr_.in6.sin6_port == rhs.addr_.in6.sin6_port &&
+             ::memcmp(&addr_.in6.sin6_addr, &rhs.addr_.in6.sin6_addr,
+                      sizeof addr_.in6.sin6_addr) == 0;
+    default:
+      return len_ == rhs.len_ && ::memcmp(&addr_, &rhs.addr_, len_) == 0;
+  }
+}
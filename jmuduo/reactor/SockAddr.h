@@ -0,0 +1,86 @@
+#ifndef _JMUDUO_SOCKADDR_H_
+#define _JMUDUO_SOCKADDR_H_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <string>
+
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * 通用的 socket 地址，可以是 IPv4、IPv6 或者 Unix 域（AF_UNIX）地址：
+ *
+ *   SockAddr(9981)                          // 0.0.0.0:9981
+ *   SockAddr(9981, true)                    // [::]:9981
+ *   SockAddr("::1", 9981)                   // ip 中有 ':' 时为 IPv6
+ *   SockAddr::unixPath("/tmp/echo.sock")    // 文件系统中的 Unix 域 socket
+ *   SockAddr::unixAbstract("echo")          // Linux 的抽象命名空间，不在文件系统中创建文件
+ *
+ * 同一台机器上的进程间通信（如 sidecar）使用 Unix 域 socket 不经过 TCP/IP 协议栈，
+ * 没有校验和、分段、确认和拥塞控制，吞吐更高、延迟更低。
+ * 地址以 sockaddr 的联合体存储，socket API 使用 getSockAddr() 和 length()
+ */
+class SockAddr : copyable {
+ public:
+  // 任意地址:port，ipv6 为 true 时为 [::]:port
+  explicit SockAddr(uint16_t port, bool ipv6 = false);
+  // ip:port，ip 是点分十进制的 IPv4 地址或者 IPv6 地址
+  SockAddr(const std::string& ip, uint16_t port);
+
+  SockAddr(const struct sockaddr_in& addr);
+  SockAddr(const struct sockaddr_in6& addr);
+  // 由 accept/getsockname/recvmsg 等返回的地址构造，len 为其返回的地址长度
+  SockAddr(const struct sockaddr* addr, socklen_t len);
+
+  // 文件系统中的 Unix 域 socket 地址
+  static SockAddr unixPath(const std::string& path);
+  // 抽象命名空间中的 Unix 域 socket 地址，name 不包括开头的 '\0'
+  static SockAddr unixAbstract(const std::string& name);
+
+  sa_family_t family() const { return addr_.sa.sa_family; }
+  bool isUnix() const { return family() == AF_UNIX; }
+  // 是否是抽象命名空间中的 Unix 域地址
+  bool isAbstract() const;
+  // 端口号（本地字节序），Unix 域地址返回 0
+  uint16_t port() const;
+  // Unix 域 socket 的路径或者抽象名字，其他地址返回空字符串
+  std::string unixName() const;
+
+  /**
+   * @brief 以可读的形式返回地址：IPv4 为 "ip:port"，IPv6 为 "[ip]:port"，
+   * Unix 域为 "unix:path" 或者 "unix:@name"（抽象命名空间），未命名的为 "unix:"
+   */
+  std::string toHostPort() const;
+
+  const struct sockaddr* getSockAddr() const { return &addr_.sa; }
+  // 供 accept/getsockname 等填写地址，之后要用 setLength 设置其返回的长度
+  struct sockaddr* getMutableSockAddr() { return &addr_.sa; }
+  socklen_t length() const { return len_; }
+  void setLength(socklen_t len) { len_ = len; }
+  // 可以存放的最大地址长度
+  static socklen_t capacity() { return sizeof(Storage); }
+
+  bool operator==(const SockAddr& rhs) const;
+  bool operator!=(const SockAddr& rhs) const { return !(*this == rhs); }
+
+ private:
+  union Storage {
+    struct sockaddr sa;
+    struct sockaddr_in in;
+    struct sockaddr_in6 in6;
+    struct sockaddr_un un;
+  };
+
+  SockAddr() : addr_(), len_(0) {}
+
+  Storage addr_;
+  socklen_t len_;  // 地址的有效长度，Unix 域地址的长度和路径长度有关
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -1,9 +1,9 @@
 #include "Socket.h"
-#include "InetAddress.h"
+#include "SockAddr.h"
 #include "SocketsOps.h"
 #include "../base/logging/Logging.h"
 
-#include <strings.h> // bzero
+#include <errno.h>
 #include <netinet/tcp.h>
 #include <netinet/in.h>
 
@@ -13,20 +13,19 @@ Socket::~Socket() {
   sockets::close(sockfd_);  
 }
 
-void Socket::bindAddress(const InetAddress& addr) {
-  sockets::bindOrDie(sockfd_, addr.getSockAddrInet());
+void Socket::bindAddress(const SockAddr& addr) {
+  sockets::bindOrDie(sockfd_, addr.getSockAddr(), addr.length());
 }
 
 void Socket::listen() {
   sockets::listenOrDie(sockfd_);
 }
 
-int Socket::accept(InetAddress *peeraddr) {
-  struct sockaddr_in addr;
-  bzero(&addr, sizeof addr);
-  int connfd = sockets::accept(sockfd_, &addr);
-  if(connfd >= 0) {
-    peeraddr->setSockAddrInet(addr);
+int Socket::accept(SockAddr* peeraddr) {
+  socklen_t addrlen = SockAddr::capacity();
+  int connfd = sockets::accept(sockfd_, peeraddr->getMutableSockAddr(), &addrlen);
+  if (connfd >= 0) {
+    peeraddr->setLength(addrlen);
   }
 
   return connfd;
@@ -45,11 +44,52 @@ void Socket::setReuseAddr(bool on) {
   }
 }
 
+void Socket::setReusePort(bool on) {
+  int optval = on ? 1 : 0;
+  int ret =
+      ::setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof optval);
+  if (ret < 0 && on) {
+    LOG_SYSFATAL << "setsockopt:SO_REUSEPORT";
+  }
+}
+
 void Socket::setTcpNoDelay(bool on) {
   int optval = on ? 1 : 0;
   int ret =
       ::setsockopt(sockfd_, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof optval);
-  if (ret < 0) {
+  if (ret < 0 && errno != EOPNOTSUPP) {
     LOG_SYSFATAL << "setsockopt:TCP_NODELAY";
   }
-}
\ No newline at end of file
+}
+
+bool Socket::setTcpCork(bool on) {
+  int optval = on ? 1 : 0;
+  int ret =
+      ::setsockopt(sockfd_, IPPROTO_TCP, TCP_CORK, &optval, sizeof optval);
+  if (ret < 0) {
+    if (errno != EOPNOTSUPP) {
+      LOG_SYSERR << "setsockopt:TCP_CORK";
+    }
+    return false;
+  }
+  return true;
+}
+
+void Socket::setTcpNotSentLowat(int bytes) {
+  int ret = ::setsockopt(sockfd_, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &bytes,
+                         sizeof bytes);
+  if (ret < 0 && errno != EOPNOTSUPP) {
+    LOG_SYSERR << "setsockopt:TCP_NOTSENT_LOWAT";
+  }
+}
+
+bool Socket::setZeroCopy(bool on) {
+  int optval = on ? 1 : 0;
+  int ret =
+      ::setsockopt(sockfd_, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof optval);
+  if (ret < 0) {
+    LOG_SYSERR << "setsockopt:SO_ZEROCOPY";
+    return false;
+  }
+  return true;
+}
@@ -5,10 +5,10 @@
 
 namespace jmuduo {
 
-class InetAddress;
+class SockAddr;
 
 /**
- * @brief RAII handle，封装 TCP socket fd 的生命周期
+ * @brief RAII handle，封装 socket fd（TCP、Unix 域或 UDP）的生命周期
  */
 class Socket : noncopyable {
  public:
@@ -19,7 +19,7 @@ class Socket : noncopyable {
   int fd() const { return sockfd_; }
 
   // 地址 localaddr 已使用时 abort
-  void bindAddress(const InetAddress& localaddr);
+  void bindAddress(const SockAddr& localaddr);
   // 地址 localaddr 已使用时 abort
   void listen();
 
@@ -30,7 +30,7 @@ class Socket : noncopyable {
    * @return 成功时返回消息 sockfd（non-blocking and close-on-exec），
    * 并设置 peeraddr；失败时返回 -1
    */
-  int accept(InetAddress* peeraddr);
+  int accept(SockAddr* peeraddr);
 
   // 关闭 socket 的写入端
   void shutdownWrite();
@@ -38,9 +38,23 @@ class Socket : noncopyable {
   // 设置是否复用本地地址 SO_REUSEADDR
   void setReuseAddr(bool on);
 
-  // 设置 TCP_NODELAY（Nagle 算法）
+  // 设置是否复用本地端口 SO_REUSEPORT，多个 socket 可以绑定同一个端口，
+  // 由内核在它们之间分配连接（TCP）或数据报（UDP）
+  void setReusePort(bool on);
+
+  // 设置 TCP_NODELAY（Nagle 算法），Unix 域 socket 没有这个选项，忽略
   void setTcpNoDelay(bool on);
 
+  // 设置 TCP_CORK，打开时内核只发送满 MSS 的报文段，关闭时立即发出剩余的数据。
+  // 不支持（如 Unix 域 socket）时返回 false
+  bool setTcpCork(bool on);
+
+  // 设置 TCP_NOTSENT_LOWAT，内核发送队列中未发送的数据少于 bytes 时 socket 才可写
+  void setTcpNotSentLowat(int bytes);
+
+  // 设置 SO_ZEROCOPY，之后可以使用 MSG_ZEROCOPY 发送，不支持时返回 false
+  bool setZeroCopy(bool on);
+
  private:
   const int sockfd_;  // listening socket
 };
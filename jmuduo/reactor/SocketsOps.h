@@ -3,9 +3,12 @@
 
 #include <arpa/inet.h>
 #include <endian.h>
+#include <sys/socket.h>
 
 namespace jmuduo {
 
+class SockAddr;
+
 namespace sockets { // 包装 os 提供的 socket 基本操作
 
 /* 本地字节序 与 网络字节序 的相互转换 */
@@ -22,16 +25,26 @@ inline uint32_t networkToHost32(uint32_t net32) { return ntohl(net32); }
 
 inline uint16_t networkToHost16(uint16_t net16) { return ntohs(net16); }
 
-/* socket 基本操作 */
+/* socket 基本操作
+ * 地址都以通用的 sockaddr 和长度传递，同时支持 IPv4、IPv6 和 Unix 域 socket */
 
-// 创建一个非阻塞的 socket fd，失败时直接 abort
-int createNonblockingOrDie();
+// 创建一个非阻塞的流式 socket fd，family 为 AF_INET/AF_INET6 时是 TCP，
+// AF_UNIX 时是 Unix 域 socket，失败时直接 abort
+int createNonblockingOrDie(sa_family_t family = AF_INET);
+// 创建一个非阻塞的 UDP socket fd，失败时直接 abort
+int createUdpNonblockingOrDie(sa_family_t family = AF_INET);
 // 绑定 sockfd 与本地地址 addr
-void bindOrDie(int sockfd, const struct sockaddr_in& addr);
+void bindOrDie(int sockfd, const struct sockaddr* addr, socklen_t addrlen);
 // 开始监听
 void listenOrDie(int sockfd);
-// 接受 sockfd 上的连接，返回一个代表新连接的 socket，新 socket 的远端地址为 addr
-int accept(int sockfd, struct sockaddr_in* addr);
+/**
+ * @brief 接受 sockfd 上的连接，返回一个代表新连接的 socket（non-blocking and
+ * close-on-exec），失败时返回 -1。
+ * 新 socket 的远端地址存放在 addr 中，*addrlen 传入 addr 的大小，返回地址的长度
+ */
+int accept(int sockfd, struct sockaddr* addr, socklen_t* addrlen);
+// 向 addr 发起连接，非阻塞的 sockfd 通常返回 -1 且 errno 为 EINPROGRESS
+int connect(int sockfd, const struct sockaddr* addr, socklen_t addrlen);
 // 关闭 socket 连接
 void close(int sockfd);
 // 关闭 socket 连接的写入端，此时 socket 只能读出不能写入
@@ -39,15 +52,21 @@ void shutdownWrite(int sockfd);
 
 /* 地址转换 */
 
-// 解析远端地址 addr（网络字节序），以 "ip:port" 的形式存储在 buf 中
-void toHostPort(char* buf, size_t bufSize, const struct sockaddr_in& addr);
+// 以 "ip:port"、"[ip]:port" 或 "unix:path" 的形式把地址 addr 存储在 buf 中
+void toHostPort(char* buf, size_t bufSize, const struct sockaddr* addr,
+                socklen_t addrlen);
 // 将 ip port 拼接成将要使用的远端地址（网络字节序）
 void fromHostPort(const char* ip, uint16_t port, struct sockaddr_in* addr);
+void fromHostPort(const char* ip, uint16_t port, struct sockaddr_in6* addr);
 
 /* 获取 socket 的相关信息 */
 
 // 获取 sockfd 绑定的地址
-struct sockaddr_in getLocalAddr(int sockfd);
+SockAddr getLocalAddr(int sockfd);
+// 获取 sockfd 连接的远端地址
+SockAddr getPeerAddr(int sockfd);
+// 判断是否发生了自连接，即本地地址和远端地址相同，Unix 域 socket 不会发生自连接
+bool isSelfConnect(int sockfd);
 // 获取 sockfd 发生的错误
 int getSocketError(int sockfd);
 
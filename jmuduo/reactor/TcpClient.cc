@@ -0,0 +1,120 @@
+#include "TcpClient.h"
+
+#include <assert.h>
+
+#include "../base/logging/Logging.h"
+#include "EventLoop.h"
+#include "SocketsOps.h"
+
+using namespace jmuduo;
+using namespace std::placeholders;
+
+namespace jmuduo {
+namespace detail {
+
+// TcpClient 析构后，连接断开时的回调
+void removeConnection(EventLoop* loop, const TcpConnectionPtr& conn) {
+  loop->queueInLoop(std::bind(&TcpConnection::connectDestroyed, conn));
+}
+
+}  // namespace detail
+}  // namespace jmuduo
+
+TcpClient::TcpClient(EventLoop* loop, const InetAddress& serverAddr,
+                     const std::string& name)
+    : loop_(loop),
+      connector_(new Connector(loop, serverAddr)),
+      name_(name),
+      retry_(false),
+      connect_(true),
+      nextConnId_(1) {
+  connector_->setNewConnectionCallback(
+      std::bind(&TcpClient::newConnection, this, _1));
+  LOG_INFO << "TcpClient::TcpClient[" << name_ << "] - connector "
+           << connector_.get();
+}
+
+TcpClient::~TcpClient() {
+  LOG_INFO << "TcpClient::~TcpClient[" << name_ << "] - connector "
+           << connector_.get();
+  TcpConnectionPtr conn;
+  bool unique = false;
+  {
+    MutexLockGuard lock(mutex_);
+    unique = connection_.use_count() == 1;
+    conn = connection_;
+  }
+  if (conn) {
+    assert(loop_ == conn->getLoop());
+    // 连接可能比 TcpClient 活得久，断开时不能再回调 TcpClient::removeConnection
+    // FIXME: not 100% safe, if we are in different thread
+    loop_->runInLoop([loop = loop_, conn] {
+      conn->setCloseCallback(std::bind(&detail::removeConnection, loop, _1));
+    });
+    // 只有 TcpClient 持有连接时，强制关闭连接，否则由用户决定连接的生命期
+    if (unique) conn->forceClose();
+  } else {
+    connector_->stop();
+  }
+}
+
+void TcpClient::connect() {
+  LOG_INFO << "TcpClient::connect[" << name_ << "] - connecting to "
+           << connector_->serverAddress().toHostPort();
+  connect_ = true;
+  connector_->start();
+}
+
+void TcpClient::disconnect() {
+  connect_ = false;
+  {
+    MutexLockGuard lock(mutex_);
+    if (connection_) connection_->shutdown();
+  }
+}
+
+void TcpClient::stop() {
+  connect_ = false;
+  connector_->stop();
+}
+
+void TcpClient::newConnection(int sockfd) {
+  loop_->assertInLoopThread();
+  InetAddress peerAddr(sockets::getPeerAddr(sockfd));
+  // IPv6 地址和 Unix 域套接字路径可能很长，不能用定长的缓冲区
+  std::string connName =
+      name_ + ":" + peerAddr.toHostPort() + "#" + std::to_string(nextConnId_);
+  ++nextConnId_;
+
+  InetAddress localAddr(sockets::getLocalAddr(sockfd));
+  auto conn = std::make_shared<TcpConnection>(loop_, connName, sockfd,
+                                              localAddr, peerAddr);
+  conn->setConnectionCallback(connectionCallback_);
+  conn->setMessageCallback(messageCallback_);
+  conn->setWriteCompleteCallback(writeCompleteCallback_);
+  // FIXME: unsafe 连接断开时 TcpClient 可能已经被销毁，见析构函数
+  conn->setCloseCallback(std::bind(&TcpClient::removeConnection, this, _1));
+  {
+    MutexLockGuard lock(mutex_);
+    connection_ = conn;
+  }
+  // 连接和 TcpClient 属于同一个事件循环，直接建立连接
+  conn->connectEstablished();
+}
+
+void TcpClient::removeConnection(const TcpConnectionPtr& conn) {
+  loop_->assertInLoopThread();
+  assert(loop_ == conn->getLoop());
+  {
+    MutexLockGuard lock(mutex_);
+    assert(connection_ == conn);
+    connection_.reset();
+  }
+  // 同 TcpServer::removeConnectionInLoop，延长连接的生命期到下一次事件循环
+  loop_->queueInLoop(std::bind(&TcpConnection::connectDestroyed, conn));
+  if (retry_ && connect_) {
+    LOG_INFO << "TcpClient::removeConnection[" << name_ << "] - Reconnecting to "
+             << connector_->serverAddress().toHostPort();
+    connector_->restart();
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef _JMUDUO_TCP_CLIENT_H_
+#define _JMUDUO_TCP_CLIENT_H_
+
+#include <string>
+
+#include "../base/thread/Mutex.h"
+#include "Callbacks.h"
+#include "Connector.h"
+#include "TcpConnection.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * 用户直接使用的 TCP 客户端接口，每个 TcpClient 只管理一个 TcpConnection
+ * 1. 使用 Connector 发起非阻塞连接，连接失败时按指数退避重试
+ * 2. 连接建立后创建 TcpConnection，之后的收发和 TcpServer 的连接完全相同
+ * 3. enableRetry 后，已建立的连接断开时会自动重新连接
+ * TcpClient 和其管理的连接都属于 loop_，connect/disconnect/stop 可以在任意线程调用
+ *
+ * 用法：
+ *   TcpClient client(&loop, serverAddr, "client");
+ *   client.setConnectionCallback(onConnection);
+ *   client.setMessageCallback(onMessage);
+ *   client.enableRetry();
+ *   client.connect();
+ */
+class TcpClient : noncopyable {
+ public:
+  TcpClient(EventLoop* loop, const InetAddress& serverAddr,
+            const std::string& name);
+  // 析构时如果连接还存在，会强制关闭连接
+  ~TcpClient();
+
+  // 发起连接
+  void connect();
+  // 主动断开已建立的连接（关闭写端），不会触发重连
+  void disconnect();
+  // 停止正在进行的连接和重试
+  void stop();
+
+  // 当前的连接，可能为空
+  TcpConnectionPtr connection() const {
+    MutexLockGuard lock(mutex_);
+    return connection_;
+  }
+
+  EventLoop* getLoop() const { return loop_; }
+  const std::string& name() const { return name_; }
+  bool retry() const { return retry_; }
+  // 已建立的连接断开后自动重连
+  void enableRetry() { retry_ = true; }
+
+  // 设置用户回调，不是线程安全的，应该在 connect 之前设置
+  void setConnectionCallback(const ConnectionCallback& cb) {
+    connectionCallback_ = cb;
+  }
+  void setMessageCallback(const MessageCallback& cb) { messageCallback_ = cb; }
+  void setWriteCompleteCallback(const WriteCompleteCallback& cb) {
+    writeCompleteCallback_ = cb;
+  }
+
+ private:
+  // 在 loop_ 中运行，Connector 连接成功后回调，创建 TcpConnection
+  void newConnection(int sockfd);
+  // 在 loop_ 中运行，TcpConnection 断开时回调
+  void removeConnection(const TcpConnectionPtr& conn);
+
+  EventLoop* loop_;            // 连接所属的事件循环
+  ConnectorPtr connector_;     // 发起连接的帮助对象
+  const std::string name_;
+  ConnectionCallback connectionCallback_;
+  MessageCallback messageCallback_;
+  WriteCompleteCallback writeCompleteCallback_;
+  bool retry_;    // FIXME: use atomic variable 连接断开后是否重连
+  bool connect_;  // FIXME: use atomic variable 是否需要连接
+  int nextConnId_;  // 下一个连接的编号，单调递增，只在 loop_ 中使用
+  mutable MutexLock mutex_;
+  TcpConnectionPtr connection_;  // @GuardedBy mutex_
+};
+
+}  // namespace jmuduo
+
+#endif
@@ -1,5 +1,6 @@
 #include "TcpConnection.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "../base/logging/Logging.h"
@@ -8,8 +9,11 @@
 #include "Socket.h"
 #include "SocketsOps.h"
 
-#include <unistd.h>
 #include <errno.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace jmuduo;
 
@@ -22,11 +26,29 @@ TcpConnection::TcpConnection(EventLoop* loop, const std::string& name,
       socket_(new Socket(sockfd)),
       channel_(new Channel(loop, sockfd)),
       localAddr_(localAddr),
-      peerAddr_(peerAddr) {
+      peerAddr_(peerAddr),
+      highWaterMark_(64 * 1024 * 1024),
+      readAwaiter_(nullptr),
+      writeAwaiter_(nullptr),
+      deferredFlush_(false),
+      flushScheduled_(false),
+      corked_(false),
+      reading_(true),
+      flowHighWaterMark_(0),
+      flowLowWaterMark_(0),
+      sourcePaused_(false),
+      readThrottled_(false),
+      writeThrottled_(false),
+      zeroCopyThreshold_(0),
+      zeroCopySeq_(0),
+      zeroCopyCompleted_(0),
+      zeroCopySends_(0),
+      zeroCopyCopied_(0) {
   LOG_DEBUG << "TcpConnection::constructor[" << name_ << "] at" << this
             << " fd=" << sockfd;
   // channel_ 是 TcpConnection 的成员，所以 channel_ 执行 TcpConnection 注册的回调时
   // TcpConnection 必存在，所以不需要 shared_from_this
+  channel_->setKind(Channel::kConnection);
   // 注册消息回调          
   channel_->setReadCallback(std::bind(&TcpConnection::handleRead, this, std::placeholders::_1));
   channel_->setWriteCallback(std::bind(&TcpConnection::handleWrite, this));
@@ -45,7 +67,54 @@ void TcpConnection::send(const std::string& message) {
       sendInLoop(message);
     } else { // 在其他线程，转移到IO线程执行
       // P209 P318 跨线程的函数转移调用涉及函数参数的跨线程传递，最简单的方法就是把数据拷贝一份
-      loop_->runInLoop(std::bind(&TcpConnection::sendInLoop, this, message));
+      loop_->runInLoop([this, message] { sendInLoop(message); });
+    }
+  }
+}
+
+void TcpConnection::send(const void* data, size_t len) {
+  if (state_ == kConnected) {
+    if (loop_->isInLoopThread()) {
+      sendInLoop(data, len);
+    } else {
+      std::string message(static_cast<const char*>(data), len);
+      loop_->runInLoop(
+          [this, message = std::move(message)] { sendInLoop(message); });
+    }
+  }
+}
+
+void TcpConnection::send(Buffer* buf) {
+  if (state_ == kConnected) {
+    if (loop_->isInLoopThread() && canZeroCopy(buf->readableBytes())) {
+      // 交换出 buf 的内存，连接持有它直到发送完成
+      auto owner = std::make_shared<Buffer>();
+      owner->swap(*buf);
+      const char* data = owner->peek();
+      size_t len = owner->readableBytes();
+      sendZeroCopyInLoop(std::move(owner), data, len);
+    } else if (loop_->isInLoopThread()) {
+      // 直接发送 buf 中的数据，不经过中间的 string
+      sendInLoop(buf->peek(), buf->readableBytes());
+      buf->retrieveAll();
+    } else {
+      loop_->runInLoop([this, message = buf->retrieveAsString()] {
+        sendInLoop(message);
+      });
+    }
+  }
+}
+
+void TcpConnection::send(const std::shared_ptr<const std::string>& data) {
+  if (state_ == kConnected) {
+    if (loop_->isInLoopThread()) {
+      if (canZeroCopy(data->size()))
+        sendZeroCopyInLoop(data, data->data(), data->size());
+      else
+        sendInLoop(data->data(), data->size());
+    } else {
+      // 数据是共享的，跨线程时也不需要拷贝
+      loop_->runInLoop([this, data] { send(data); });
     }
   }
 }
@@ -56,17 +125,25 @@ void TcpConnection::send(const std::string& message) {
  *    - 如果直接发送只发送了部分数据，则将剩余数据放入输出缓冲区
  * 2. 如果当前输出缓冲区中有数据，为了保证数据的顺序性，应该将数据放入输出缓冲区
  * 输出缓冲区中有数据时，开始关注可写事件，并在 handleWrite 中发送输出缓冲区中的数据
+ * 延迟写模式下不直接发送，数据都放入输出缓冲区，由 flushDeferred 在本轮事件循环的最后发送
  */
 void TcpConnection::sendInLoop(const std::string& message) {
+  sendInLoop(message.data(), message.size());
+}
+
+void TcpConnection::sendInLoop(const void* data, size_t len) {
   loop_->assertInLoopThread();
   ssize_t nwrote = 0;
   // 如果当前输出缓冲区中没有数据，则可以尝试直接发送
-  if (!channel_->isWriting() && outputBuffer_.readableBytes() == 0) {
+  if (!deferredFlush_ && !writePending() &&
+      outputBuffer_.readableBytes() == 0 && !zeroCopySending()) {
     // 没有反复 write 直到返回 EAGAIN，照顾连接公平性，防止有大量数据写出的连接一直占用
-    nwrote = ::write(socket_->fd(), message.c_str(), message.size());
+    size_t quota = writeQuota(len);
+    nwrote = quota > 0 ? ::write(socket_->fd(), data, quota) : 0;
+    if (nwrote > 0) wroteBytes(nwrote);
     if (nwrote >= 0) {  // 写入成功
       // 数据没有完全写入
-      if (static_cast<size_t>(nwrote) < message.size()) {
+      if (static_cast<size_t>(nwrote) < len) {
         LOG_TRACE << "I am going to write more data";
       } else if (writeCompleteCallback_) { // 数据全部写出了，执行回调
         loop_->queueInLoop(
@@ -81,8 +158,8 @@ void TcpConnection::sendInLoop(const std::string& message) {
   }
   assert(nwrote >= 0);
   // 数据没有完全写入 或者 一开始输出缓冲区中就有数据
-  if (static_cast<size_t>(nwrote) < message.size()) {
-    size_t remaining = message.size() - nwrote;
+  if (static_cast<size_t>(nwrote) < len) {
+    size_t remaining = len - nwrote;
     size_t oldLen = outputBuffer_.readableBytes();
     if (remaining + oldLen >= highWaterMark_ &&  // 发送缓冲区大小大于高水位
         oldLen < highWaterMark_ &&               // 只在上升沿触发一次
@@ -91,12 +168,363 @@ void TcpConnection::sendInLoop(const std::string& message) {
                                    oldLen + remaining));
     }
     // 将数据放入输出缓冲区
-    outputBuffer_.append(message.data() + nwrote, message.size() - nwrote);
-    if (!channel_->isWriting())  // 开始关注可写事件
+    outputBuffer_.append(static_cast<const char*>(data) + nwrote, remaining);
+    checkHighWaterMark();
+    if (writePending()) {
+      // 已经在关注可写事件（或者在等待限速的定时器），等待 handleWrite 发送
+    } else if (deferredFlush_) {
+      if (!flushScheduled_) {
+        flushScheduled_ = true;
+        // 持有 shared_ptr，连接可能在本轮的 functors 中被销毁
+        loop_->runBeforePoll(
+            std::bind(&TcpConnection::flushDeferred, shared_from_this()));
+      }
+    } else {  // 开始关注可写事件
+      startWriting();
+    }
+  }
+}
+
+void TcpConnection::setDeferredFlush(bool on) {
+  loop_->assertInLoopThread();
+  deferredFlush_ = on;
+}
+
+void TcpConnection::flushDeferred() {
+  loop_->assertInLoopThread();
+  flushScheduled_ = false;
+  if (state_ != kConnected && state_ != kDisconnecting) return;
+  // 关注可写事件时由 handleWrite 发送，保证数据的顺序
+  if (writePending() || outputBuffer_.readableBytes() == 0) return;
+
+  size_t quota = writeQuota(outputBuffer_.readableBytes());
+  ssize_t n = quota > 0 ? ::write(channel_->fd(), outputBuffer_.peek(), quota) : 0;
+  if (n < 0) {
+    n = 0;
+    if (errno != EWOULDBLOCK) {
+      LOG_SYSERR << "TcpConnection::flushDeferred";
+    }
+  }
+  if (n > 0) wroteBytes(n);
+  outputBuffer_.retrieve(n);
+  checkLowWaterMark();
+  if (outputBuffer_.readableBytes() == 0) {
+    if (writeCompleteCallback_) {
+      loop_->queueInLoop(std::bind(writeCompleteCallback_, shared_from_this()));
+    }
+    resumeWriter();
+    if (state_ == kDisconnecting) {
+      shutdownInLoop();
+    }
+  } else {
+    // 剩余的数据要在可写事件中分多次写出，打开 TCP_CORK 使这期间只发送满的报文段
+    setCorked(true);
+    startWriting();
+  }
+}
+
+void TcpConnection::setTcpNotSentLowat(int bytes) {
+  socket_->setTcpNotSentLowat(bytes);
+}
+
+bool TcpConnection::enableZeroCopy(size_t threshold) {
+  loop_->assertInLoopThread();
+  if (!socket_->setZeroCopy(true)) return false;
+  zeroCopyThreshold_ = threshold > 0 ? threshold : 1;
+  return true;
+}
+
+bool TcpConnection::canZeroCopy(size_t len) const {
+  // 前面有待发送的数据时，为了保证顺序只能追加到输出缓冲区
+  return zeroCopyThreshold_ > 0 && len >= zeroCopyThreshold_ &&
+         !writeBucket_.limited() && state_ == kConnected && !writePending() &&
+         outputBuffer_.readableBytes() == 0 && !zeroCopySending();
+}
+
+void TcpConnection::sendZeroCopyInLoop(std::shared_ptr<const void> owner,
+                                       const char* data, size_t len) {
+  loop_->assertInLoopThread();
+  zeroCopyBlocks_.push_back({std::move(owner), data, len, 0, 0, false});
+  ssize_t n = writeZeroCopy();
+  if (n > 0) {
+    wroteBytes(n);
+  } else if (n < 0 && errno != EWOULDBLOCK) {
+    LOG_SYSERR << "TcpConnection::sendZeroCopyInLoop";
+  }
+  if (zeroCopySending()) {
+    // 没有发送完，剩余的数据在 handleWrite 中发送
+    channel_->enableWriting();
+  } else if (writeCompleteCallback_) {
+    loop_->queueInLoop(std::bind(writeCompleteCallback_, shared_from_this()));
+  }
+}
+
+ssize_t TcpConnection::writeZeroCopy() {
+  ZeroCopyBlock& block = zeroCopyBlocks_.back();
+  const char* p = block.data + block.sent;
+  size_t len = block.len - block.sent;
+  ssize_t n = ::send(channel_->fd(), p, len, MSG_ZEROCOPY);
+  if (n >= 0) {
+    block.lastSeq = zeroCopySeq_++;
+    block.pinned = true;
+    ++zeroCopySends_;
+  } else if (errno == ENOBUFS) {
+    // 锁定的内存超过了 optmem_max 的限制，这一次退回拷贝发送
+    n = ::send(channel_->fd(), p, len, 0);
+  }
+  if (n > 0) {
+    block.sent += n;
+    // 全部退回了拷贝发送的消息可以立即释放
+    if (block.sent == block.len) releaseZeroCopyBlocks();
+  }
+  return n;
+}
+
+/**
+ * 每次成功的 MSG_ZEROCOPY 发送有一个递增的 32 位序号，完成通知是一个序号的闭区间
+ * [ee_info, ee_data]，内核会合并连续的通知。SO_EE_CODE_ZEROCOPY_COPIED 表示内核
+ * 最终还是拷贝了数据，比如发往本机（loopback）的数据在接收时必须拷贝
+ */
+bool TcpConnection::handleZeroCopyCompletions() {
+  bool notified = false;
+  while (true) {
+    char control[128];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof control;
+    if (::recvmsg(channel_->fd(), &msg, MSG_ERRQUEUE) < 0) break;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+        continue;
+      const struct sock_extended_err* err =
+          reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+      if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || err->ee_errno != 0)
+        continue;
+      uint32_t next = err->ee_data + 1;
+      if (static_cast<int32_t>(next - zeroCopyCompleted_) > 0)
+        zeroCopyCompleted_ = next;
+      if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        zeroCopyCopied_ += err->ee_data - err->ee_info + 1;
+      notified = true;
+    }
+  }
+  releaseZeroCopyBlocks();
+  return notified;
+}
+
+void TcpConnection::releaseZeroCopyBlocks() {
+  while (!zeroCopyBlocks_.empty()) {
+    const ZeroCopyBlock& block = zeroCopyBlocks_.front();
+    bool completed =
+        !block.pinned ||
+        static_cast<int32_t>(block.lastSeq - zeroCopyCompleted_) < 0;
+    if (block.sent < block.len || !completed) break;
+    zeroCopyBlocks_.pop_front();
+  }
+}
+
+void TcpConnection::stopRead() {
+  if (loop_->isInLoopThread()) {
+    stopReadInLoop();
+  } else {
+    loop_->queueInLoop(
+        std::bind(&TcpConnection::stopReadInLoop, shared_from_this()));
+  }
+}
+
+void TcpConnection::startRead() {
+  if (loop_->isInLoopThread()) {
+    startReadInLoop();
+  } else {
+    loop_->queueInLoop(
+        std::bind(&TcpConnection::startReadInLoop, shared_from_this()));
+  }
+}
+
+void TcpConnection::stopReadInLoop() {
+  loop_->assertInLoopThread();
+  if (reading_) {
+    reading_ = false;
+    // 连接已断开时信道已经失能
+    if ((state_ == kConnected || state_ == kDisconnecting) &&
+        channel_->isReading())
+      channel_->disableReading();
+  }
+}
+
+void TcpConnection::startReadInLoop() {
+  loop_->assertInLoopThread();
+  if (!reading_) {
+    reading_ = true;
+    if ((state_ == kConnected || state_ == kDisconnecting) &&
+        !readThrottled_ && !channel_->isReading())
+      channel_->enableReading();
+  }
+}
+
+namespace {
+// 限速暂停后至少等到有这么多令牌（不超过 burst）再恢复，避免频繁的定时器和小块的读写
+const double kRefillQuantum = 4096;
+}  // namespace
+
+void TcpConnection::setReadRateLimit(double rate, size_t burst) {
+  loop_->assertInLoopThread();
+  // burst 为 0 时桶中永远没有令牌，连接不断地等待 0 秒的定时器却无法读写；
+  // 太小时每个定时器只能读写几个字节，所以至少为 kRefillQuantum
+  double capacity = std::max(static_cast<double>(burst), kRefillQuantum);
+  readBucket_ = rate > 0 ? TokenBucket(rate, capacity, Timestamp::now())
+                         : TokenBucket();
+  if (readThrottled_ && !readBucket_.limited()) {
+    readThrottled_ = false;
+    if (reading_ && (state_ == kConnected || state_ == kDisconnecting))
+      channel_->enableReading();
+  }
+}
+
+void TcpConnection::setWriteRateLimit(double rate, size_t burst) {
+  loop_->assertInLoopThread();
+  double capacity = std::max(static_cast<double>(burst), kRefillQuantum);
+  writeBucket_ = rate > 0 ? TokenBucket(rate, capacity, Timestamp::now())
+                          : TokenBucket();
+  if (writeThrottled_ && !writeBucket_.limited()) {
+    writeThrottled_ = false;
+    if (state_ == kConnected || state_ == kDisconnecting)
       channel_->enableWriting();
   }
 }
 
+void TcpConnection::setStats(const ConnectionStatsPtr& stats) {
+  if (state_ == kConnected || state_ == kDisconnecting) {
+    loop_->assertInLoopThread();
+    if (stats_) stats_->disconnected();
+    if (stats) stats->connected();
+  }
+  stats_ = stats;
+}
+
+void TcpConnection::wroteBytes(size_t n) {
+  if (writeBucket_.limited()) writeBucket_.consume(n);
+  if (stats_) stats_->addBytesWritten(n);
+}
+
+bool TcpConnection::writePending() const {
+  return channel_->isWriting() || writeThrottled_;
+}
+
+size_t TcpConnection::writeQuota(size_t len) {
+  if (!writeBucket_.limited()) return len;
+  // 使用本轮事件循环的时间，不需要每次读时钟
+  writeBucket_.refill(loop_->pollReturnTime());
+  return std::min(len, writeBucket_.available());
+}
+
+void TcpConnection::startWriting() {
+  if (writeQuota(1) == 0)
+    throttleWrite();
+  else
+    channel_->enableWriting();
+}
+
+void TcpConnection::throttleRead() {
+  readThrottled_ = true;
+  if (channel_->isReading()) channel_->disableReading();
+  runAfterRefill(readBucket_.secondsUntil(kRefillQuantum),
+                 &TcpConnection::onReadRefill);
+}
+
+void TcpConnection::throttleWrite() {
+  writeThrottled_ = true;
+  if (channel_->isWriting()) channel_->disableWriting();
+  double wanted = std::min(
+      kRefillQuantum, std::max(1.0, double(outputBuffer_.readableBytes())));
+  runAfterRefill(writeBucket_.secondsUntil(wanted),
+                 &TcpConnection::onWriteRefill);
+}
+
+/**
+ * 定时器不能取消，所以回调只持有 weak_ptr，并且检查连接是否仍然处于暂停状态
+ * （限速可能已经被取消）。定时器到期时令牌仍然不够（透支较多）则继续等待
+ */
+void TcpConnection::runAfterRefill(double delay, void (TcpConnection::*refill)()) {
+  std::weak_ptr<TcpConnection> weak(shared_from_this());
+  loop_->runAfter(delay, [weak, refill] {
+    if (TcpConnectionPtr conn = weak.lock()) ((*conn).*refill)();
+  });
+}
+
+void TcpConnection::onReadRefill() {
+  if (!readThrottled_ || (state_ != kConnected && state_ != kDisconnecting))
+    return;
+  readBucket_.refill(loop_->pollReturnTime());
+  double delay = readBucket_.secondsUntil(kRefillQuantum);
+  if (delay > 0) {
+    runAfterRefill(delay, &TcpConnection::onReadRefill);
+    return;
+  }
+  readThrottled_ = false;
+  if (reading_ && !channel_->isReading()) channel_->enableReading();
+}
+
+void TcpConnection::onWriteRefill() {
+  if (!writeThrottled_ || (state_ != kConnected && state_ != kDisconnecting))
+    return;
+  writeThrottled_ = false;
+  // 令牌仍然不够时 startWriting 会再次暂停
+  startWriting();
+}
+
+/**
+ * 流量控制只在水位的上升沿暂停、下降沿恢复，高低水位之间的间隔避免了在一个水位附近
+ * 频繁地暂停和恢复，每次暂停和恢复都要修改 poll 监听的事件
+ */
+void TcpConnection::setFlowControl(const TcpConnectionPtr& source,
+                                   size_t highWaterMark, size_t lowWaterMark) {
+  loop_->assertInLoopThread();
+  assert(lowWaterMark < highWaterMark);
+  clearFlowControl();
+  flowSource_ = source;
+  flowHighWaterMark_ = highWaterMark;
+  flowLowWaterMark_ = lowWaterMark;
+  checkHighWaterMark();
+}
+
+void TcpConnection::clearFlowControl() {
+  loop_->assertInLoopThread();
+  if (sourcePaused_) {
+    sourcePaused_ = false;
+    if (TcpConnectionPtr source = flowSource_.lock()) source->startRead();
+  }
+  flowSource_.reset();
+  flowHighWaterMark_ = 0;
+  flowLowWaterMark_ = 0;
+}
+
+void TcpConnection::checkHighWaterMark() {
+  if (flowHighWaterMark_ > 0 && !sourcePaused_ &&
+      outputBuffer_.readableBytes() >= flowHighWaterMark_) {
+    if (TcpConnectionPtr source = flowSource_.lock()) {
+      sourcePaused_ = true;
+      source->stopRead();
+    }
+  }
+}
+
+void TcpConnection::checkLowWaterMark() {
+  if (sourcePaused_ && outputBuffer_.readableBytes() <= flowLowWaterMark_) {
+    sourcePaused_ = false;
+    if (TcpConnectionPtr source = flowSource_.lock()) source->startRead();
+  }
+}
+
+void TcpConnection::setCorked(bool on) {
+  if (corked_ != on) {
+    // 不支持 TCP_CORK 时（Unix 域 socket）保持 corked_ 为 false
+    corked_ = socket_->setTcpCork(on) && on;
+  }
+}
+
 void TcpConnection::shutdown() {
   // FIXME use compare and swap
   if (state_ == kConnected) {
@@ -110,12 +538,30 @@ void TcpConnection::shutdown() {
 void TcpConnection::shutdownInLoop() {
   loop_->assertInLoopThread();
   // 只有当没有数据要写出时，才能关闭写端
-  // 这里没能关闭成功的，在 TcpConnection::handleWrite 中进行关闭
-  if (!channel_->isWriting()) {
+  // 这里没能关闭成功的，在 TcpConnection::handleWrite 或 flushDeferred 中进行关闭
+  if (!writePending() && !flushScheduled_) {
     socket_->shutdownWrite();
   }
 }
 
+void TcpConnection::forceClose() {
+  // FIXME use compare and swap
+  if (state_ == kConnected || state_ == kDisconnecting) {
+    setState(kDisconnecting);
+    // 延长连接的生命期，调用者可能只持有临时的 shared_ptr
+    loop_->queueInLoop(
+        std::bind(&TcpConnection::forceCloseInLoop, shared_from_this()));
+  }
+}
+
+void TcpConnection::forceCloseInLoop() {
+  loop_->assertInLoopThread();
+  if (state_ == kConnected || state_ == kDisconnecting) {
+    // 和对方关闭连接的处理相同
+    handleClose();
+  }
+}
+
 void TcpConnection::setTcpNoDelay(bool on) {
   socket_->setTcpNoDelay(on);
 }
@@ -125,29 +571,52 @@ void TcpConnection::connectEstablished() {
   loop_->assertInLoopThread();
   assert(state_ == kConnecting);
   setState(kConnected);
-  channel_->enableReading(); // 开始监听消息可读事件
+  if (stats_) stats_->connected();
+  if (reading_) channel_->enableReading(); // 开始监听消息可读事件
   // 给用户回调传 shared_ptr，确保用户回调期间 TcpConnection 对象存活
-  connectionCallback_(shared_from_this()); // 调用建立该连接时的用户回调
+  if (connectionCallback_)
+    connectionCallback_(shared_from_this()); // 调用建立该连接时的用户回调
 }
 
 void TcpConnection::connectDestroyed() {
   loop_->assertInLoopThread();
-  assert(state_ == kConnected || state_ == kDisconnecting);
+  assert(state_ != kConnecting);
+  // 不经过 handleClose 时，在这里从统计中移除
+  if (state_ != kDisconnected && stats_) stats_->disconnected();
   setState(kDisconnected);
   // connectDestroyed 在某些情况下会不经过 handleClose 而被直接调用
   channel_->disableAll(); // 使信道失能
-  connectionCallback_(shared_from_this());
+  // 不经过 handleClose 时，恢复还在等待的协程
+  resumeReader();
+  resumeWriter();
+  clearFlowControl();
+  if (connectionCallback_) connectionCallback_(shared_from_this());
   // 从 poller 中移除本连接使用信道对应的 pollfd
   loop_->removeChannel(channel_.get());
 }
 
 void TcpConnection::handleRead(Timestamp receiveTime) {
   int savedErrno = 0;
+  size_t maxBytes = SIZE_MAX;
+  if (readBucket_.limited()) {  // 限速时最多读取令牌数的数据，至少读 1 个字节以发现连接关闭
+    readBucket_.refill(receiveTime);
+    maxBytes = std::max<size_t>(readBucket_.available(), 1);
+  }
   // 读取数据到缓冲区中
-  ssize_t n = inputBuffer_.readFd(channel_->fd(), &savedErrno);
-  if (n > 0) {  // 读取成功，调用可读用户回调
-    // onMessage 回调中实际上把私有变量 inputBuffer_ 直接暴露给了用户
-    messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+  ssize_t n = inputBuffer_.readFd(channel_->fd(), &savedErrno, maxBytes);
+  if (n > 0) {  // 读取成功
+    if (stats_) stats_->addBytesRead(n);
+    if (readBucket_.limited()) {
+      readBucket_.consume(n);
+      // 令牌用完了，暂停读取，数据留在内核接收缓冲区中
+      if (readBucket_.available() == 0) throttleRead();
+    }
+    if (readAwaiter_ != nullptr) {  // 有协程在等待读，数据满足条件时直接恢复协程
+      resumeReader();
+    } else if (messageCallback_) {  // 调用可读用户回调
+      // onMessage 回调中实际上把私有变量 inputBuffer_ 直接暴露给了用户
+      messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+    }
   } else if (n == 0) {  // 客户端关闭连接，服务端被动关闭连接
     handleClose();
   } else {  // 读取错误
@@ -165,22 +634,42 @@ void TcpConnection::handleRead(Timestamp receiveTime) {
 void TcpConnection::handleWrite() {
   loop_->assertInLoopThread();
   if (channel_->isWriting()) {
-    // 将输出缓冲区中的数据写入 socket
-    ssize_t n = ::write(channel_->fd(), outputBuffer_.peek(),
-                        outputBuffer_.readableBytes());
+    ssize_t n;
+    if (zeroCopySending()) {  // 零拷贝发送的消息在输出缓冲区中的数据之前
+      n = writeZeroCopy();
+    } else {
+      size_t quota = writeQuota(outputBuffer_.readableBytes());
+      if (quota == 0) {  // 没有令牌，暂停发送
+        throttleWrite();
+        return;
+      }
+      // 将输出缓冲区中的数据写入 socket
+      n = ::write(channel_->fd(), outputBuffer_.peek(), quota);
+      if (n > 0) {
+        outputBuffer_.retrieve(n); // 更新缓冲区可读索引
+        checkLowWaterMark();
+      }
+    }
     if (n > 0) {  // 发送成功
-      outputBuffer_.retrieve(n); // 更新缓冲区可读索引
-      if (outputBuffer_.readableBytes() == 0) { // 缓冲区数据全部被写出了
+      wroteBytes(n);
+      // 缓冲区数据全部被写出了
+      if (outputBuffer_.readableBytes() == 0 && !zeroCopySending()) {
         // 立即不再监听可写事件，防止 busy loop
         channel_->disableWriting();
+        // 关闭 TCP_CORK，立即发出最后不满一个报文段的数据
+        setCorked(false);
         // 缓冲区数据全部被写出了，执行回调
         if (writeCompleteCallback_) {
           loop_->queueInLoop(std::bind(writeCompleteCallback_, shared_from_this()));
         }
+        resumeWriter();
         // 主动关闭 TCP 连接时因为还有数据要写出而关闭失败的，在这里进行关闭
         if (state_ == kDisconnecting) {
           shutdownInLoop();
         }
+      } else if (writeBucket_.limited() && writeBucket_.available() == 0) {
+        // 令牌用完了，不等下一次可写事件，直接暂停发送
+        throttleWrite();
       }
     } else {  // 发送失败
       LOG_ERROR << "TcpConnection::handleWrite";
@@ -195,14 +684,39 @@ void TcpConnection::handleClose() {
   LOG_TRACE << "TcpConnection::handleClose state = " << state_;
   // 已连接的连接或半关闭的连接才能被关闭
   assert(state_ == kConnected || state_ == kDisconnecting);
+  setState(kDisconnected);
+  if (stats_) stats_->disconnected();
   channel_->disableAll(); // 使信道失能
+  // 恢复还在等待的协程，它们会看到连接已断开
+  resumeReader();
+  resumeWriter();
+  // 不会再发送数据，恢复被暂停读取的连接
+  clearFlowControl();
   // 从 server 或 client 中删除本连接，TcpServer::removeConnection
   // 必须在最后一行
   closeCallback_(shared_from_this());
 }
 
 void TcpConnection::handleError() {
+  // 零拷贝发送的完成通知也在错误队列中，不是真正的错误
+  if (zeroCopyThreshold_ > 0 && handleZeroCopyCompletions()) return;
   int err = sockets::getSocketError(socket_->fd());
   LOG_ERROR << "TcpConnection::handleError [" << name_
             << "] - SO_ERROR = " << err << " " << strerror_tl(err);
-}
\ No newline at end of file
+}
+
+void TcpConnection::resumeReader() {
+  ReadAwaiter* awaiter = readAwaiter_;
+  if (awaiter != nullptr && awaiter->satisfied()) {
+    readAwaiter_ = nullptr;
+    awaiter->handle_.resume(); // 协程中可能再次等待读，重新设置 readAwaiter_
+  }
+}
+
+void TcpConnection::resumeWriter() {
+  WriteAwaiter* awaiter = writeAwaiter_;
+  if (awaiter != nullptr) {
+    writeAwaiter_ = nullptr;
+    awaiter->handle_.resume();
+  }
+}
@@ -1,13 +1,21 @@
 #ifndef _JMUDUO_TCP_CONNCETION_H_
 #define _JMUDUO_TCP_CONNCETION_H_
 
+#include <stdint.h>
+
+#include <any>
+#include <deque>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "InetAddress.h"
 #include "Callbacks.h"
+#include "ConnectionStats.h"
 #include "noncopyable.h"
 #include "Buffer.h"
+#include "Coroutine.h"
+#include "TokenBucket.h"
 
 namespace jmuduo {
 
@@ -61,13 +69,118 @@ class TcpConnection : noncopyable, public std::enable_shared_from_this<TcpConnec
   const InetAddress& getPeerAddr() const { return peerAddr_; }
   bool connected() const { return state_ == kConnected; }
 
-  // void send(const void* message, size_t len);
   // 发送消息，线程安全的，可在别的线程调用
   void send(const std::string& message);
+  void send(const void* data, size_t len);
+  // 发送 buf 中的全部数据并清空 buf，在 IO 线程中调用时没有额外的拷贝
+  // 开启零拷贝发送时，足够大的 buf 中的数据通过 swap 转移给连接，用 MSG_ZEROCOPY 发送
+  void send(Buffer* buf);
+  // 发送共享的不可变数据（如缓存的文件内容），连接持有 data 直到发送完成，
+  // 开启零拷贝发送时同一份数据可以多次发送而不拷贝
+  void send(const std::shared_ptr<const std::string>& data);
   // 主动断开 TCP 连接，实际为关闭写端口，线程安全的，可在别的线程调用
   void shutdown();
+  // 强制关闭连接，不等待输出缓冲区中的数据发送完毕，线程安全的，可在别的线程调用
+  void forceClose();
   // 设置禁用 Nagle 算法，避免连续发包出现延迟，适用于低延迟网络服务
   void setTcpNoDelay(bool on);
+  /**
+   * @brief 延迟写：打开后在 IO 线程中 send 的数据只追加到输出缓冲区，在本轮事件循环的
+   * 最后（EventLoop::runBeforePoll）用一次 write 发出。一次 onMessage 中发送多个
+   * 响应（如流水线请求）时只需要一次系统调用，也不会发出多个小的报文段。
+   * 一次没有写完、剩余数据要在可写事件中分多次写出时自动打开 TCP_CORK，写完时关闭。
+   * 只能在 IO 线程中调用，通常在 ConnectionCallback 中设置
+   */
+  void setDeferredFlush(bool on);
+  /**
+   * @brief 设置 TCP_NOTSENT_LOWAT：内核发送队列中未发送的数据少于 bytes 时 socket 才可写，
+   * 待发送的数据更多地留在用户态的输出缓冲区中，高水位和流量控制能够及时生效，
+   * 也避免内核发送队列过长增加延迟
+   */
+  void setTcpNotSentLowat(int bytes);
+  /**
+   * @brief 开启零拷贝发送（SO_ZEROCOPY），内核不支持时返回 false
+   * 之后在 IO 线程中用 send(Buffer*) 或 send(shared_ptr) 发送的不少于 threshold 字节、
+   * 且前面没有待发送数据的消息用 sendmsg(MSG_ZEROCOPY) 发送：内核直接引用用户态的内存页，
+   * 省去拷贝到 socket 缓冲区的开销，但是要锁定内存页并在完成时通知，对小消息反而更慢，
+   * 所以其他情况下自动退回普通的拷贝发送。
+   * 完成通知从 socket 的错误队列中读取（poll 报告 POLLERR，经由 handleError），
+   * 数据在内核通知发送完成之前由连接持有，不会被释放或修改。
+   * 零拷贝发送中的数据不计入输出缓冲区，不参与高水位和流量控制
+   * 只能在 IO 线程中调用
+   */
+  bool enableZeroCopy(size_t threshold = 64 * 1024);
+  // MSG_ZEROCOPY 发送的次数，以及其中内核退回拷贝的次数（如发往本机的数据）
+  uint64_t zeroCopySends() const { return zeroCopySends_; }
+  uint64_t zeroCopyCopied() const { return zeroCopyCopied_; }
+
+  /* 流量控制 */
+  // 暂停/恢复读取，暂停期间对方发送的数据堆积在内核接收缓冲区中，TCP 的滑动窗口
+  // 会使对方停止发送。线程安全的，可在别的线程调用
+  void stopRead();
+  void startRead();
+  bool isReading() const { return reading_; }
+  /**
+   * @brief 自动背压：本连接的输出缓冲区超过 highWaterMark 时暂停 source 的读取，
+   * 降到 lowWaterMark 以下时恢复。如代理中服务端连接的数据转发到本连接，对方接收慢时
+   * 不再从服务端读取，而不是在输出缓冲区中无限堆积。source 可以是本连接自己（如 echo
+   * 服务），可以属于别的 IO 线程。本连接断开时恢复 source 的读取
+   * 只能在 IO 线程中调用
+   */
+  void setFlowControl(const TcpConnectionPtr& source, size_t highWaterMark,
+                      size_t lowWaterMark);
+  void clearFlowControl();
+
+  /**
+   * @brief 设置连接所属的统计类别，见 ConnectionStats。TcpServer 在连接建立之前设置为
+   * 服务端的类别，用户可以在连接回调中改为别的类别，已经建立的连接在两个类别间转移
+   * 连接建立之后只能在 IO 线程中调用
+   */
+  void setStats(const ConnectionStatsPtr& stats);
+  const ConnectionStatsPtr& stats() const { return stats_; }
+
+  /* 限速 */
+  /**
+   * @brief 用令牌桶限制本连接读取/发送的速率，rate 为每秒的字节数，burst 为允许突发的
+   * 字节数（至少为 4KB，更小的值按 4KB 处理，否则读写会停滞），rate 为 0 时取消限速
+   * 令牌用完时暂停监听可读/可写事件，由定时器在令牌足够时恢复，而不是把数据读到用户态再缓冲：
+   * 1. 读取受限时每次最多读取令牌数的数据，其余的数据留在内核接收缓冲区中，
+   *    TCP 的滑动窗口会使对方停止发送
+   * 2. 发送受限时数据留在输出缓冲区中，可以配合高水位回调或 setFlowControl 限制其大小。
+   *    发送受限的连接不使用零拷贝发送
+   * 只能在 IO 线程中调用
+   */
+  void setReadRateLimit(double rate, size_t burst);
+  void setWriteRateLimit(double rate, size_t burst);
+
+  /* 协程接口，只能在连接所属的 IO 线程中使用，见 Coroutine.h */
+  // 读取 n 个字节
+  StringReadAwaiter readExactly(size_t n) {
+    return StringReadAwaiter(this, ReadAwaiter::kExactly, n, {});
+  }
+  // 读取到分隔符为止的数据（包括分隔符）
+  StringReadAwaiter readUntil(std::string_view delimiter) {
+    return StringReadAwaiter(this, ReadAwaiter::kUntil, 0, delimiter);
+  }
+  // 等待有数据可读，返回输入缓冲区，由调用者取走数据
+  BufferReadAwaiter readSome() {
+    return BufferReadAwaiter(this, ReadAwaiter::kSome, 0, {});
+  }
+  // 发送数据，并等待输出缓冲区被清空
+  WriteAwaiter write(std::string_view data) {
+    return WriteAwaiter(this, data.data(), data.size());
+  }
+  // 发送 buf 中的全部数据并清空 buf，然后等待输出缓冲区被清空
+  WriteAwaiter write(Buffer* buf) { return WriteAwaiter(this, buf); }
+
+  // 只能在 IO 线程中使用
+  Buffer* inputBuffer() { return &inputBuffer_; }
+  Buffer* outputBuffer() { return &outputBuffer_; }
+
+  // 用户数据，如协议解析的状态，只在连接所属的 IO 线程中使用
+  void setContext(const std::any& context) { context_ = context; }
+  const std::any& getContext() const { return context_; }
+  std::any* getMutableContext() { return &context_; }
 
   // 设置用户回调
   void setConnectionCallback(const ConnectionCallback& cb) {
@@ -101,6 +214,9 @@ class TcpConnection : noncopyable, public std::enable_shared_from_this<TcpConnec
   void connectDestroyed();
 
  private:
+  friend class ReadAwaiter;
+  friend class WriteAwaiter;
+
   enum StateE {
     kConnecting,    // 初始值，正在连接
     kConnected,     // 连接已建立
@@ -116,7 +232,49 @@ class TcpConnection : noncopyable, public std::enable_shared_from_this<TcpConnec
   void handleError();  // 处理连接错误事件
 
   void sendInLoop(const std::string& message);
+  void sendInLoop(const void* data, size_t len);
+  // 延迟写模式下，在本轮事件循环的最后发送输出缓冲区中的数据
+  void flushDeferred();
+  void setCorked(bool on);
+  // 零拷贝发送
+  bool canZeroCopy(size_t len) const;
+  void sendZeroCopyInLoop(std::shared_ptr<const void> owner, const char* data,
+                          size_t len);
+  // 发送 zeroCopyBlocks_ 中最后一个还没有发送完的消息，返回值同 write
+  ssize_t writeZeroCopy();
+  // 是否有还没有发送完的零拷贝消息，它在输出缓冲区中的数据之前
+  bool zeroCopySending() const {
+    return !zeroCopyBlocks_.empty() &&
+           zeroCopyBlocks_.back().sent < zeroCopyBlocks_.back().len;
+  }
+  // 读取错误队列中的完成通知，释放已经完成的消息，读到通知时返回 true
+  bool handleZeroCopyCompletions();
+  void releaseZeroCopyBlocks();
+  // 限速
+  // 成功写出 n 个字节后更新限速令牌和统计
+  void wroteBytes(size_t n);
+  // 是否有待发送的数据：正在关注可写事件，或者因为限速暂停了发送
+  bool writePending() const;
+  // 限速时本次最多可以发送的字节数
+  size_t writeQuota(size_t len);
+  // 开始关注可写事件，没有令牌时改为等待定时器
+  void startWriting();
+  void throttleRead();
+  void throttleWrite();
+  // 定时器回调，令牌足够时恢复读取/发送
+  void onReadRefill();
+  void onWriteRefill();
+  void runAfterRefill(double delay, void (TcpConnection::*refill)());
+  void stopReadInLoop();
+  void startReadInLoop();
+  // 输出缓冲区增长/减少后检查流量控制的高/低水位
+  void checkHighWaterMark();
+  void checkLowWaterMark();
   void shutdownInLoop();
+  void forceCloseInLoop();
+  // 等待的条件满足时恢复等待读/写的协程
+  void resumeReader();
+  void resumeWriter();
 
   EventLoop* loop_; // 连接所属的事件循环
   std::string name_; // 连接名称，格式 ip:port#connIndex
@@ -143,6 +301,38 @@ class TcpConnection : noncopyable, public std::enable_shared_from_this<TcpConnec
    */
   Buffer inputBuffer_; // 用户读取缓冲区
   Buffer outputBuffer_; // 用户写入缓冲区
+  ReadAwaiter* readAwaiter_; // 等待读的协程，有协程在等待时不调用 messageCallback_
+  WriteAwaiter* writeAwaiter_; // 等待输出缓冲区被清空的协程
+  std::any context_; // 用户数据
+  bool deferredFlush_; // 是否延迟写
+  bool flushScheduled_; // 本轮事件循环是否已经安排了 flushDeferred
+  bool corked_; // 是否打开了 TCP_CORK
+  bool reading_; // 是否在读取，stopRead 后为 false
+  std::weak_ptr<TcpConnection> flowSource_; // 流量控制中被暂停读取的连接
+  size_t flowHighWaterMark_; // 为 0 时不进行流量控制
+  size_t flowLowWaterMark_;
+  bool sourcePaused_; // 是否暂停了 flowSource_ 的读取
+  ConnectionStatsPtr stats_; // 所属的统计类别，可以为空
+  TokenBucket readBucket_;  // 读取限速
+  TokenBucket writeBucket_; // 发送限速
+  bool readThrottled_;  // 是否因为限速暂停了读取
+  bool writeThrottled_; // 是否因为限速暂停了发送
+
+  // 零拷贝发送的消息，内核通知完成之前不能释放
+  struct ZeroCopyBlock {
+    std::shared_ptr<const void> owner;  // 持有数据
+    const char* data;
+    size_t len;
+    size_t sent;       // 已经发送的字节数
+    uint32_t lastSeq;  // 最后一次 MSG_ZEROCOPY 发送的序号
+    bool pinned;       // 是否有 MSG_ZEROCOPY 发送成功，即内核引用了这块内存
+  };
+  size_t zeroCopyThreshold_; // 为 0 时不使用零拷贝发送
+  std::deque<ZeroCopyBlock> zeroCopyBlocks_; // 按发送顺序排列
+  uint32_t zeroCopySeq_; // 下一次 MSG_ZEROCOPY 发送的序号，内核为每次成功的发送递增
+  uint32_t zeroCopyCompleted_; // 序号小于它的发送都已经完成（TCP 的通知按顺序到达）
+  uint64_t zeroCopySends_;
+  uint64_t zeroCopyCopied_;
 };
 
 }  // namespace jmuduo
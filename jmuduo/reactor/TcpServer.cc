@@ -19,7 +19,8 @@ TcpServer::TcpServer(EventLoop* loop, const InetAddress& listenAddr)
       acceptor_(new Acceptor(loop, listenAddr)),
       threadPool_(new EventLoopThreadPool(loop)),
       started_(false),
-      nextConnId_(1) {
+      nextConnId_(1),
+      stats_(std::make_shared<ConnectionStats>(name_)) {
   acceptor_->setNewConnectionCallback(
       bind(&TcpServer::newConnection, this, _1, _2));
 }
@@ -68,10 +69,19 @@ void TcpServer::newConnection(int sockfd, const InetAddress& peerAddr) {
   conn->setMessageCallback(messageCallback_);
   conn->setWriteCompleteCallback(writeCompleteCallback_);
   conn->setCloseCallback(bind(&TcpServer::removeConnection, this, _1));
+  conn->setStats(stats_);
   // 新的连接属于 ioLoop，应该在 ioLoop 中处理对连接的操作
   ioLoop->runInLoop(std::bind(&TcpConnection::connectEstablished, conn));
 }
 
+std::vector<TcpConnectionPtr> TcpServer::connectionList() const {
+  loop_->assertInLoopThread();
+  std::vector<TcpConnectionPtr> conns;
+  conns.reserve(connections_.size());
+  for (auto& entry : connections_) conns.push_back(entry.second);
+  return conns;
+}
+
 void TcpServer::removeConnection(const TcpConnectionPtr& conn) {
   // TcpConnection 会在自己的 ioLoop 线程调用 removeConnection，所以需要把他移动到
   // TcpServer 的 loop_ 线程（因为 TcpServer 是无锁的）
@@ -86,6 +96,7 @@ void TcpServer::removeConnectionInLoop(const TcpConnectionPtr& conn) {
   // 退出调用该函数的函数时 TcpConnection 会被销毁（conn 是一个引用）
   size_t n = connections_.erase(conn->getName());
   assert(n == 1);
+  (void)n;
   auto ioLoop = conn->getLoop();
   // 此时仍然在 channel::handleEvent 的执行路径中，为了避免销毁 channel，即避免
   // 销毁 TcpConnection，使用 bind 延长 TcpConnection 的生命周期到下一次事件循
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Callbacks.h"
 #include "TcpConnection.h"
@@ -33,6 +34,16 @@ class TcpServer : noncopyable {
   // 开始 TCP 服务的监听。线程安全，且多次调用无害
   void start();
 
+  EventLoop* getLoop() const { return loop_; }
+  // 服务的名称，即监听地址 ip:port
+  const std::string& name() const { return name_; }
+  // 本服务所有连接的统计，连接可以用 TcpConnection::setStats 改为别的类别
+  const ConnectionStatsPtr& stats() const { return stats_; }
+  // 当前所有连接，只能在 loop_ 线程中调用
+  std::vector<TcpConnectionPtr> connectionList() const;
+  // IO 线程池，start 之后可以用 callAll 向所有 IO 线程查询数据
+  EventLoopThreadPool* threadPool() const { return threadPool_.get(); }
+
   // 设置用户回调，有新的连接建立时
   void setConnectionCallback(const ConnectionCallback& cb) {
     connectionCallback_ = cb;
@@ -71,6 +82,7 @@ class TcpServer : noncopyable {
   bool started_;  // 服务是否启动
   int nextConnId_;  // 下一个连接 socket 的编号，单调递增
   ConnectionMap connections_;  // 所有 TCP 连接，连接名称 => TcpConnection
+  const ConnectionStatsPtr stats_;  // 新连接默认的统计类别
 };
 
 }  // namespace jmuduo
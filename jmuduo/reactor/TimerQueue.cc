@@ -9,9 +9,11 @@
 #include <functional>
 
 #include "EventLoop.h"
+#include "EventLoopMetrics.h"
 #include "Timer.h"
 #include "TimerId.h"
 #include "../base/logging/Logging.h"
+#include "../base/metrics/Tracer.h"
 
 namespace jmuduo {
 namespace detail {
@@ -102,6 +104,7 @@ TimerQueue::TimerQueue(EventLoop* el)
       timerfd_(create_timefd()),
       timerfdChannel_(el, timerfd_),
       timers_() {
+  timerfdChannel_.setKind(Channel::kTimer);
   timerfdChannel_.setReadCallback(std::bind(&TimerQueue::handleRead, this));
   timerfdChannel_.enableReading();
 }
@@ -135,8 +138,26 @@ void TimerQueue::handleRead() {
   readTimerfd(timerfd_, now);
 
   auto expired = getExpired(now); // 获取所有到期的定时器
-  for(auto &timer : expired) { // 执行到期定时器的回调函数
-    timer.second->run();
+  if (EventLoopMetrics* metrics = loop_->metrics()) {
+    // 定时器的延迟：timerfd 的精度、事件循环忙于处理其他事件
+    for (auto& timer : expired)
+      metrics->recordTimerLateness(
+          (now.microSecondsSinceEpoch() - timer.first.microSecondsSinceEpoch()) *
+          1000);
+  }
+  if (Tracer::enabled()) {
+    // 每个定时器回调一个区间，参数为定时器的延迟（微秒）
+    for (auto& timer : expired) {
+      int64_t start = Tracer::now();
+      timer.second->run();
+      Tracer::record("runTimer", start, Tracer::now(),
+                     now.microSecondsSinceEpoch() -
+                         timer.first.microSecondsSinceEpoch());
+    }
+  } else {
+    for(auto &timer : expired) { // 执行到期定时器的回调函数
+      timer.second->run();
+    }
   }
 
   // 重设间隔定时器
@@ -198,6 +219,7 @@ bool TimerQueue::insert(Timer* ptimer) {
 
   auto res = timers_.insert(std::make_pair(when, ptimer));
   assert(res.second);
+  (void)res;
 
   return earliestChanged;
 }
@@ -39,6 +39,10 @@ class TimerQueue : noncopyable {
 
   // TODO 取消定时器
   // void cancel(TimerId timerId);
+
+  // 队列中的定时器个数，只能在 IO 线程中调用
+  size_t size() const { return timers_.size(); }
+
  private:
   // 定时器队列使用二叉排序树(map/set)，按到期时间从小到大排序
   // 不能直接使用 map<Timestamp, Timer*>，因为可能两个定时器的到期时间相同
@@ -0,0 +1,61 @@
+#ifndef _JMUDUO_TOKEN_BUCKET_H_
+#define _JMUDUO_TOKEN_BUCKET_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+
+#include "../base/datetime/Timestamp.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+/**
+ * @brief 令牌桶，用于限制速率：令牌以 rate 个/秒的速度加入桶中，桶中最多有 burst 个令牌
+ * 1. 不使用单独的定时器补充令牌，而是在使用时根据经过的时间补充，时间由调用者传入，
+ *    TcpConnection 使用事件循环的 pollReturnTime，每轮事件循环只需要读一次时钟
+ * 2. 允许透支：消耗的令牌可以多于桶中的令牌，令牌数为负时之后需要等待更长的时间，
+ *    长期的平均速率不变
+ * 不是线程安全的，只在一个 IO 线程中使用
+ */
+class TokenBucket : copyable {
+ public:
+  TokenBucket() : rate_(0), burst_(0), tokens_(0) {}
+  TokenBucket(double rate, double burst, Timestamp now)
+      : rate_(rate), burst_(burst), tokens_(burst), last_(now) {}
+
+  // rate 为 0 表示不限速
+  bool limited() const { return rate_ > 0; }
+  double rate() const { return rate_; }
+  double burst() const { return burst_; }
+
+  // 按照 last_ 到 now 经过的时间补充令牌
+  void refill(Timestamp now) {
+    if (last_ < now) {
+      tokens_ = std::min(burst_, tokens_ + timeDifference(now, last_) * rate_);
+      last_ = now;
+    }
+  }
+
+  // 当前可以使用的令牌数，透支时为 0
+  size_t available() const {
+    return tokens_ >= 1 ? static_cast<size_t>(tokens_) : 0;
+  }
+  void consume(size_t n) { tokens_ -= static_cast<double>(n); }
+
+  // 桶中有 n 个令牌还需要等待的时间（秒），n 不超过 burst
+  double secondsUntil(double n) const {
+    n = std::min(n, burst_);
+    return tokens_ >= n ? 0 : (n - tokens_) / rate_;
+  }
+
+ private:
+  double rate_;    // 每秒补充的令牌数
+  double burst_;   // 桶的容量
+  double tokens_;  // 当前的令牌数，可能为负
+  Timestamp last_; // 上次补充的时间
+};
+
+}  // namespace jmuduo
+
+#endif
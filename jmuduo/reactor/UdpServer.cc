@@ -0,0 +1,63 @@
+#include "UdpServer.h"
+
+#include <assert.h>
+
+#include "../base/logging/Logging.h"
+#include "EventLoop.h"
+#include "EventLoopThreadPool.h"
+
+using namespace jmuduo;
+
+UdpServer::UdpServer(EventLoop* loop, const InetAddress& listenAddr,
+                     const std::string& name)
+    : loop_(loop),
+      listenAddr_(listenAddr),
+      name_(name),
+      threadPool_(new EventLoopThreadPool(loop)),
+      batchSize_(UdpSocket::kMaxBatch),
+      gro_(false),
+      gso_(false),
+      started_(false) {}
+
+UdpServer::~UdpServer() {
+  loop_->assertInLoopThread();
+  // UdpSocket 要在所属的 IO 线程中析构，等待析构完成后再结束 IO 线程
+  for (auto& socket : sockets_) {
+    EventLoop* ioLoop = socket->getLoop();
+    if (ioLoop == loop_) {
+      socket.reset();
+    } else {
+      ioLoop->call([&socket] { socket.reset(); }).get();
+    }
+  }
+}
+
+void UdpServer::setThreadNum(int numThreads) {
+  assert(0 <= numThreads);
+  threadPool_->setThreadNum(numThreads);
+}
+
+void UdpServer::start() {
+  loop_->assertInLoopThread();
+  assert(!started_);
+  started_ = true;
+  threadPool_->start();
+
+  std::vector<EventLoop*> loops = threadPool_->getAllLoops();
+  // 多个 socket 时使用 SO_REUSEPORT 绑定同一端口。端口为 0 时每个 socket 都会分配到
+  // 不同的端口，所以其余的 socket 绑定到第一个 socket 实际分配到的地址
+  bool reusePort = loops.size() > 1;
+  InetAddress bindAddr = listenAddr_;
+  for (EventLoop* ioLoop : loops) {
+    auto socket = std::make_unique<UdpSocket>(ioLoop, bindAddr, reusePort);
+    if (sockets_.empty()) bindAddr = socket->localAddress();
+    socket->setMessageCallback(messageCallback_);
+    socket->setBatchSize(batchSize_);
+    if (gro_) socket->enableGro();
+    if (gso_) socket->enableGso();
+    socket->start();
+    sockets_.push_back(std::move(socket));
+  }
+  LOG_INFO << "UdpServer::start [" << name_ << "] - " << sockets_.size()
+           << " sockets on " << bindAddr.toHostPort();
+}
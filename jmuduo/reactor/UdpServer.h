@@ -0,0 +1,67 @@
+#ifndef _JMUDUO_UDP_SERVER_H_
+#define _JMUDUO_UDP_SERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "InetAddress.h"
+#include "UdpSocket.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class EventLoop;
+class EventLoopThreadPool;
+
+/**
+ * UDP 服务端，用法和 TcpServer 类似
+ * UDP 没有连接，不能像 TcpServer 那样把连接分配给 IO 线程，而是在每个 IO 线程中
+ * 创建一个设置了 SO_REUSEPORT 的 UdpSocket 绑定同一个端口，由内核按照四元组的哈希
+ * 把数据报分配给这些 socket，吞吐随 IO 线程数扩展，线程之间没有共享的状态
+ * 单线程模式下只在 loop_ 中创建一个 UdpSocket
+ *
+ * 回调中用参数 socket->send 回复数据报，回复和请求在同一个 IO 线程中
+ */
+class UdpServer : noncopyable {
+ public:
+  UdpServer(EventLoop* loop, const InetAddress& listenAddr,
+            const std::string& name);
+  ~UdpServer();
+
+  // 设置 IO 线程的数量，应该在 start 之前调用
+  void setThreadNum(int numThreads);
+  // 以下选项应该在 start 之前设置，对所有 UdpSocket 生效
+  void setMessageCallback(const UdpSocket::MessageCallback& cb) {
+    messageCallback_ = cb;
+  }
+  void setBatchSize(int n) { batchSize_ = n; }
+  void setGro(bool on) { gro_ = on; }
+  void setGso(bool on) { gso_ = on; }
+
+  // 创建 IO 线程和 UdpSocket，开始接收数据报，只能在 loop_ 中调用一次
+  void start();
+
+  const std::string& name() const { return name_; }
+  // 所有 UdpSocket，start 之后有效
+  const std::vector<std::unique_ptr<UdpSocket>>& sockets() const {
+    return sockets_;
+  }
+
+ private:
+  EventLoop* loop_;
+  const InetAddress listenAddr_;
+  const std::string name_;
+  std::unique_ptr<EventLoopThreadPool> threadPool_;
+  UdpSocket::MessageCallback messageCallback_;
+  int batchSize_;
+  bool gro_;
+  bool gso_;
+  bool started_;
+  // 每个 IO 线程一个，必须在所属的 IO 线程中析构
+  std::vector<std::unique_ptr<UdpSocket>> sockets_;
+};
+
+}  // namespace jmuduo
+
+#endif
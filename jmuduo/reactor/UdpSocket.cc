@@ -0,0 +1,299 @@
+#include "UdpSocket.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <netinet/udp.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "EventLoop.h"
+#include "SocketsOps.h"
+
+using namespace jmuduo;
+
+namespace {
+
+const size_t kGroBufferSize = 65536;   // GRO 合并后的数据报最大 64KB
+const size_t kMaxGsoSegments = 64;     // 内核限制每个 GSO 消息最多 64 个分段
+const size_t kMaxGsoBytes = 65000;     // GSO 消息的总长度不能超过一个 IP 包
+const size_t kGroControlSize = CMSG_SPACE(sizeof(int));
+const size_t kGsoControlSize = CMSG_SPACE(sizeof(uint16_t));
+
+// 两个待发送的数据报是否发往同一地址
+template <typename PendingSend>
+bool samePeer(const PendingSend& a, const PendingSend& b) {
+  return a.peerLen == b.peerLen && ::memcmp(&a.peer, &b.peer, a.peerLen) == 0;
+}
+
+}  // namespace
+
+UdpSocket::UdpSocket(EventLoop* loop, const InetAddress& bindAddr,
+                     bool reusePort, size_t maxDatagramSize)
+    : loop_(loop),
+      socket_(sockets::createUdpNonblockingOrDie(bindAddr.family())),
+      channel_(loop, socket_.fd()),
+      batchSize_(kMaxBatch),
+      bufferSize_(maxDatagramSize),
+      gro_(false),
+      gso_(false),
+      sendMsgs_(kMaxBatch),
+      sendIovecs_(kMaxBatch),
+      sendControl_(kMaxBatch * kGsoControlSize),
+      flushQueued_(false),
+      sendCounts_(kMaxBatch),
+      alive_(std::make_shared<bool>(true)),
+      started_(false),
+      receivedDatagrams_(0),
+      sentDatagrams_(0),
+      droppedDatagrams_(0),
+      recvSyscalls_(0),
+      sendSyscalls_(0) {
+  socket_.setReuseAddr(true);
+  socket_.setReusePort(reusePort);
+  socket_.bindAddress(bindAddr);
+  allocateRecvBuffers();
+  channel_.setKind(Channel::kUdp);
+  channel_.setReadCallback(
+      [this](Timestamp receiveTime) { handleRead(receiveTime); });
+}
+
+UdpSocket::~UdpSocket() {
+  loop_->assertInLoopThread();
+  if (started_) {
+    channel_.disableAll();
+    loop_->removeChannel(&channel_);
+  }
+}
+
+void UdpSocket::setBatchSize(int n) {
+  assert(0 < n && n <= kMaxBatch);
+  batchSize_ = n;
+}
+
+bool UdpSocket::enableGro() {
+  int on = 1;
+  if (::setsockopt(socket_.fd(), SOL_UDP, UDP_GRO, &on, sizeof on) < 0) {
+    LOG_SYSERR << "UdpSocket::enableGro";
+    return false;
+  }
+  gro_ = true;
+  bufferSize_ = std::max(bufferSize_, kGroBufferSize);
+  allocateRecvBuffers();
+  return true;
+}
+
+bool UdpSocket::enableGso() {
+  // 设置 socket 默认的分段大小为 0（不分段）以检测内核是否支持，
+  // 每个消息的分段大小在发送时用辅助数据指定
+  int segment = 0;
+  if (::setsockopt(socket_.fd(), SOL_UDP, UDP_SEGMENT, &segment,
+                   sizeof segment) < 0) {
+    LOG_SYSERR << "UdpSocket::enableGso";
+    return false;
+  }
+  gso_ = true;
+  return true;
+}
+
+void UdpSocket::allocateRecvBuffers() {
+  recvBuffers_.resize(kMaxBatch * bufferSize_);
+  recvMsgs_.assign(kMaxBatch, mmsghdr());
+  recvIovecs_.resize(kMaxBatch);
+  recvAddrs_.resize(kMaxBatch);
+  recvControl_.resize(gro_ ? kMaxBatch * kGroControlSize : 0);
+  for (int i = 0; i < kMaxBatch; ++i) {
+    recvIovecs_[i].iov_base = &recvBuffers_[i * bufferSize_];
+    recvIovecs_[i].iov_len = bufferSize_;
+    struct msghdr& hdr = recvMsgs_[i].msg_hdr;
+    hdr.msg_name = &recvAddrs_[i];
+    hdr.msg_iov = &recvIovecs_[i];
+    hdr.msg_iovlen = 1;
+  }
+}
+
+void UdpSocket::start() {
+  loop_->runInLoop([this] {
+    started_ = true;
+    channel_.enableReading();
+  });
+}
+
+InetAddress UdpSocket::localAddress() const {
+  return InetAddress(sockets::getLocalAddr(socket_.fd()));
+}
+
+void UdpSocket::handleRead(Timestamp receiveTime) {
+  loop_->assertInLoopThread();
+  for (int round = 0; round < kMaxReadRounds; ++round) {
+    // recvmmsg 会修改地址和辅助数据的长度，每次都要重置
+    for (int i = 0; i < batchSize_; ++i) {
+      struct msghdr& hdr = recvMsgs_[i].msg_hdr;
+      hdr.msg_namelen = sizeof(struct sockaddr_in6);
+      if (gro_) {
+        hdr.msg_control = &recvControl_[i * kGroControlSize];
+        hdr.msg_controllen = kGroControlSize;
+      }
+    }
+    int n = ::recvmmsg(socket_.fd(), recvMsgs_.data(), batchSize_,
+                       MSG_DONTWAIT, nullptr);
+    ++recvSyscalls_;
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        LOG_SYSERR << "UdpSocket::handleRead";
+      }
+      break;
+    }
+
+    for (int i = 0; i < n; ++i) {
+      const struct msghdr& hdr = recvMsgs_[i].msg_hdr;
+      const char* data = &recvBuffers_[i * bufferSize_];
+      size_t len = recvMsgs_[i].msg_len;
+      if (hdr.msg_flags & MSG_TRUNC) {
+        LOG_WARN << "UdpSocket::handleRead - datagram truncated to " << len;
+      }
+      // 开启 GRO 时，一个缓冲区中可能是多个合并的数据报，分段大小由辅助数据给出
+      size_t segment = len;
+      if (gro_) {
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&hdr), cmsg)) {
+          if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int gsoSize;
+            ::memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof gsoSize);
+            if (gsoSize > 0) segment = gsoSize;
+          }
+        }
+      }
+      InetAddress peer(reinterpret_cast<const struct sockaddr*>(&recvAddrs_[i]),
+                       hdr.msg_namelen);
+      size_t offset = 0;
+      do {
+        size_t segmentLen = std::min(segment, len - offset);
+        ++receivedDatagrams_;
+        if (messageCallback_)
+          messageCallback_(this, data + offset, segmentLen, peer, receiveTime);
+        offset += segmentLen;
+      } while (offset < len);
+    }
+    // 没有读满一批，说明已经读空
+    if (n < batchSize_) break;
+  }
+}
+
+void UdpSocket::send(const void* data, size_t len, const InetAddress& peer) {
+  if (!loop_->isInLoopThread()) {
+    // 跨线程时拷贝一份数据
+    std::string message(static_cast<const char*>(data), len);
+    loop_->runInLoop([this, message = std::move(message), peer] {
+      send(message.data(), message.size(), peer);
+    });
+    return;
+  }
+
+  size_t offset = sendArena_.size();
+  const char* p = static_cast<const char*>(data);
+  sendArena_.insert(sendArena_.end(), p, p + len);
+  PendingSend pending;
+  assert(peer.length() <= sizeof pending.peer);
+  ::memcpy(&pending.peer, peer.getSockAddr(), peer.length());
+  pending.peerLen = peer.length();
+  pending.offset = offset;
+  pending.len = len;
+  pending_.push_back(pending);
+  if (pending_.size() >= kMaxPendingSends) {
+    flush();
+  } else if (!flushQueued_) {
+    // 在事件处理中调用 queueInLoop 不会唤醒 poll，flush 在本轮事件循环的最后执行
+    flushQueued_ = true;
+    std::weak_ptr<bool> alive(alive_);
+    loop_->queueInLoop([this, alive] {
+      if (!alive.expired()) flush();
+    });
+  }
+}
+
+size_t UdpSocket::buildSendMessages(size_t begin, size_t end,
+                                    size_t* consumed) {
+  size_t i = begin;
+  size_t m = 0;
+  while (i < end && m < static_cast<size_t>(batchSize_)) {
+    const PendingSend& first = pending_[i];
+    size_t j = i + 1;
+    size_t total = first.len;
+    if (gso_) {
+      // 合并发往同一地址的连续数据报，除最后一个外长度都必须相同。
+      // 它们在 sendArena_ 中是连续存放的，可以用一个 iovec 发送
+      while (j < end && j - i < kMaxGsoSegments &&
+             samePeer(pending_[j], first) &&
+             pending_[j].len <= first.len &&
+             total + pending_[j].len <= kMaxGsoBytes) {
+        total += pending_[j].len;
+        bool shorter = pending_[j].len < first.len;
+        ++j;
+        if (shorter) break;
+      }
+    }
+
+    struct mmsghdr& msg = sendMsgs_[m];
+    msg = mmsghdr();
+    sendIovecs_[m].iov_base = &sendArena_[first.offset];
+    sendIovecs_[m].iov_len = total;
+    msg.msg_hdr.msg_name = const_cast<struct sockaddr_in6*>(&first.peer);
+    msg.msg_hdr.msg_namelen = first.peerLen;
+    msg.msg_hdr.msg_iov = &sendIovecs_[m];
+    msg.msg_hdr.msg_iovlen = 1;
+    if (j - i > 1) {
+      // 由内核按 first.len 分段
+      msg.msg_hdr.msg_control = &sendControl_[m * kGsoControlSize];
+      msg.msg_hdr.msg_controllen = kGsoControlSize;
+      struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg.msg_hdr);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      uint16_t segment = static_cast<uint16_t>(first.len);
+      ::memcpy(CMSG_DATA(cmsg), &segment, sizeof segment);
+    }
+    sendCounts_[m] = j - i;
+    ++m;
+    i = j;
+  }
+  *consumed = i - begin;
+  return m;
+}
+
+void UdpSocket::flush() {
+  loop_->assertInLoopThread();
+  flushQueued_ = false;
+  size_t next = 0;
+  while (next < pending_.size()) {
+    size_t consumed = 0;
+    size_t count = buildSendMessages(next, pending_.size(), &consumed);
+    size_t sent = 0;
+    while (sent < count) {
+      int n = ::sendmmsg(socket_.fd(), &sendMsgs_[sent], count - sent, 0);
+      ++sendSyscalls_;
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+          // 发送缓冲区已满，丢弃剩余的所有数据报
+          for (size_t k = sent; k < count; ++k) droppedDatagrams_ += sendCounts_[k];
+          droppedDatagrams_ += pending_.size() - next - consumed;
+          next = pending_.size();
+          break;
+        }
+        // 其他错误（如 ICMP 导致的 ECONNREFUSED）只丢弃出错的消息
+        LOG_SYSERR << "UdpSocket::flush";
+        droppedDatagrams_ += sendCounts_[sent];
+        ++sent;
+        continue;
+      }
+      for (size_t k = sent; k < sent + n; ++k) sentDatagrams_ += sendCounts_[k];
+      sent += n;
+    }
+    if (next < pending_.size()) next += consumed;
+  }
+  pending_.clear();
+  sendArena_.clear();
+}
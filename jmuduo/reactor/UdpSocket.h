@@ -0,0 +1,137 @@
+#ifndef _JMUDUO_UDP_SOCKET_H_
+#define _JMUDUO_UDP_SOCKET_H_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../base/datetime/Timestamp.h"
+#include "Channel.h"
+#include "InetAddress.h"
+#include "Socket.h"
+#include "noncopyable.h"
+
+namespace jmuduo {
+
+class EventLoop;
+
+/**
+ * 非阻塞的 UDP socket，属于一个事件循环，用 Channel 监听可读事件
+ * 1. 接收：可读时用 recvmmsg 一次系统调用读取多个数据报到预先分配的缓冲区池中，
+ *    直到读空（每次可读事件最多读取 kMaxReadRounds 批，照顾同一循环中的其他 IO）
+ * 2. 发送：send 只是把数据报追加到待发送队列，在本轮事件循环的最后（queueInLoop 的
+ *    functor 在事件处理之后执行）用 sendmmsg 一次发出，收到一批请求后的一批响应
+ *    只需要一次系统调用
+ * 3. 可选的 GRO/GSO（Linux 4.18/5.0 以上）：接收时内核把同一来源的多个数据报合并成
+ *    一个大的缓冲区交给用户，发送时把发往同一地址、长度相同的连续数据报合并成一个
+ *    消息由内核分段，进一步减少协议栈的开销
+ * UDP 是不可靠的，发送缓冲区满（EAGAIN/ENOBUFS）时丢弃数据报并计数
+ * 支持 IPv4 和 IPv6 地址，socket 的协议族由绑定的地址决定
+ */
+class UdpSocket : noncopyable {
+ public:
+  /**
+   * @brief 收到一个数据报时的回调，data 指向接收缓冲区池，只在回调期间有效
+   */
+  using MessageCallback =
+      std::function<void(UdpSocket* socket, const char* data, size_t len,
+                         const InetAddress& peer, Timestamp receiveTime)>;
+
+  static const int kMaxBatch = 64;       // recvmmsg/sendmmsg 每次的最大数据报数
+  static const int kMaxReadRounds = 16;  // 每次可读事件最多调用 recvmmsg 的次数
+  static const size_t kMaxPendingSends = 1024;  // 待发送队列的最大长度，超过时立即发送
+
+  /**
+   * @param bindAddr 绑定的本地地址，端口为 0 时由内核分配
+   * @param reusePort 是否设置 SO_REUSEPORT，多个事件循环各自的 socket 绑定同一端口
+   * @param maxDatagramSize 接收缓冲区池中每个缓冲区的大小，超过的数据报会被截断
+   */
+  UdpSocket(EventLoop* loop, const InetAddress& bindAddr, bool reusePort = false,
+            size_t maxDatagramSize = 2048);
+  // 必须在 loop_ 线程中析构
+  ~UdpSocket();
+
+  void setMessageCallback(const MessageCallback& cb) { messageCallback_ = cb; }
+  // 每次 recvmmsg/sendmmsg 的数据报数，1 表示不批量，用于对比。应该在 start 之前调用
+  void setBatchSize(int n);
+  // 开启 GRO，内核不支持时返回 false。接收缓冲区会扩大到 64KB。应该在 start 之前调用
+  bool enableGro();
+  // 开启 GSO，内核不支持时返回 false
+  bool enableGso();
+
+  // 开始接收数据报，线程安全
+  void start();
+
+  /**
+   * @brief 向 peer 发送一个数据报，线程安全。在 loop_ 线程中调用时只是加入待发送队列，
+   * 在本轮事件循环的最后发出，不会拷贝两次
+   */
+  void send(const void* data, size_t len, const InetAddress& peer);
+  // 立即发送待发送队列中的数据报，只能在 loop_ 线程中调用
+  void flush();
+
+  EventLoop* getLoop() const { return loop_; }
+  int fd() const { return socket_.fd(); }
+  InetAddress localAddress() const;
+  // 统计信息，只能在 loop_ 线程中读取
+  uint64_t receivedDatagrams() const { return receivedDatagrams_; }
+  uint64_t sentDatagrams() const { return sentDatagrams_; }
+  uint64_t droppedDatagrams() const { return droppedDatagrams_; }
+  uint64_t recvSyscalls() const { return recvSyscalls_; }
+  uint64_t sendSyscalls() const { return sendSyscalls_; }
+
+ private:
+  // 待发送的数据报，数据保存在 sendArena_ 中
+  struct PendingSend {
+    struct sockaddr_in6 peer;  // 足够存放 IPv4 和 IPv6 地址
+    socklen_t peerLen;
+    size_t offset;
+    size_t len;
+  };
+
+  void handleRead(Timestamp receiveTime);
+  // 分配接收缓冲区池，初始化 recvmmsg 使用的结构
+  void allocateRecvBuffers();
+  // 把 [begin, end) 中的待发送数据报填入 sendMsgs_，返回消息数
+  size_t buildSendMessages(size_t begin, size_t end, size_t* consumed);
+
+  EventLoop* loop_;
+  Socket socket_;
+  Channel channel_;
+  MessageCallback messageCallback_;
+  int batchSize_;
+  size_t bufferSize_;  // 接收缓冲区池中每个缓冲区的大小
+  bool gro_;
+  bool gso_;
+
+  // 接收缓冲区池，batchSize_ 个 bufferSize_ 大小的缓冲区，所有批次复用
+  std::vector<char> recvBuffers_;
+  std::vector<struct mmsghdr> recvMsgs_;
+  std::vector<struct iovec> recvIovecs_;
+  std::vector<struct sockaddr_in6> recvAddrs_;
+  std::vector<char> recvControl_;  // GRO 的辅助数据
+
+  std::vector<char> sendArena_;         // 待发送数据报的数据，依次存放
+  std::vector<PendingSend> pending_;    // 待发送的数据报
+  std::vector<struct mmsghdr> sendMsgs_;
+  std::vector<struct iovec> sendIovecs_;
+  std::vector<char> sendControl_;       // GSO 的辅助数据
+  bool flushQueued_;  // 本轮事件循环是否已经安排了 flush
+  std::vector<size_t> sendCounts_;      // sendMsgs_ 中每个消息包含的数据报数
+  // 安排的 flush 持有它的 weak_ptr，UdpSocket 析构后不再执行
+  std::shared_ptr<bool> alive_;
+  bool started_;  // channel_ 是否已经注册到 Poller
+
+  uint64_t receivedDatagrams_;
+  uint64_t sentDatagrams_;
+  uint64_t droppedDatagrams_;
+  uint64_t recvSyscalls_;
+  uint64_t sendSyscalls_;
+};
+
+}  // namespace jmuduo
+
+#endif
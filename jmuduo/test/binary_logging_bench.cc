@@ -0,0 +1,52 @@
+/**
+ * 二进制日志与文本日志的对比：每条日志的耗时和日志体积
+ * 将二进制日志写入 binary_logging_bench.log，可以用 tools/logdecode 还原：
+ *   ./tools/logdecode binary_logging_bench.log | head
+ */
+#include <stdio.h>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/logging/BinaryLog.h"
+#include "../base/logging/Logging.h"
+
+using namespace jmuduo;
+
+const int kN = 1000 * 1000;
+
+size_t g_textBytes = 0;
+size_t g_binaryBytes = 0;
+FILE* g_file = nullptr;
+
+void textOutput(const char* msg, int len) { g_textBytes += len; }
+
+void binaryOutput(const char* msg, int len) {
+  g_binaryBytes += len;
+  fwrite(msg, 1, len, g_file);
+}
+
+int main() {
+  g_file = fopen("binary_logging_bench.log", "wb");
+  Logger::setOutput(textOutput);
+  binlog::setOutput(binaryOutput);
+  int fd = 12;
+  std::string name("127.0.0.1:9981#1");
+
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < kN; ++i) {
+    LOG_INFO << "conn " << name << " fd=" << fd << " read " << i << " bytes";
+  }
+  Timestamp mid(Timestamp::now());
+  for (int i = 0; i < kN; ++i) {
+    LOG_BIN(INFO, "conn {} fd={} read {} bytes", name, fd, i);
+  }
+  binlog::flush();
+  Timestamp end(Timestamp::now());
+  fclose(g_file);
+
+  printf("text   %8.1f ns/call %6.1f bytes/call\n",
+         timeDifference(mid, start) * 1e9 / kN,
+         static_cast<double>(g_textBytes) / kN);
+  printf("binary %8.1f ns/call %6.1f bytes/call\n",
+         timeDifference(end, mid) * 1e9 / kN,
+         static_cast<double>(g_binaryBytes) / kN);
+}
@@ -0,0 +1,154 @@
+/**
+ * LengthHeaderCodec 的基准测试，模拟每次 read 读到 64KB 数据、包含大量小消息的情况：
+ * 把编码好的字节流按 64KB 切块，依次追加到输入缓冲区后调用解码，块的边界会截断消息
+ * 1. 拷贝：常见的写法，每条消息 readInt32 后拷贝到 std::string 再处理
+ * 2. LengthHeaderCodec：消息以 string_view 指向输入缓冲区，不拷贝
+ * 另外对比编码：消息体序列化到 Buffer 之后才知道长度，
+ * 拷贝到另一个写好长度头的 Buffer 与 直接 prepend 长度头
+ *
+ * 用法：./codec_bench [消息长度] [消息数]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+
+#include "../reactor/Buffer.h"
+#include "../reactor/LengthHeaderCodec.h"
+#include "../reactor/MessageDispatcher.h"
+
+using namespace jmuduo;
+
+const size_t kChunk = 65536;
+
+uint64_t g_sum = 0;  // 防止消息处理被优化掉
+void consume(std::string_view message) {
+  g_sum += message.size() + static_cast<unsigned char>(message[0]);
+}
+
+// 用 headerLen 字节的长度头编码 count 条长度为 len 的消息
+std::string makeStream(int headerLen, size_t len, int count) {
+  LengthHeaderCodec codec(nullptr, headerLen);
+  std::string stream;
+  std::string payload(len, 'x');
+  for (int i = 0; i < count; ++i) {
+    Buffer buf;
+    buf.append(payload);  // 序列化消息体
+    codec.encode(&buf);
+    stream.append(buf.peek(), buf.readableBytes());
+  }
+  return stream;
+}
+
+// 把 stream 按 kChunk 切块交给 decode，返回每秒处理的消息数
+template <typename Decode>
+double feed(const std::string& stream, int count, Decode&& decode) {
+  Buffer input;
+  Timestamp start(Timestamp::now());
+  for (size_t off = 0; off < stream.size(); off += kChunk) {
+    input.append(stream.data() + off, std::min(kChunk, stream.size() - off));
+    decode(&input);
+  }
+  double seconds = timeDifference(Timestamp::now(), start);
+  if (input.readableBytes() != 0) abort();
+  return count / seconds;
+}
+
+double decodeCopying(const std::string& stream, int count) {
+  return feed(stream, count, [](Buffer* buf) {
+    while (buf->readableBytes() >= sizeof(int32_t)) {
+      int32_t len = buf->peekInt32();
+      if (buf->readableBytes() < sizeof(int32_t) + len) break;
+      buf->retrieveInt32();
+      std::string message(buf->peek(), len);
+      buf->retrieve(len);
+      consume(message);
+    }
+  });
+}
+
+double decodeCodec(const std::string& stream, int count, int headerLen) {
+  LengthHeaderCodec codec(
+      [](const TcpConnectionPtr&, std::string_view message, Timestamp) {
+        consume(message);
+      },
+      headerLen);
+  TcpConnectionPtr conn;  // 解码出错时才会使用
+  return feed(stream, count, [&](Buffer* buf) {
+    codec.onMessage(conn, buf, Timestamp());
+  });
+}
+
+double decodeDispatcher(const std::string& stream, int count) {
+  auto handler = [](const TcpConnectionPtr&, std::string_view message,
+                    Timestamp) { consume(message); };
+  MessageDispatcher dispatcher(handler);
+  dispatcher.registerHandler(1, handler);
+  LengthHeaderCodec codec(
+      [&dispatcher](const TcpConnectionPtr& conn, std::string_view message,
+                    Timestamp t) { dispatcher.onFrame(conn, message, t); });
+  TcpConnectionPtr conn;
+  return feed(stream, count, [&](Buffer* buf) {
+    codec.onMessage(conn, buf, Timestamp());
+  });
+}
+
+// 编码 count 条消息，发送到同一个输出缓冲区
+double encodeAppendHeader(size_t len, int count) {
+  std::string payload(len, 'x');
+  Buffer buf;
+  Buffer message;
+  Buffer output;
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < count; ++i) {
+    buf.append(payload);  // 序列化消息体
+    message.appendInt32(static_cast<int32_t>(buf.readableBytes()));
+    message.append(buf.peek(), buf.readableBytes());
+    buf.retrieveAll();
+    output.append(message.peek(), message.readableBytes());  // 相当于 TcpConnection::send
+    message.retrieveAll();
+    if (output.readableBytes() > kChunk) output.retrieveAll();
+  }
+  return count / timeDifference(Timestamp::now(), start);
+}
+
+double encodePrepend(size_t len, int count) {
+  LengthHeaderCodec codec(nullptr);
+  std::string payload(len, 'x');
+  Buffer buf;
+  Buffer output;
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < count; ++i) {
+    buf.append(payload);  // 序列化消息体
+    codec.encode(&buf);
+    output.append(buf.peek(), buf.readableBytes());  // 相当于 TcpConnection::send
+    buf.retrieveAll();
+    if (output.readableBytes() > kChunk) output.retrieveAll();
+  }
+  return count / timeDifference(Timestamp::now(), start);
+}
+
+int main(int argc, char* argv[]) {
+  size_t len = argc > 1 ? atoi(argv[1]) : 32;
+  int count = argc > 2 ? atoi(argv[2]) : 5 * 1000 * 1000;
+  printf("%d messages of %zd bytes, %zd bytes per read\n", count, len, kChunk);
+
+  std::string stream4 = makeStream(4, len, count);
+  printf("%-30s %8.2f M msg/s\n", "decode, copy to string",
+         decodeCopying(stream4, count) / 1e6);
+  for (int headerLen : {1, 2, 4, 8}) {
+    if (headerLen == 1 && len > 255) continue;
+    std::string stream = makeStream(headerLen, len, count);
+    char name[64];
+    snprintf(name, sizeof name, "decode, codec %d-byte header", headerLen);
+    printf("%-30s %8.2f M msg/s\n", name,
+           decodeCodec(stream, count, headerLen) / 1e6);
+  }
+  printf("%-30s %8.2f M msg/s\n", "decode, codec + dispatcher",
+         decodeDispatcher(stream4, count) / 1e6);
+  printf("%-30s %8.2f M msg/s\n", "encode, append header",
+         encodeAppendHeader(len, count) / 1e6);
+  printf("%-30s %8.2f M msg/s\n", "encode, prepend header",
+         encodePrepend(len, count) / 1e6);
+  printf("checksum %lu\n", g_sum);
+}
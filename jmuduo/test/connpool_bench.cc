@@ -0,0 +1,190 @@
+/**
+ * ConnectionPool 的基准测试，上游为另一个 IO 线程中的 echo 服务，请求和响应都是一行文本。
+ * 对比四种访问上游的方式完成 N 个请求的吞吐：
+ * 1. 短连接：每个请求新建一条连接，收到响应后断开
+ * 2. 连接池，不流水线：每条连接同时只有一个未完成的请求
+ * 3. 连接池，流水线：每条连接同时有多个未完成的请求，按顺序对应响应
+ * 4. 连接池，流水线，关联编号：请求和响应中带有编号，按编号对应响应
+ *
+ * 用法：./connpool_bench [请求数] [连接数] [并发请求数]，使用 9984 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+
+#include "../reactor/Buffer.h"
+#include "../reactor/ConnectionPool.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+#include "../base/logging/Logging.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9984;
+const char kRequest[] = "hello, connection pool\n";
+
+// 发起 total 个请求，同时最多有 concurrency 个未完成的请求
+class Driver {
+ public:
+  using Issue = std::function<void(Driver*)>;
+
+  Driver(EventLoop* loop, int total, int concurrency, Issue issue)
+      : loop_(loop),
+        total_(total),
+        concurrency_(concurrency),
+        issued_(0),
+        done_(0),
+        issue_(std::move(issue)) {}
+
+  // 返回每秒完成的请求数
+  double run() {
+    start_ = Timestamp::now();
+    for (int i = 0; i < concurrency_ && issued_ < total_; ++i) next();
+    loop_->loop();
+    return done_ / timeDifference(Timestamp::now(), start_);
+  }
+
+  // 一个请求完成，发起下一个
+  void complete(bool ok) {
+    if (!ok) {
+      fprintf(stderr, "request failed\n");
+      abort();
+    }
+    if (++done_ == total_)
+      loop_->quit();
+    else if (issued_ < total_)
+      next();
+  }
+
+ private:
+  void next() {
+    ++issued_;
+    issue_(this);
+  }
+
+  EventLoop* loop_;
+  int total_;
+  int concurrency_;
+  int issued_;
+  int done_;
+  Issue issue_;
+  Timestamp start_;
+};
+
+// 1. 短连接
+double benchShortConnections(int total, int concurrency) {
+  EventLoop loop;
+  InetAddress upstream("127.0.0.1", kPort);
+  Driver driver(&loop, total, concurrency, [&loop, &upstream](Driver* d) {
+    auto client = std::make_shared<TcpClient>(&loop, upstream, "short");
+    client->setConnectionCallback([&loop, client, d](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(kRequest);
+      } else {
+        // 连接已经断开，在下一轮事件循环中销毁 client，打破循环引用
+        loop.queueInLoop([c = client] {});
+        client->setConnectionCallback(ConnectionCallback());
+      }
+    });
+    client->setMessageCallback(
+        [d, c = client.get()](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          if (buf->readableBytes() < sizeof kRequest - 1) return;
+          buf->retrieveAll();
+          c->disconnect();
+          d->complete(true);
+        });
+    client->connect();
+  });
+  return driver.run();
+}
+
+// 2~4. 连接池
+double benchPool(int total, int numConnections, int concurrency,
+                 size_t maxPending, bool withId) {
+  EventLoop loop;
+  ConnectionPool pool(&loop, InetAddress("127.0.0.1", kPort), "pool",
+                      numConnections);
+  pool.setMaxPendingPerConnection(maxPending);
+  if (withId) {
+    // 请求格式为 "<id> <request>"，echo 上游原样返回
+    pool.setCodec(
+        [](uint64_t id, std::string_view request, Buffer* buf) {
+          char head[32];
+          int n = snprintf(head, sizeof head, "%lu ", id);
+          buf->append(head, n);
+          buf->append(request.data(), request.size());
+        },
+        [](Buffer* buf, uint64_t* id, std::string* response) {
+          const char* eol = static_cast<const char*>(
+              memchr(buf->peek(), '\n', buf->readableBytes()));
+          if (eol == nullptr) return false;
+          char* end;
+          *id = strtoul(buf->peek(), &end, 10);
+          response->assign(static_cast<const char*>(end) + 1, eol + 1);
+          buf->retrieveUntil(eol + 1);
+          return true;
+        },
+        false);
+  }
+  pool.start();
+  // 等待所有连接建立。TimerQueue 不能取消定时器，之后定时器空转
+  bool waiting = true;
+  loop.runEvery(0.01, [&] {
+    if (waiting && pool.numConnected() == numConnections) {
+      waiting = false;
+      loop.quit();
+    }
+  });
+  loop.loop();
+
+  Driver driver(&loop, total, concurrency, [&pool](Driver* d) {
+    bool ok = pool.call(kRequest, [d](const std::string* response) {
+      d->complete(response != nullptr && *response == kRequest);
+    });
+    if (!ok) {
+      fprintf(stderr, "no connection available\n");
+      abort();
+    }
+  });
+  double qps = driver.run();
+  pool.stop();
+  return qps;
+}
+
+int main(int argc, char* argv[]) {
+  int total = argc > 1 ? atoi(argv[1]) : 100000;
+  int numConnections = argc > 2 ? atoi(argv[2]) : 4;
+  int concurrency = argc > 3 ? atoi(argv[3]) : 64;
+  Logger::setLogLevel(Logger::WARN);
+
+  // 上游 echo 服务运行在另一个 IO 线程中
+  EventLoopThread upstreamThread;
+  EventLoop* upstreamLoop = upstreamThread.startLoop();
+  // 上游服务在进程退出时不析构，避免和 IO 线程竞争
+  TcpServer& server = *new TcpServer(upstreamLoop, InetAddress(kPort));
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    conn->send(buf->retrieveAsString());
+  });
+  upstreamLoop->runInLoop([&server] { server.start(); });
+
+  printf("%d requests, %d connections, %d concurrent requests\n", total,
+         numConnections, concurrency);
+  // 短连接受限于临时端口数量（TIME_WAIT），只发送少量请求
+  int shortTotal = total / 10;
+  printf("%-28s %10.0f req/s\n", "short connections",
+         benchShortConnections(shortTotal, numConnections));
+  printf("%-28s %10.0f req/s\n", "pool, no pipelining",
+         benchPool(total, numConnections, numConnections, 1, false));
+  printf("%-28s %10.0f req/s\n", "pool, pipelined",
+         benchPool(total, numConnections, concurrency, SIZE_MAX, false));
+  printf("%-28s %10.0f req/s\n", "pool, pipelined, with id",
+         benchPool(total, numConnections, concurrency, SIZE_MAX, true));
+}
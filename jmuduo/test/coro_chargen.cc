@@ -0,0 +1,69 @@
+/**
+ * chargen 协议的协程版本。一直发送数据，丢弃收到的数据。
+ * 每次等待输出缓冲区被清空后再发送下一份数据，相当于在 onWriteComplete 中发送，
+ * 保证发送数据的速度不快于客户端接收的速度
+ *
+ * 用法：./coro_chargen [IO 线程数]，监听 9981 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpConnection.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+std::string message;
+
+CoTask chargen(TcpConnectionPtr conn) {
+  int64_t bytes = 0;
+  while (co_await conn->write(message)) bytes += message.size();
+  printf("chargen(): connection [%s] is down, sent %lld bytes\n",
+         conn->getName().c_str(), static_cast<long long>(bytes));
+}
+
+// 丢弃收到的数据
+CoTask discard(TcpConnectionPtr conn) {
+  while (Buffer* buf = co_await conn->readSome()) buf->retrieveAll();
+}
+
+void onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    printf("onConnection(): tid=%d new connection [%s] from %s\n",
+           CurrentThread::tid(), conn->getName().c_str(),
+           conn->getPeerAddr().toHostPort().c_str());
+    discard(conn);
+    chargen(conn);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  printf("main(): pid = %d\n", getpid());
+
+  std::string line;
+  // ascii 码 33-127 之间所有可打印的字符，line=[33-127]
+  for (int i = 33; i < 127; ++i) {
+    line.push_back(i);
+  }
+  line += line;  // line=[33-127,33-127]
+  // message 是 127-33 行数据，每一行为 char(i) 开头的连续 72 个字符
+  for (size_t i = 0; i < 127 - 33; ++i) {
+    message += line.substr(i, 72) + '\n';
+  }
+
+  InetAddress listenAddr(9981);
+  EventLoop loop;
+  TcpServer server(&loop, listenAddr);
+  server.setConnectionCallback(onConnection);
+  if (argc > 1) {
+    server.setThreadNum(atoi(argv[1]));
+  }
+  server.start();
+
+  loop.loop();
+}
@@ -0,0 +1,50 @@
+/**
+ * echo 协议的协程版本。每个连接一个协程，把读到的数据原样发回，
+ * 并等待数据发送完毕后再继续读取，发送速度不会快于客户端的接收速度
+ *
+ * 用法：./coro_echo [IO 线程数]，监听 9981 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpConnection.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+CoTask echo(TcpConnectionPtr conn) {
+  // 连接断开时 readSome 返回 nullptr
+  while (Buffer* buf = co_await conn->readSome()) {
+    // 发送并清空输入缓冲区，等待发送完毕期间到达的数据会留在输入缓冲区中
+    if (!co_await conn->write(buf)) break;
+  }
+  printf("echo(): connection [%s] is down\n", conn->getName().c_str());
+}
+
+void onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    printf("onConnection(): tid=%d new connection [%s] from %s\n",
+           CurrentThread::tid(), conn->getName().c_str(),
+           conn->getPeerAddr().toHostPort().c_str());
+    conn->setTcpNoDelay(true);
+    echo(conn);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  printf("main(): pid = %d\n", getpid());
+
+  InetAddress listenAddr(9981);
+  EventLoop loop;
+  TcpServer server(&loop, listenAddr);
+  server.setConnectionCallback(onConnection);
+  if (argc > 1) {
+    server.setThreadNum(atoi(argv[1]));
+  }
+  server.start();
+
+  loop.loop();
+}
@@ -0,0 +1,62 @@
+/**
+ * 用协程编写多步骤协议的例子。客户端每次发送一个请求：
+ *   <延迟秒数> <长度>\r\n<长度个字节的数据>
+ * 服务端等待指定的延迟后，回复 "ok <长度>\r\n" 和原数据
+ * 用回调实现时，需要在 onMessage 中维护解析状态，并用 runAfter 拆分回复
+ *
+ * 用法：./coro_protocol，监听 9981 端口，可以用 nc 测试：
+ *   printf '0.5 5\r\nhello' | nc localhost 9981
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpConnection.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+CoTask session(TcpConnectionPtr conn) {
+  while (true) {
+    std::string header = co_await conn->readUntil("\r\n");
+    double delay = 0;
+    int len = 0;
+    if (header.empty() || sscanf(header.c_str(), "%lf %d", &delay, &len) != 2 ||
+        len < 0) {
+      break;  // 连接断开或请求格式错误
+    }
+    std::string body = co_await conn->readExactly(len);
+    if (body.size() != static_cast<size_t>(len)) break;
+
+    co_await conn->getLoop()->sleep(delay);
+    if (!co_await conn->write("ok " + std::to_string(len) + "\r\n")) break;
+    if (!co_await conn->write(body)) break;
+  }
+  conn->shutdown();
+}
+
+void onConnection(const TcpConnectionPtr& conn) {
+  if (conn->connected()) {
+    printf("onConnection(): new connection [%s] from %s\n",
+           conn->getName().c_str(), conn->getPeerAddr().toHostPort().c_str());
+    session(conn);
+  } else {
+    printf("onConnection(): connection [%s] is down\n",
+           conn->getName().c_str());
+  }
+}
+
+int main() {
+  printf("main(): pid = %d\n", getpid());
+
+  InetAddress listenAddr(9981);
+  EventLoop loop;
+  TcpServer server(&loop, listenAddr);
+  server.setConnectionCallback(onConnection);
+  server.start();
+
+  loop.loop();
+}
@@ -0,0 +1,141 @@
+/**
+ * 延迟写（TcpConnection::setDeferredFlush）的基准测试。服务端和客户端在同一个事件循环中，
+ * 客户端的每条连接一次发送 depth 个流水线请求（每个请求一行），收到全部响应后再发送下一批；
+ * 服务端对每个请求调用一次 send。对比：
+ * 1. immediate：每次 send 都直接 write，一批请求产生 depth 次系统调用
+ * 2. deferred：同一轮事件循环中的 send 合并，在最后用一次 write 发出
+ * 服务端的 write 次数由 /proc/self/io 的 syscw 减去客户端的 write 次数得到
+ *
+ * 用法：./deferred_flush_bench [连接数] [秒数]，使用 9989 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9989;
+const char kRequest[] = "GET /key/0123456789\n";
+const size_t kRequestLen = sizeof kRequest - 1;
+
+bool g_deferred = false;
+
+// 进程发起的 write 类系统调用次数
+int64_t writeSyscalls() {
+  FILE* fp = fopen("/proc/self/io", "r");
+  if (fp == nullptr) return -1;
+  char line[128];
+  int64_t n = -1;
+  while (fgets(line, sizeof line, fp) != nullptr) {
+    if (strncmp(line, "syscw:", 6) == 0) n = strtoll(line + 6, nullptr, 10);
+  }
+  fclose(fp);
+  return n;
+}
+
+struct Result {
+  double qps;
+  double writesPerRequest;
+};
+
+Result run(EventLoop* loop, int numConnections, int depth, double seconds) {
+  std::string batch;
+  for (int i = 0; i < depth; ++i) batch += kRequest;
+
+  int64_t requests = 0;
+  int64_t clientWrites = 0;
+  bool measuring = false;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < numConnections; ++i) {
+    clients.emplace_back(
+        new TcpClient(loop, InetAddress("127.0.0.1", kPort), "client"));
+    TcpClient* client = clients.back().get();
+    client->setConnectionCallback([&](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(batch);
+      }
+    });
+    // 每个响应和请求一样长，收到一整批后发送下一批
+    client->setMessageCallback(
+        [&, depth](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          size_t batchLen = kRequestLen * depth;
+          while (buf->readableBytes() >= batchLen) {
+            buf->retrieve(batchLen);
+            if (measuring) {
+              requests += depth;
+              ++clientWrites;
+            }
+            conn->send(batch);
+          }
+        });
+    client->connect();
+  }
+
+  Timestamp start;
+  int64_t startWrites = 0;
+  Result result;
+  // 预热 0.2 秒后开始计数
+  loop->runAfter(0.2, [&] {
+    measuring = true;
+    start = Timestamp::now();
+    startWrites = writeSyscalls();
+  });
+  loop->runAfter(0.2 + seconds, [&] {
+    measuring = false;
+    double elapsed = timeDifference(Timestamp::now(), start);
+    int64_t serverWrites = writeSyscalls() - startWrites - clientWrites;
+    result.qps = requests / elapsed;
+    result.writesPerRequest = static_cast<double>(serverWrites) / requests;
+    for (auto& client : clients) client->disconnect();
+    loop->runAfter(0.1, [loop] { loop->quit(); });
+  });
+  loop->loop();
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  int numConnections = argc > 1 ? atoi(argv[1]) : 4;
+  double seconds = argc > 2 ? atof(argv[2]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+
+  EventLoop loop;
+  TcpServer server(&loop, InetAddress(kPort));
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) {
+      conn->setTcpNoDelay(true);
+      conn->setDeferredFlush(g_deferred);
+    }
+  });
+  // 每个请求一个响应，每个响应调用一次 send
+  server.setMessageCallback(
+      [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+        while (const char* eol = buf->findEOL()) {
+          conn->send(buf->peek(), eol + 1 - buf->peek());
+          buf->retrieveUntil(eol + 1);
+        }
+      });
+  server.start();
+
+  printf("%d connections\n", numConnections);
+  printf("%6s %14s %14s %14s %14s\n", "depth", "immediate", "writes/req",
+         "deferred", "writes/req");
+  for (int depth = 1; depth <= 64; depth *= 4) {
+    g_deferred = false;
+    Result immediate = run(&loop, numConnections, depth, seconds);
+    g_deferred = true;
+    Result deferred = run(&loop, numConnections, depth, seconds);
+    printf("%6d %10.0f/s %14.2f %10.0f/s %14.2f\n", depth, immediate.qps,
+           immediate.writesPerRequest, deferred.qps, deferred.writesPerRequest);
+  }
+}
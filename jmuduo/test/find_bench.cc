@@ -0,0 +1,120 @@
+/**
+ * Buffer 分隔符查找的基准测试
+ * 1. 不同长度（64B~64KB）的数据，分隔符在末尾，对比逐字节查找、memmem 和
+ *    Buffer::findCRLF/findEOL 的吞吐
+ * 2. 一行 64KB 的数据分 1KB 多次到达，对比每次从头查找和从上次的位置继续查找
+ *
+ * 用法：./find_bench [每项扫描的总字节数 MB]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../base/datetime/Timestamp.h"
+#include "../reactor/Buffer.h"
+
+using namespace jmuduo;
+
+// 常见的写法，逐字节查找
+const char* naiveCRLF(const char* begin, const char* end) {
+  for (const char* p = begin; p + 1 < end; ++p)
+    if (p[0] == '\r' && p[1] == '\n') return p;
+  return nullptr;
+}
+
+const char* naiveEOL(const char* begin, const char* end) {
+  for (const char* p = begin; p < end; ++p)
+    if (*p == '\n') return p;
+  return nullptr;
+}
+
+const char* memmemCRLF(const char* begin, const char* end) {
+  return static_cast<const char*>(::memmem(begin, end - begin, "\r\n", 2));
+}
+
+// 返回 GB/s
+template <typename Find>
+double bench(const Buffer& buf, size_t totalBytes, Find&& find) {
+  size_t len = buf.readableBytes();
+  size_t iterations = totalBytes / len + 1;
+  const char* expected = buf.beginWrite() - 2;
+  Timestamp start(Timestamp::now());
+  for (size_t i = 0; i < iterations; ++i) {
+    const char* found = find(buf);
+    // 阻止编译器把查找移出循环
+    asm volatile("" : : "r"(found) : "memory");
+    if (found != expected && found != expected + 1) abort();
+  }
+  double seconds = timeDifference(Timestamp::now(), start);
+  return static_cast<double>(iterations * len) / seconds / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+  size_t totalBytes = (argc > 1 ? atoi(argv[1]) : 1024) * 1024 * 1024UL;
+
+  printf("%8s %10s %10s %10s %10s %10s\n", "size", "naive crlf", "memmem",
+         "findCRLF", "naive eol", "findEOL");
+  for (size_t len = 64; len <= 64 * 1024; len *= 4) {
+    // 除了末尾的 "\r\n" 之外，数据中有单独的 '\r' 和 '\n'
+    Buffer buf;
+    for (size_t i = 0; i < len - 2; ++i) {
+      bool cr = i % 61 == 60;
+      bool lf = i % 67 == 66 && i % 61 != 0;  // 前一个字节不是 '\r'
+      buf.append(cr ? "\r" : (lf ? "\n" : "a"), 1);
+    }
+    buf.append("\r\n", 2);
+
+    double naive = bench(buf, totalBytes, [](const Buffer& b) {
+      return naiveCRLF(b.peek(), b.beginWrite());
+    });
+    double mm = bench(buf, totalBytes, [](const Buffer& b) {
+      return memmemCRLF(b.peek(), b.beginWrite());
+    });
+    double simd = bench(buf, totalBytes, [](const Buffer& b) {
+      return b.findCRLF();
+    });
+
+    // 查找 '\n' 使用没有单独 '\n' 的数据
+    Buffer line;
+    line.append(std::string(len - 1, 'a'));
+    line.append("\n", 1);
+    double naiveEol = bench(line, totalBytes, [](const Buffer& b) {
+      return naiveEOL(b.peek(), b.beginWrite());
+    });
+    double eol = bench(line, totalBytes, [](const Buffer& b) {
+      return b.findEOL();
+    });
+    printf("%8zd %8.2fGB %8.2fGB %8.2fGB %8.2fGB %8.2fGB\n", len, naive, mm,
+           simd, naiveEol, eol);
+  }
+
+  // 64KB 的一行分 64 次到达，每次到达后查找一次
+  const size_t kLine = 64 * 1024, kChunk = 1024;
+  std::string chunk(kChunk, 'a');
+  for (int resume = 0; resume <= 1; ++resume) {
+    int rounds = 2000;
+    size_t scanned = 0;
+    Timestamp start(Timestamp::now());
+    for (int r = 0; r < rounds; ++r) {
+      Buffer buf;
+      size_t offset = 0;
+      const char* crlf = nullptr;
+      while (crlf == nullptr) {
+        if (buf.readableBytes() + kChunk >= kLine) {
+          buf.append(chunk.data(), kChunk - 2);
+          buf.append("\r\n", 2);
+        } else {
+          buf.append(chunk);
+        }
+        crlf = buf.findCRLF(offset);
+        scanned += buf.readableBytes() - offset;
+        // '\r' 可能是最后一个字节
+        if (resume && crlf == nullptr) offset = buf.readableBytes() - 1;
+      }
+    }
+    double seconds = timeDifference(Timestamp::now(), start);
+    printf("%s: %.0f us per 64KB line, %.1f KB scanned\n",
+           resume ? "resume from offset" : "rescan from start",
+           seconds * 1e6 / rounds, scanned / 1024.0 / rounds);
+  }
+}
@@ -0,0 +1,105 @@
+/**
+ * 流量控制的演示：快速的数据源 -> 代理 -> 慢速的消费者，都在同一个事件循环中
+ * 1. 数据源：每次输出缓冲区清空（WriteCompleteCallback）时再发送 64KB，尽可能快地发送
+ * 2. 代理：把数据源的数据转发给消费者
+ * 3. 消费者：每读取一次数据就 stopRead，10 毫秒后再 startRead，读取速度有限
+ * 不做流量控制时，代理从数据源读取的数据全部堆积在发往消费者的输出缓冲区中；
+ * 用 setFlowControl 后，输出缓冲区超过高水位时暂停读取数据源，缓冲区的大小有上限
+ * （超出高水位的部分最多是一次读取的数据量，取决于输入缓冲区和内核接收缓冲区的大小），
+ * 事件循环也不再忙于读取不能及时发出的数据
+ *
+ * 用法：./flow_control [秒数]，使用 9990 和 9991 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kSourcePort = 9990;
+const uint16_t kProxyPort = 9991;
+const size_t kHighWaterMark = 1024 * 1024;
+const size_t kLowWaterMark = 256 * 1024;
+
+bool g_flowControl = false;
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+  EventLoop loop;
+
+  // 数据源
+  std::string chunk(64 * 1024, 'x');
+  TcpServer source(&loop, InetAddress(kSourcePort));
+  source.setConnectionCallback([&chunk](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->send(chunk);
+  });
+  source.setWriteCompleteCallback(
+      [&chunk](const TcpConnectionPtr& conn) { conn->send(chunk); });
+  source.start();
+
+  // 代理，只服务一个消费者
+  TcpServer proxy(&loop, InetAddress(kProxyPort));
+  std::unique_ptr<TcpClient> backend;
+  TcpConnectionPtr front;
+  size_t peakBuffered = 0;
+  proxy.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (!conn->connected()) {
+      front.reset();
+      return;
+    }
+    front = conn;
+    backend.reset(
+        new TcpClient(&loop, InetAddress("127.0.0.1", kSourcePort), "backend"));
+    backend->setConnectionCallback([&](const TcpConnectionPtr& backendConn) {
+      if (backendConn->connected() && front && g_flowControl)
+        front->setFlowControl(backendConn, kHighWaterMark, kLowWaterMark);
+    });
+    backend->setMessageCallback(
+        [&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+          if (front) {
+            front->send(buf);
+            peakBuffered = std::max(peakBuffered,
+                                    front->outputBuffer()->readableBytes());
+          } else {
+            buf->retrieveAll();
+          }
+        });
+    backend->connect();
+  });
+  proxy.start();
+
+  for (int i = 0; i < 2; ++i) {
+    g_flowControl = i == 1;
+    peakBuffered = 0;
+    int64_t received = 0;
+    TcpClient consumer(&loop, InetAddress("127.0.0.1", kProxyPort), "consumer");
+    consumer.setMessageCallback(
+        [&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          received += buf->readableBytes();
+          buf->retrieveAll();
+          conn->stopRead();
+          loop.runAfter(0.01, [conn] { conn->startRead(); });
+        });
+    consumer.connect();
+    loop.runAfter(seconds, [&] {
+      printf("%-18s consumer received %6.1f MB, proxy peak output buffer %7.1f MB\n",
+             g_flowControl ? "flow control" : "no flow control",
+             received / 1e6, peakBuffered / 1e6);
+      consumer.disconnect();
+      backend->disconnect();
+      loop.runAfter(0.2, [&loop] { loop.quit(); });
+    });
+    loop.loop();
+    backend.reset();
+  }
+}
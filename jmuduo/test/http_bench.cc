@@ -0,0 +1,141 @@
+/**
+ * 类似 wrk 的 HTTP 压测工具，每个连接循环发送 GET 请求，统计每秒完成的请求数
+ * 1. 使用长连接，服务端关闭连接（如不支持 keep-alive）时自动重连并继续发送
+ * 2. pipeline > 1 时每个连接同时有多个未完成的请求
+ * 所有连接都在一个事件循环中，压测工具本身的开销很小
+ *
+ * 用法：./http_bench ip port path [连接数] [秒数] [pipeline]
+ * 对比 jmuduo HttpServer 和 pool/webserver（都使用 /var/www/html/hw.html）：
+ *   ./http_server 8000 & ./http_bench 127.0.0.1 8000 /hw.html 50 5
+ *   ./webserver 127.0.0.1 12345 & ./http_bench 127.0.0.1 12345 /hw.html 50 5 2>/dev/null
+ * webserver 每个响应后都会关闭连接（发送 RST），连接错误的日志输出到 stderr
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <memory>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpClient.h"
+
+using namespace jmuduo;
+
+struct Stats {
+  int64_t responses = 0;
+  int64_t non200 = 0;
+  int64_t connects = 0;
+  int64_t bytes = 0;
+};
+
+// 一个压测连接
+class Session : noncopyable {
+ public:
+  Session(EventLoop* loop, const InetAddress& addr, const std::string& request,
+          int pipeline, Stats* stats)
+      : client_(loop, addr, "bench"),
+        request_(request),
+        pipeline_(pipeline),
+        stats_(stats),
+        stopped_(false) {
+    client_.enableRetry();
+    client_.setConnectionCallback(
+        [this](const TcpConnectionPtr& conn) { onConnection(conn); });
+    client_.setMessageCallback(
+        [this](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          onMessage(conn, buf);
+        });
+  }
+
+  void start() { client_.connect(); }
+  void stop() {
+    stopped_ = true;
+    client_.stop();
+  }
+
+ private:
+  void onConnection(const TcpConnectionPtr& conn) {
+    if (conn->connected() && !stopped_) {
+      ++stats_->connects;
+      conn->setTcpNoDelay(true);
+      Buffer requests;
+      for (int i = 0; i < pipeline_; ++i) requests.append(request_);
+      conn->send(&requests);
+    }
+  }
+
+  void onMessage(const TcpConnectionPtr& conn, Buffer* buf) {
+    Buffer requests;
+    while (buf->readableBytes() > 0) {
+      // 响应头以空行结束
+      const char* end = static_cast<const char*>(
+          memmem(buf->peek(), buf->readableBytes(), "\r\n\r\n", 4));
+      if (end == nullptr) break;
+      end += 4;
+      size_t bodyLength = 0;
+      const char* cl = static_cast<const char*>(
+          memmem(buf->peek(), end - buf->peek(), "Content-Length:", 15));
+      if (cl != nullptr) bodyLength = strtoul(cl + 15, nullptr, 10);
+      size_t total = end - buf->peek() + bodyLength;
+      if (buf->readableBytes() < total) break;
+      if (memcmp(buf->peek(), "HTTP/1.1 200", 12) != 0 &&
+          memcmp(buf->peek(), "HTTP/1.0 200", 12) != 0)
+        ++stats_->non200;
+      ++stats_->responses;
+      stats_->bytes += total;
+      buf->retrieve(total);
+      if (!stopped_) requests.append(request_);
+    }
+    if (requests.readableBytes() > 0) conn->send(&requests);
+  }
+
+  TcpClient client_;
+  const std::string request_;
+  const int pipeline_;
+  Stats* stats_;
+  bool stopped_;
+};
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    printf("usage: %s ip port path [connections] [seconds] [pipeline]\n",
+           argv[0]);
+    return 1;
+  }
+  InetAddress addr(argv[1], static_cast<uint16_t>(atoi(argv[2])));
+  std::string path = argv[3];
+  int connections = argc > 4 ? atoi(argv[4]) : 50;
+  double seconds = argc > 5 ? atof(argv[5]) : 5;
+  int pipeline = argc > 6 ? atoi(argv[6]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+
+  std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + argv[1] +
+                        "\r\nConnection: keep-alive\r\n\r\n";
+  EventLoop loop;
+  Stats stats;
+  std::vector<std::unique_ptr<Session>> sessions;
+  for (int i = 0; i < connections; ++i) {
+    sessions.emplace_back(new Session(&loop, addr, request, pipeline, &stats));
+    sessions.back()->start();
+  }
+  Timestamp start(Timestamp::now());
+  double elapsed = 0;
+  loop.runAfter(seconds, [&] {
+    elapsed = timeDifference(Timestamp::now(), start);
+    for (auto& s : sessions) s->stop();
+    // 等待正在进行的连接被取消后再退出
+    loop.runAfter(0.1, [&loop] { loop.quit(); });
+  });
+  loop.loop();
+
+  printf("%d connections, pipeline %d, %.1fs\n", connections, pipeline,
+         elapsed);
+  printf("%12.0f requests/sec, %.2f MB/s, %ld responses, %ld non-200, %ld "
+         "connects\n",
+         stats.responses / elapsed, stats.bytes / elapsed / 1024 / 1024,
+         stats.responses, stats.non200, stats.connects);
+}
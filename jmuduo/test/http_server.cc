@@ -0,0 +1,74 @@
+/**
+ * HttpServer 的演示：
+ * 1. "/" 返回一段文本
+ * 2. 其他路径返回 docroot 下的文件（每次请求都读取文件，和 pool/webserver 相同），
+ *    不存在时返回 404
+ *
+ * 用法：./http_server [端口] [IO 线程数] [docroot]
+ *   curl -v http://127.0.0.1:8000/
+ *   echo "helloworld!" > /tmp/www/hw.html && ./http_server 8000 0 /tmp/www
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../base/logging/Logging.h"
+#include "../http/HttpRequest.h"
+#include "../http/HttpResponse.h"
+#include "../http/HttpServer.h"
+#include "../reactor/EventLoop.h"
+
+using namespace jmuduo;
+
+std::string g_docroot = "/var/www/html";
+
+// 读取整个文件，失败时返回 false
+bool readFile(const std::string& path, std::string* content) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  char buf[64 * 1024];
+  ssize_t n;
+  while ((n = ::read(fd, buf, sizeof buf)) > 0) content->append(buf, n);
+  ::close(fd);
+  return n == 0;
+}
+
+void onRequest(const HttpRequest& req, HttpResponse* resp) {
+  if (req.path() == "/") {
+    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setStatusMessage("OK");
+    resp->setContentType("text/plain");
+    resp->addHeader("Server", "jmuduo");
+    resp->setBody("hello, world!\n");
+    return;
+  }
+
+  std::string content;
+  // 不允许访问 docroot 之外的文件
+  if (req.method() == HttpRequest::kGet &&
+      req.path().find("..") == std::string::npos &&
+      readFile(g_docroot + req.path(), &content)) {
+    resp->setStatusCode(HttpResponse::k200Ok);
+    resp->setStatusMessage("OK");
+    resp->setContentType("text/html");
+    resp->setBody(std::move(content));
+  } else {
+    resp->setStatusCode(HttpResponse::k404NotFound);
+    resp->setStatusMessage("Not Found");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 8000);
+  int numThreads = argc > 2 ? atoi(argv[2]) : 0;
+  if (argc > 3) g_docroot = argv[3];
+  Logger::setLogLevel(Logger::WARN);
+
+  EventLoop loop;
+  HttpServer server(&loop, InetAddress(port));
+  server.setHttpCallback(onRequest);
+  server.setThreadNum(numThreads);
+  server.start();
+  loop.loop();
+}
@@ -7,8 +7,14 @@ int main() {
   { LOG_WARN << "log warning"; }
   { LOG_ERROR << "log erroe"; }
   { LOG_SYSERR << "log system error"; }
+  {
+    // 只输出第 0、4、8 次
+    for (int i = 0; i < 10; ++i) LOG_EVERY_N(INFO, 4) << "log every 4 " << i;
+    // 100 毫秒内只输出第一次
+    for (int i = 0; i < 10; ++i) LOG_EVERY_MS(WARN, 100) << "log every 100ms " << i;
+  }
   {
     LOG_FATAL << "log fatal";
     LOG_SYSFATAL << "log system fatal";
   }
-}
\ No newline at end of file
+}
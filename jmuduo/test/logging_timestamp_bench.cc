@@ -0,0 +1,97 @@
+/**
+ * 日志前端时间戳与线程 id 格式化的微基准测试
+ * 1. 旧实现：每条日志用 snprintf 格式化微秒和线程 id
+ * 2. 新实现：per thread 缓存秒级前缀和线程 id 字符串，每条日志只重写微秒部分
+ * 3. 端到端：LOG_INFO 输出到空的日志后端，统计每条日志的耗时
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/logging/Logging.h"
+#include "../base/thread/Thread.h"
+
+using namespace jmuduo;
+
+const int kLines = 1000 * 1000;
+
+// 防止编译器把格式化结果优化掉
+char g_sink[64];
+
+// 旧实现：跨秒时 gmtime_r+snprintf，每条日志 snprintf 微秒和线程 id
+void formatOld(Timestamp t) {
+  static __thread char lastTime[64];
+  static __thread int64_t lastSecond;
+  int64_t us = t.microSecondsSinceEpoch();
+  time_t seconds = static_cast<time_t>(us / Timestamp::kMicroSecondsPerSecond);
+  int microseconds = static_cast<int>(us % Timestamp::kMicroSecondsPerSecond);
+  if (seconds != lastSecond) {
+    lastSecond = seconds;
+    struct tm tm_time;
+    ::gmtime_r(&seconds, &tm_time);
+    snprintf(lastTime, sizeof lastTime, "%4d-%02d-%02d %02d:%02d:%02d",
+             tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
+             tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
+  }
+  Fmt micro(".%06dZ ", microseconds);
+  Fmt tid("%6d ", CurrentThread::tid());
+  memcpy(g_sink, lastTime, 19);
+  memcpy(g_sink + 19, micro.data(), micro.length());
+  memcpy(g_sink + 28, tid.data(), tid.length());
+}
+
+// 新实现：秒级前缀按秒缓存，线程 id 字符串按线程缓存
+void formatNew(Timestamp t) {
+  static __thread int64_t lastSecond;
+  int64_t seconds = t.secondsSinceEpoch();
+  if (seconds != lastSecond) {
+    lastSecond = seconds;
+    t.formatSeconds(g_sink);
+  }
+  t.formatMicroSeconds(g_sink + 19);
+  g_sink[26] = 'Z';
+  g_sink[27] = ' ';
+  memcpy(g_sink + 28, CurrentThread::tidString(),
+         CurrentThread::tidStringLength());
+}
+
+template <typename Func>
+void bench(const char* name, Func func) {
+  // 每 64 条日志推进 1 秒，模拟跨秒刷新前缀
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < kLines; ++i) {
+    func(Timestamp(start.microSecondsSinceEpoch() +
+                   static_cast<int64_t>(i) * 15625));
+  }
+  Timestamp end(Timestamp::now());
+  double ns = timeDifference(end, start) * 1e9 / kLines;
+  printf("%-12s %8.1f ns/line\n", name, ns);
+}
+
+void nullOutput(const char* msg, int len) {}
+
+int main() {
+  // 两种实现输出相同的 "YYYY-MM-DD HH:mm:ss.uuuuuuZ tid "，比较的是同样的工作
+  Timestamp now(Timestamp::now());
+  char expected[sizeof g_sink];
+  formatOld(now);
+  memcpy(expected, g_sink, sizeof g_sink);
+  formatNew(now);
+  if (memcmp(expected, g_sink, 28 + CurrentThread::tidStringLength()) != 0) {
+    printf("output mismatch: %.35s vs %.35s\n", expected, g_sink);
+    return 1;
+  }
+
+  bench("old format", formatOld);
+  bench("new format", formatNew);
+
+  Logger::setOutput(nullOutput);
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < kLines; ++i) {
+    LOG_INFO << "hello";
+  }
+  Timestamp end(Timestamp::now());
+  printf("%-12s %8.1f ns/line\n", "LOG_INFO",
+         timeDifference(end, start) * 1e9 / kLines);
+}
@@ -0,0 +1,109 @@
+/**
+ * LogStream 数字格式化的基准测试，对比旧实现：
+ * 1. 整数：逐位除法 + 反转 vs 两位查表
+ * 2. 浮点数：snprintf("%.12g") vs std::to_chars 最短 round-trip
+ * 3. Fmt：snprintf vs 内置的格式说明解析
+ * 开始计时前先检查 Fmt 和 snprintf 的输出相同
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/logging/LogStream.h"
+
+using namespace jmuduo;
+
+const int kN = 1000 * 1000;
+
+// 旧实现的整数转换，逐位除法
+const char digits[] = "9876543210123456789";
+const char* zero = digits + 9;
+
+template <typename T>
+size_t convertOld(char buf[], T value) {
+  T i = value;
+  char* p = buf;
+  do {
+    int lsd = static_cast<int>(i % 10);
+    i /= 10;
+    *p++ = zero[lsd];
+  } while (i != 0);
+  if (value < 0) *p++ = '-';
+  *p = '\0';
+  std::reverse(buf, p);
+  return p - buf;
+}
+
+// Fmt 的输出和 snprintf 不同时打印并返回 false
+template <typename T>
+bool checkFmt(const char* fmt, T val) {
+  char expected[32];
+  snprintf(expected, sizeof expected, fmt, val);
+  Fmt f(fmt, val);
+  if (static_cast<size_t>(f.length()) == strlen(expected) &&
+      memcmp(f.data(), expected, f.length()) == 0)
+    return true;
+  printf("Fmt(\"%s\") mismatch: [%.*s] vs snprintf [%s]\n", fmt, f.length(),
+         f.data(), expected);
+  return false;
+}
+
+template <typename Func>
+void bench(const char* name, Func func) {
+  Timestamp start(Timestamp::now());
+  size_t bytes = 0;
+  for (int i = 0; i < kN; ++i) bytes += func(i);
+  Timestamp end(Timestamp::now());
+  printf("%-24s %8.1f ns/op  (%zu bytes)\n", name,
+         timeDifference(end, start) * 1e9 / kN, bytes);
+}
+
+int main() {
+  bool ok = checkFmt("%d", static_cast<short>(-5)) &&
+            checkFmt("%6d", static_cast<short>(-32768)) &&
+            checkFmt("%d", static_cast<char>(-5)) &&
+            checkFmt("%d", static_cast<char>(-128)) &&
+            checkFmt("%d", -2147483647 - 1) &&
+            checkFmt("%lld", INT64_MIN) &&
+            checkFmt("%x", static_cast<unsigned short>(0xfffb)) &&
+            checkFmt("%08.3f", -3.14159) && checkFmt("%e", 1e300) &&
+            checkFmt("v=%12.3f ms", 1e300);
+  if (!ok) return 1;
+
+  char buf[64];
+  LogStream os;
+
+  bench("int64 old", [&](int i) {
+    return convertOld(buf, static_cast<int64_t>(i) * 1234567891LL);
+  });
+  bench("int64 LogStream", [&](int i) {
+    os.resetBuffer();
+    os << static_cast<int64_t>(i) * 1234567891LL;
+    return static_cast<size_t>(os.buffer().length());
+  });
+
+  bench("double snprintf %.12g", [&](int i) {
+    return static_cast<size_t>(snprintf(buf, sizeof buf, "%.12g", i * 1.1));
+  });
+  bench("double LogStream", [&](int i) {
+    os.resetBuffer();
+    os << i * 1.1;
+    return static_cast<size_t>(os.buffer().length());
+  });
+
+  bench("Fmt snprintf %08.3f", [&](int i) {
+    return static_cast<size_t>(snprintf(buf, sizeof buf, "%08.3f", i * 0.7));
+  });
+  bench("Fmt %08.3f", [&](int i) {
+    return static_cast<size_t>(Fmt("%08.3f", i * 0.7).length());
+  });
+  bench("Fmt snprintf %6d", [&](int i) {
+    return static_cast<size_t>(snprintf(buf, sizeof buf, "%6d", i));
+  });
+  bench("Fmt %6d", [&](int i) {
+    return static_cast<size_t>(Fmt("%6d", i).length());
+  });
+}
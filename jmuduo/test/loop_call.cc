@@ -0,0 +1,88 @@
+/**
+ * EventLoop::call 的例子和基准测试
+ * 1. 往返延迟：从其他线程阻塞地获取 IO 线程中的数据，
+ *    对比 call().get() 和手写的 runInLoop + MutexLock + Condition
+ * 2. 后续回调：IO 线程的结果交给 baseLoop 中的回调处理
+ * 3. 扇出/扇入：callAll 查询所有 IO 线程，whenAll 在 baseLoop 中汇总
+ *
+ * 用法：./loop_call [IO 线程数] [往返次数]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <numeric>
+#include <vector>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/thread/Condition.h"
+#include "../base/thread/Mutex.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThreadPool.h"
+
+using namespace jmuduo;
+
+// 每个 IO 线程的事件循环中的数据，只在该线程中访问，不需要加锁
+__thread int t_ticks = 0;
+
+// 手写的跨线程请求/响应
+int callWithCondition(EventLoop* loop) {
+  MutexLock mutex;
+  Condition cond(mutex);
+  bool done = false;
+  int result = 0;
+  loop->runInLoop([&] {
+    int ticks = t_ticks;
+    MutexLockGuard lock(mutex);
+    result = ticks;
+    done = true;
+    cond.notify();
+  });
+  MutexLockGuard lock(mutex);
+  while (!done) cond.wait();
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  int numThreads = argc > 1 ? atoi(argv[1]) : 4;
+  int rounds = argc > 2 ? atoi(argv[2]) : 20000;
+
+  EventLoop baseLoop;
+  EventLoopThreadPool pool(&baseLoop);
+  pool.setThreadNum(numThreads);
+  pool.start();
+  std::vector<EventLoop*> loops = pool.getAllLoops();
+  for (EventLoop* loop : loops) {
+    loop->runInLoop([loop] { loop->runEvery(0.01, [] { ++t_ticks; }); });
+  }
+
+  // baseLoop 还没有开始运行，可以在这里阻塞等待其他事件循环的结果
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < rounds; ++i) callWithCondition(loops[0]);
+  double condUs = timeDifference(Timestamp::now(), start) * 1e6 / rounds;
+
+  start = Timestamp::now();
+  for (int i = 0; i < rounds; ++i) loops[0]->call([] { return t_ticks; }).get();
+  double callUs = timeDifference(Timestamp::now(), start) * 1e6 / rounds;
+  printf("round trip: runInLoop+Condition %.2f us, call().get() %.2f us\n",
+         condUs, callUs);
+
+  // 后续回调在 baseLoop 中执行
+  loops[0]->call([] { return CurrentThread::tid(); })
+      .then(&baseLoop, [&baseLoop](pid_t tid) {
+        baseLoop.assertInLoopThread();
+        printf("then(): io thread %d, delivered in base loop\n", tid);
+      });
+
+  // 1 秒后查询所有 IO 线程的数据并汇总
+  baseLoop.runAfter(1.0, [&] {
+    whenAll(pool.callAll([] { return t_ticks; }), &baseLoop,
+            [&baseLoop](std::vector<int> ticks) {
+              for (size_t i = 0; i < ticks.size(); ++i)
+                printf("whenAll(): loop %zu ticks %d\n", i, ticks[i]);
+              printf("whenAll(): total %d\n",
+                     std::accumulate(ticks.begin(), ticks.end(), 0));
+              baseLoop.quit();
+            });
+  });
+  baseLoop.loop();
+}
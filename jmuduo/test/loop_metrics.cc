@@ -0,0 +1,128 @@
+/**
+ * 事件循环运行统计（EventLoop::enableMetrics）的演示。echo 服务端运行在单独的 IO 线程中，
+ * 同时有一个 10ms 的周期定时器，主线程每 100ms 向服务端的事件循环投递一个耗时 1ms 的
+ * functor，模拟偶尔阻塞事件循环的任务；客户端在主线程中做 ping-pong
+ * 1. 先不开启统计、再开启统计各运行一段时间，对比 ping-pong 的速率，即统计的开销
+ * 2. 最后在主线程中读取服务端事件循环的统计快照并打印，快照不需要加锁
+ *
+ * 用法：./loop_metrics [连接数] [秒数]，使用 9995 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopMetrics.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9995;
+
+void busyWait(int64_t nanos) {
+  int64_t end = EventLoopMetrics::nowNanos() + nanos;
+  while (EventLoopMetrics::nowNanos() < end) {
+  }
+}
+
+// 以微秒打印纳秒的分布
+void printLatency(const char* name, const HistogramSnapshot& h) {
+  if (h.count() == 0) return;
+  printf("  %-22s n=%-9llu p50 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f us\n",
+         name, static_cast<unsigned long long>(h.count()),
+         h.percentile(50) / 1e3, h.percentile(99) / 1e3,
+         h.percentile(99.9) / 1e3, h.max() / 1e3);
+}
+
+void printCount(const char* name, const HistogramSnapshot& h) {
+  if (h.count() == 0) return;
+  printf("  %-22s n=%-9llu mean %6.2f  p99 %6llu  max %6llu\n", name,
+         static_cast<unsigned long long>(h.count()), h.mean(),
+         static_cast<unsigned long long>(h.percentile(99)),
+         static_cast<unsigned long long>(h.max()));
+}
+
+// ping-pong 一段时间，返回每秒的往返次数
+double pingPong(EventLoop* loop, int numConnections, double seconds) {
+  std::string message(64, 'x');
+  int64_t roundTrips = 0;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < numConnections; ++i) {
+    clients.emplace_back(
+        new TcpClient(loop, InetAddress("127.0.0.1", kPort), "client"));
+    clients.back()->setConnectionCallback([&message](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(message);
+      }
+    });
+    clients.back()->setMessageCallback(
+        [&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          if (buf->readableBytes() >= message.size()) {
+            ++roundTrips;
+            conn->send(buf->retrieveAsString());
+          }
+        });
+    clients.back()->connect();
+  }
+  Timestamp start = Timestamp::now();
+  double rate = 0;
+  loop->runAfter(seconds, [&] {
+    rate = roundTrips / timeDifference(Timestamp::now(), start);
+    for (auto& client : clients) client->disconnect();
+    loop->runAfter(0.2, [loop] { loop->quit(); });
+  });
+  loop->loop();
+  return rate;
+}
+
+int main(int argc, char* argv[]) {
+  int numConnections = argc > 1 ? atoi(argv[1]) : 4;
+  double seconds = argc > 2 ? atof(argv[2]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    conn->send(buf);
+  });
+  serverLoop->runInLoop([&server] { server.start(); });
+  serverLoop->runEvery(0.01, [] {});
+
+  EventLoop loop;
+  loop.runEvery(0.1, [serverLoop] {
+    serverLoop->runInLoop([] { busyWait(1000 * 1000); });
+  });
+  double plain = pingPong(&loop, numConnections, seconds);
+  serverLoop->enableMetrics();
+  double measured = pingPong(&loop, numConnections, seconds);
+  printf("ping-pong %d connections: %.0f/s without metrics, %.0f/s with metrics\n",
+         numConnections, plain, measured);
+
+  EventLoopMetrics::Snapshot s = serverLoop->metrics()->snapshot();
+  printf("server loop, %llu iterations\n",
+         static_cast<unsigned long long>(s.iterations));
+  printLatency("poll wait", s.pollWait);
+  printLatency("busy", s.busy);
+  printCount("active channels", s.activeChannels);
+  printCount("functor batch", s.functorBatch);
+  printLatency("functor time", s.functorTime);
+  printLatency("timer lateness", s.timerLateness);
+  for (int i = 0; i < Channel::kNumKinds; ++i) {
+    std::string name =
+        std::string("callback ") + Channel::kindName(static_cast<Channel::Kind>(i));
+    printLatency(name.c_str(), s.callback[i]);
+  }
+}
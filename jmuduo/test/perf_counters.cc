@@ -0,0 +1,140 @@
+/**
+ * 事件循环性能计数器（EventLoop::enablePerfCounters）的演示。echo 服务端运行在单独的 IO 线程中，
+ * 客户端在主线程中做 ping-pong，分两个阶段：
+ * 1. 系统调用为主：服务端收到消息后直接回显
+ * 2. 访存为主：服务端每收到一条消息，先在 64MB 的数组中随机访问若干次再回显
+ * 每个阶段结束时打印服务端事件循环计数器的增量，对比两个阶段的 IPC、cache miss 和内核态时间占比。
+ * perf 不可用（如虚拟机中没有 PMU、perf_event_paranoid 限制）时对应的计数器显示为 n/a
+ *
+ * 用法：./perf_counters [秒数]，使用 9999 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/PerfCounters.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9999;
+
+std::vector<uint64_t> g_table(8 * 1024 * 1024);  // 64MB
+std::atomic<bool> g_memoryBound(false);
+
+// 在 g_table 中随机访问，每次的下标依赖上一次读到的值，不能被预取
+uint64_t chase(uint64_t seed, int n) {
+  for (int i = 0; i < n; ++i)
+    seed = g_table[(seed * 6364136223846793005ULL + 1442695040888963407ULL) %
+                   g_table.size()] + seed;
+  return seed;
+}
+
+// ping-pong 一段时间，返回往返次数
+int64_t pingPong(EventLoop* loop, double seconds) {
+  std::string message(64, 'x');
+  int64_t roundTrips = 0;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < 2; ++i) {
+    clients.emplace_back(
+        new TcpClient(loop, InetAddress("127.0.0.1", kPort), "client"));
+    clients.back()->setConnectionCallback([&message](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(message);
+      }
+    });
+    clients.back()->setMessageCallback(
+        [&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          if (buf->readableBytes() >= message.size()) {
+            ++roundTrips;
+            conn->send(buf->retrieveAsString());
+          }
+        });
+    clients.back()->connect();
+  }
+  loop->runAfter(seconds, [&] {
+    for (auto& client : clients) client->disconnect();
+    loop->runAfter(0.2, [loop] { loop->quit(); });
+  });
+  loop->loop();
+  return roundTrips;
+}
+
+void printDelta(const char* phase, int64_t roundTrips,
+                const PerfCounters::Snapshot& before,
+                const PerfCounters::Snapshot& after) {
+  PerfCounters::Snapshot d = after;
+  for (int i = 0; i < PerfCounters::kNumCounters; ++i)
+    d.values[i] -= before.values[i];
+  d.userNanos -= before.userNanos;
+  d.systemNanos -= before.systemNanos;
+
+  printf("%s: %lld round trips\n", phase, static_cast<long long>(roundTrips));
+  for (int i = 0; i < PerfCounters::kNumCounters; ++i) {
+    const char* name =
+        PerfCounters::counterName(static_cast<PerfCounters::Counter>(i));
+    if (d.available[i])
+      printf("  %-18s %14llu%s\n", name, static_cast<unsigned long long>(d.values[i]),
+             d.userOnly[i] ? " (user)" : "");
+    else
+      printf("  %-18s %14s\n", name, "n/a");
+  }
+  if (d.available[PerfCounters::kCycles] &&
+      d.available[PerfCounters::kInstructions]) {
+    printf("  IPC %.2f, cache MPKI %.2f, branch MPKI %.2f\n", d.ipc(),
+           d.cacheMissesPerKiloInstructions(),
+           d.branchMissesPerKiloInstructions());
+  }
+  printf("  cpu user %.3fs system %.3fs (%.0f%% system)\n", d.userNanos / 1e9,
+         d.systemNanos / 1e9, d.systemRatio() * 100);
+}
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+  for (size_t i = 0; i < g_table.size(); ++i) g_table[i] = i * 2654435761ULL;
+
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    if (g_memoryBound) {
+      uint64_t x = chase(buf->readableBytes(), 2000);
+      if (x == 0) printf("unlikely\n");
+    }
+    conn->send(buf);
+  });
+  serverLoop->enablePerfCounters();
+  serverLoop->call([&server] { server.start(); }).get();
+
+  // snapshot 是事件循环最近一次读取的结果，阶段之间在 IO 线程中立即读取一次
+  auto sampled = [serverLoop] {
+    serverLoop->call([serverLoop] { serverLoop->perfCounters()->sample(); }).get();
+    return serverLoop->perfCounters()->snapshot();
+  };
+
+  EventLoop loop;
+  PerfCounters::Snapshot s0 = sampled();
+  int64_t n = pingPong(&loop, seconds);
+  PerfCounters::Snapshot s1 = sampled();
+  printDelta("syscall-bound echo", n, s0, s1);
+
+  g_memoryBound = true;
+  n = pingPong(&loop, seconds);
+  PerfCounters::Snapshot s2 = sampled();
+  printDelta("memory-bound echo", n, s1, s2);
+}
@@ -0,0 +1,179 @@
+/**
+ * 生产者消费者队列的基准测试，在不同的生产者/消费者数量下测量：
+ * 1. 吞吐：每秒传递的元素数
+ * 2. 传递延迟：元素从 push 到被 pop 的时间（p50/p99）
+ * 对比 BlockingQueue（逐个 take 和 take(n)）、BoundedBlockingQueue、SpscRing、MpmcRing
+ *
+ * 用法：./queue_bench [每个生产者的元素数]
+ */
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../base/thread/BlockingQueue.h"
+#include "../base/thread/BoundedBlockingQueue.h"
+#include "../base/thread/MpmcRing.h"
+#include "../base/thread/SpscRing.h"
+#include "../base/thread/Thread.h"
+
+using namespace jmuduo;
+
+const int kCapacity = 1024;
+const int kSampleEvery = 64;  // 每隔多少个元素记录一次延迟
+const int64_t kStop = -1;     // 通知消费者退出的元素
+
+int64_t nowNs() {
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* 把各种队列包装成相同的阻塞接口，无锁队列在满/空时让出 CPU 重试 */
+
+struct BlockingAdapter {
+  static const bool kSingleProducerConsumer = false;
+  BlockingQueue<int64_t> q;
+  void push(int64_t x) { q.put(x); }
+  template <typename F>
+  void consume(F&& f) {
+    while (f(q.take())) {}
+  }
+};
+
+struct BlockingBatchAdapter {
+  static const bool kSingleProducerConsumer = false;
+  BlockingQueue<int64_t> q;
+  void push(int64_t x) { q.put(x); }
+  template <typename F>
+  void consume(F&& f) {
+    while (true) {
+      std::vector<int64_t> batch = q.take(64);
+      for (size_t i = 0; i < batch.size(); ++i) {
+        if (!f(batch[i])) {
+          // 一次取到了多个退出通知，把多余的放回去留给其他消费者
+          for (size_t j = i + 1; j < batch.size(); ++j) q.put(batch[j]);
+          return;
+        }
+      }
+    }
+  }
+};
+
+struct BoundedAdapter {
+  static const bool kSingleProducerConsumer = false;
+  BoundedBlockingQueue<int64_t> q{kCapacity};
+  void push(int64_t x) { q.put(x); }
+  template <typename F>
+  void consume(F&& f) {
+    while (f(q.take())) {}
+  }
+};
+
+template <typename Ring>
+struct RingAdapter {
+  Ring q{kCapacity};
+  void push(int64_t x) {
+    while (!q.tryPush(x)) ::sched_yield();
+  }
+  template <typename F>
+  void consume(F&& f) {
+    int64_t x;
+    while (true) {
+      while (!q.tryPop(&x)) ::sched_yield();
+      if (!f(x)) return;
+    }
+  }
+};
+
+struct SpscAdapter : RingAdapter<SpscRing<int64_t>> {
+  static const bool kSingleProducerConsumer = true;
+};
+
+struct MpmcAdapter : RingAdapter<MpmcRing<int64_t>> {
+  static const bool kSingleProducerConsumer = false;
+};
+
+template <typename Adapter>
+void bench(const char* name, int producers, int consumers, int items) {
+  if (Adapter::kSingleProducerConsumer && (producers != 1 || consumers != 1))
+    return;
+
+  Adapter queue;
+  std::vector<std::vector<int64_t>> latencies(consumers);
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int i = 0; i < consumers; ++i) {
+    std::vector<int64_t>* samples = &latencies[i];
+    threads.emplace_back(new Thread([&queue, samples] {
+      int n = 0;
+      queue.consume([samples, &n](int64_t sent) {
+        if (sent == kStop) return false;
+        if (++n % kSampleEvery == 0) samples->push_back(nowNs() - sent);
+        return true;
+      });
+    }));
+  }
+
+  int64_t start = nowNs();
+  for (auto& t : threads) t->start();
+  std::vector<std::unique_ptr<Thread>> producerThreads;
+  for (int i = 0; i < producers; ++i) {
+    producerThreads.emplace_back(new Thread([&queue, items] {
+      for (int j = 0; j < items; ++j) queue.push(nowNs());
+    }));
+    producerThreads.back()->start();
+  }
+  for (auto& t : producerThreads) t->join();
+  for (int i = 0; i < consumers; ++i) queue.push(kStop);
+  for (auto& t : threads) t->join();
+  double seconds = static_cast<double>(nowNs() - start) / 1e9;
+
+  std::vector<int64_t> all;
+  for (auto& v : latencies) all.insert(all.end(), v.begin(), v.end());
+  std::sort(all.begin(), all.end());
+  int64_t p50 = all.empty() ? 0 : all[all.size() / 2];
+  int64_t p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+  printf("%-22s %2dP/%-2dC %8.2f Mops/s  p50 %8lld ns  p99 %10lld ns\n", name,
+         producers, consumers, producers * items / seconds / 1e6,
+         static_cast<long long>(p50), static_cast<long long>(p99));
+}
+
+// 只能移动的元素类型
+void testMoveOnly() {
+  BoundedBlockingQueue<std::unique_ptr<int>> bq(4);
+  bq.put(std::unique_ptr<int>(new int(1)));
+  bq.put(std::unique_ptr<int>(new int(2)));
+  std::vector<std::unique_ptr<int>> batch = bq.take(4);
+  if (batch.size() != 2 || *batch[1] != 2) abort();
+
+  BlockingQueue<std::unique_ptr<int>> q;
+  q.put(std::unique_ptr<int>(new int(3)));
+  if (*q.take() != 3) abort();
+
+  SpscRing<std::unique_ptr<int>> spsc(2);
+  MpmcRing<std::unique_ptr<int>> mpmc(2);
+  spsc.tryEmplace(new int(4));
+  mpmc.tryEmplace(new int(5));
+  std::unique_ptr<int> p;
+  if (!spsc.tryPop(&p) || *p != 4 || !mpmc.tryPop(&p) || *p != 5) abort();
+  mpmc.tryEmplace(new int(6));  // 析构时销毁剩余的元素
+}
+
+int main(int argc, char* argv[]) {
+  int items = argc > 1 ? atoi(argv[1]) : 200 * 1000;
+  testMoveOnly();
+
+  const int configs[][2] = {{1, 1}, {1, 4}, {4, 1}, {4, 4}};
+  for (auto& c : configs) {
+    bench<BlockingAdapter>("BlockingQueue", c[0], c[1], items);
+    bench<BlockingBatchAdapter>("BlockingQueue take(64)", c[0], c[1], items);
+    bench<BoundedAdapter>("BoundedBlockingQueue", c[0], c[1], items);
+    bench<SpscAdapter>("SpscRing", c[0], c[1], items);
+    bench<MpmcAdapter>("MpmcRing", c[0], c[1], items);
+  }
+}
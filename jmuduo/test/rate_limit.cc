@@ -0,0 +1,99 @@
+/**
+ * 连接限速（TcpConnection::setReadRateLimit/setWriteRateLimit）的演示，都在同一个事件循环中
+ * 1. 发送限速：服务端每次输出缓冲区清空时再发送 64KB，客户端尽可能快地读取，
+ *    客户端收到数据的速率应该等于限速
+ * 2. 读取限速：客户端每次输出缓冲区清空时再发送 64KB，服务端读取限速，
+ *    服务端读到数据的速率应该等于限速，输入缓冲区中的数据不超过一次读取的数据量，
+ *    其余的数据留在内核中，由 TCP 的滑动窗口使客户端停止发送
+ *
+ * 用法：./rate_limit [限速MB/s] [秒数]，使用 9993 和 9994 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kWritePort = 9993;
+const uint16_t kReadPort = 9994;
+const size_t kBurst = 256 * 1024;
+
+int main(int argc, char* argv[]) {
+  double rate = (argc > 1 ? atof(argv[1]) : 10) * 1e6;
+  double seconds = argc > 2 ? atof(argv[2]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+  EventLoop loop;
+  std::string chunk(64 * 1024, 'x');
+
+  // 发送限速的服务端
+  TcpServer writeServer(&loop, InetAddress(kWritePort));
+  writeServer.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (!conn->connected()) return;
+    conn->setWriteRateLimit(rate, kBurst);
+    conn->send(chunk);
+  });
+  writeServer.setWriteCompleteCallback(
+      [&chunk](const TcpConnectionPtr& conn) { conn->send(chunk); });
+  writeServer.start();
+
+  // 读取限速的服务端
+  int64_t serverReceived = 0;
+  size_t peakBuffered = 0;
+  TcpServer readServer(&loop, InetAddress(kReadPort));
+  readServer.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setReadRateLimit(rate, kBurst);
+  });
+  readServer.setMessageCallback([&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+    serverReceived += buf->readableBytes();
+    peakBuffered = std::max(peakBuffered, buf->readableBytes());
+    buf->retrieveAll();
+  });
+  readServer.start();
+
+  {
+    int64_t received = 0;
+    TcpClient client(&loop, InetAddress("127.0.0.1", kWritePort), "client");
+    client.setMessageCallback([&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+      received += buf->readableBytes();
+      buf->retrieveAll();
+    });
+    client.connect();
+    Timestamp start = Timestamp::now();
+    loop.runAfter(seconds, [&] {
+      double elapsed = timeDifference(Timestamp::now(), start);
+      printf("write limit %6.1f MB/s: client received %6.1f MB/s\n", rate / 1e6,
+             received / 1e6 / elapsed);
+      client.disconnect();
+      loop.runAfter(0.2, [&loop] { loop.quit(); });
+    });
+    loop.loop();
+  }
+
+  {
+    TcpClient client(&loop, InetAddress("127.0.0.1", kReadPort), "client");
+    client.setConnectionCallback([&chunk](const TcpConnectionPtr& conn) {
+      if (conn->connected()) conn->send(chunk);
+    });
+    client.setWriteCompleteCallback(
+        [&chunk](const TcpConnectionPtr& conn) { conn->send(chunk); });
+    client.connect();
+    Timestamp start = Timestamp::now();
+    loop.runAfter(seconds, [&] {
+      double elapsed = timeDifference(Timestamp::now(), start);
+      printf("read limit  %6.1f MB/s: server received %6.1f MB/s, "
+             "peak input buffer %zu KB\n",
+             rate / 1e6, serverReceived / 1e6 / elapsed, peakBuffered / 1024);
+      client.disconnect();
+      loop.runAfter(0.2, [&loop] { loop.quit(); });
+    });
+    loop.loop();
+  }
+}
@@ -0,0 +1,100 @@
+/**
+ * 统计页面服务（StatsServer）的演示。echo 服务使用 2 个 IO 线程，统计页面服务运行在
+ * 单独的 IO 线程中；主线程中的客户端一部分做 ping-pong，一部分建立连接后不发送数据。
+ * 运行一段时间后用 HTTP 请求获取统计页面并打印，同时打印获取页面的耗时
+ *
+ * 用法：./stats_server [秒数]，echo 服务使用 9996 端口，统计页面使用 9997 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../http/StatsServer.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/EventLoopThreadPool.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kEchoPort = 9996;
+const uint16_t kStatsPort = 9997;
+
+int main(int argc, char* argv[]) {
+  double seconds = argc > 1 ? atof(argv[1]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+
+  // echo 服务和统计页面服务在进程退出时不析构，避免和 IO 线程竞争
+  EventLoopThread echoThread;
+  EventLoop* echoLoop = echoThread.startLoop();
+  TcpServer& echo = *new TcpServer(echoLoop, InetAddress(kEchoPort));
+  echo.setThreadNum(2);
+  // 空闲连接单独归为一类，客户端建立连接后先发送一个字节表明自己是空闲连接
+  auto idle = std::make_shared<ConnectionStats>("idle");
+  echo.setMessageCallback([idle](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    if (buf->peek()[0] == 'i') {
+      buf->retrieve(1);
+      conn->setStats(idle);
+    }
+    conn->send(buf);
+  });
+  // 在启动后立即开启 IO 线程池的统计，否则要等到第一次获取统计页面时才开启
+  echoLoop->call([&echo] {
+    echo.start();
+    for (EventLoop* ioLoop : echo.threadPool()->getAllLoops())
+      ioLoop->enableMetrics();
+  }).get();
+
+  EventLoopThread statsThread;
+  EventLoop* statsLoop = statsThread.startLoop();
+  StatsServer& stats = *new StatsServer(statsLoop, InetAddress(kStatsPort));
+  statsLoop->call([&] {
+    stats.addServer(&echo);
+    stats.addConnectionStats(idle);
+    stats.start();
+  }).get();
+
+  EventLoop loop;
+  std::string message(1024, 'x');
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < 8; ++i) {
+    clients.emplace_back(
+        new TcpClient(&loop, InetAddress("127.0.0.1", kEchoPort), "client"));
+    bool isIdle = i % 2 == 0;
+    clients.back()->setConnectionCallback([&message, isIdle](const TcpConnectionPtr& conn) {
+      if (conn->connected()) conn->send(isIdle ? std::string("i") : message);
+    });
+    clients.back()->setMessageCallback(
+        [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          conn->send(buf);
+        });
+    clients.back()->connect();
+  }
+
+  std::string page;
+  Timestamp requested;
+  TcpClient scraper(&loop, InetAddress("127.0.0.1", kStatsPort), "scraper");
+  scraper.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (conn->connected()) {
+      requested = Timestamp::now();
+      conn->send("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    } else {
+      printf("%s\n", page.c_str());
+      printf("scrape took %.0f us\n",
+             timeDifference(Timestamp::now(), requested) * 1e6);
+      for (auto& client : clients) client->disconnect();
+      loop.runAfter(0.2, [&loop] { loop.quit(); });
+    }
+  });
+  scraper.setMessageCallback([&page](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+    page += buf->retrieveAsString();
+  });
+  loop.runAfter(seconds, [&scraper] { scraper.connect(); });
+  loop.loop();
+}
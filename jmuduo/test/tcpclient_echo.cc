@@ -0,0 +1,70 @@
+/**
+ * TcpClient 的演示：
+ * 1. 先连接一个没有监听的端口，观察 Connector 的指数退避重试（0.5s 1s 2s ...）
+ * 2. 3 秒后启动 echo 服务，重试成功后客户端每秒发送一条消息并打印回显
+ * 3. 第 3 条消息后服务端主动断开连接，启用了 enableRetry 的客户端自动重连
+ * 4. 收到 6 条回显后退出
+ *
+ * 用法：./tcpclient_echo，使用 9983 端口
+ */
+#include <stdio.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9983;
+
+int g_echoed = 0;
+
+void onServerMessage(const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+  std::string msg(buf->retrieveAsString());
+  conn->send(msg);
+  // 服务端在回显第 3 条消息后断开连接
+  if (msg == "hello 3\n") conn->shutdown();
+}
+
+int main() {
+  printf("main(): pid = %d\n", getpid());
+
+  EventLoop loop;
+  TcpClient client(&loop, InetAddress("127.0.0.1", kPort), "EchoClient");
+  client.enableRetry();
+  client.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    printf("client: connection [%s] is %s\n", conn->getName().c_str(),
+           conn->connected() ? "up" : "down");
+  });
+  client.setMessageCallback([&loop](const TcpConnectionPtr& conn, Buffer* buf,
+                                    Timestamp) {
+    printf("client: echo %s", buf->retrieveAsString().c_str());
+    if (++g_echoed == 6) loop.quit();
+  });
+  client.connect();
+
+  // 服务端在 3 秒后才开始监听
+  std::unique_ptr<TcpServer> server;
+  loop.runAfter(3.0, [&] {
+    printf("server: start listening on %d\n", kPort);
+    server.reset(new TcpServer(&loop, InetAddress(kPort)));
+    server->setMessageCallback(onServerMessage);
+    server->start();
+  });
+
+  int seq = 0;
+  loop.runEvery(1.0, [&] {
+    TcpConnectionPtr conn = client.connection();
+    if (conn && conn->connected()) {
+      char msg[32];
+      snprintf(msg, sizeof msg, "hello %d\n", ++seq);
+      conn->send(msg);
+    }
+  });
+
+  loop.loop();
+}
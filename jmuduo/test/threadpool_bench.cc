@@ -0,0 +1,184 @@
+/**
+ * 计算线程池的基准测试，对比两种实现在 1~64 个工作线程下的吞吐：
+ * 1. 单队列：所有线程共享一个 mutex+condition 保护的任务队列
+ * 2. ThreadPool：每个工作线程一个 Chase-Lev 队列，空闲时窃取
+ * 两种负载：
+ * 1. flat：主线程（相当于 IO 线程）提交大量小任务
+ * 2. fork-join：任务递归拆分出子任务，子任务在工作线程中提交
+ * 最后演示通过 EventLoop 接收计算结果
+ *
+ * 用法：./threadpool_bench [flat 任务数] [fork-join 深度]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/thread/Condition.h"
+#include "../base/thread/Mutex.h"
+#include "../base/thread/Thread.h"
+#include "../base/thread/ThreadPool.h"
+#include "../reactor/EventLoop.h"
+
+using namespace jmuduo;
+
+// 单个 mutex+condition 队列的线程池，作为对照
+class SimplePool : noncopyable {
+ public:
+  using Task = std::function<void()>;
+
+  SimplePool() : cond_(mutex_), running_(false) {}
+  ~SimplePool() { stop(); }
+
+  void start(int numThreads) {
+    running_ = true;
+    for (int i = 0; i < numThreads; ++i) {
+      threads_.emplace_back(new Thread([this] { loop(); }, "simple"));
+      threads_.back()->start();
+    }
+  }
+
+  void stop() {
+    {
+      MutexLockGuard lock(mutex_);
+      running_ = false;
+      cond_.notifyAll();
+    }
+    for (auto& t : threads_) t->join();
+    threads_.clear();
+  }
+
+  void run(Task task) {
+    MutexLockGuard lock(mutex_);
+    queue_.push_back(std::move(task));
+    cond_.notify();
+  }
+
+ private:
+  void loop() {
+    while (true) {
+      Task task;
+      {
+        MutexLockGuard lock(mutex_);
+        while (running_ && queue_.empty()) cond_.wait();
+        if (queue_.empty()) return;
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task();
+    }
+  }
+
+  MutexLock mutex_;
+  Condition cond_;
+  std::deque<Task> queue_;
+  bool running_;
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
+// 等待 count 个任务完成
+class Latch : noncopyable {
+ public:
+  explicit Latch(int64_t count) : count_(count), cond_(mutex_), done_(false) {}
+
+  void countDown() {
+    if (count_.fetch_sub(1) == 1) {
+      MutexLockGuard lock(mutex_);
+      done_ = true;
+      cond_.notifyAll();
+    }
+  }
+
+  void wait() {
+    MutexLockGuard lock(mutex_);
+    while (!done_) cond_.wait();
+  }
+
+ private:
+  std::atomic<int64_t> count_;
+  MutexLock mutex_;
+  Condition cond_;
+  bool done_;  // @GuardedBy mutex_
+};
+
+// 每个任务的计算量，约 1 微秒
+std::atomic<uint64_t> g_sink;
+void work(uint64_t seed) {
+  uint64_t x = seed;
+  for (int i = 0; i < 200; ++i)
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+  g_sink.fetch_add(x, std::memory_order_relaxed);
+}
+
+template <typename Pool>
+void forkJoin(Pool* pool, int depth, uint64_t seed, Latch* latch) {
+  if (depth == 0) {
+    work(seed);
+    latch->countDown();
+    return;
+  }
+  pool->run([=] { forkJoin(pool, depth - 1, seed * 2, latch); });
+  pool->run([=] { forkJoin(pool, depth - 1, seed * 2 + 1, latch); });
+}
+
+template <typename Pool>
+double benchFlat(int numThreads, int numTasks) {
+  Pool pool;
+  pool.start(numThreads);
+  Latch latch(numTasks);
+  Timestamp start(Timestamp::now());
+  for (int i = 0; i < numTasks; ++i) {
+    pool.run([i, &latch] {
+      work(i);
+      latch.countDown();
+    });
+  }
+  latch.wait();
+  return timeDifference(Timestamp::now(), start);
+}
+
+template <typename Pool>
+double benchForkJoin(int numThreads, int depth) {
+  Pool pool;
+  pool.start(numThreads);
+  Latch latch(int64_t(1) << depth);
+  Timestamp start(Timestamp::now());
+  pool.run([&pool, depth, &latch] { forkJoin(&pool, depth, 1, &latch); });
+  latch.wait();
+  return timeDifference(Timestamp::now(), start);
+}
+
+long fib(int n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+
+int main(int argc, char* argv[]) {
+  int numTasks = argc > 1 ? atoi(argv[1]) : 200 * 1000;
+  int depth = argc > 2 ? atoi(argv[2]) : 16;
+
+  printf("flat: %d tasks, fork-join: %d leaves\n", numTasks, 1 << depth);
+  printf("%8s %14s %14s %14s %14s\n", "threads", "flat simple", "flat stealing",
+         "fj simple", "fj stealing");
+  for (int n = 1; n <= 64; n *= 2) {
+    double flatSimple = benchFlat<SimplePool>(n, numTasks);
+    double flatStealing = benchFlat<ThreadPool>(n, numTasks);
+    double fjSimple = benchForkJoin<SimplePool>(n, depth);
+    double fjStealing = benchForkJoin<ThreadPool>(n, depth);
+    printf("%8d %12.0fms %12.0fms %12.0fms %12.0fms\n", n, flatSimple * 1000,
+           flatStealing * 1000, fjSimple * 1000, fjStealing * 1000);
+  }
+
+  // 计算在线程池中完成，结果在 IO 线程中处理
+  EventLoop loop;
+  ThreadPool pool("fib");
+  pool.start(2);
+  std::future<long> f = pool.submit([] { return fib(25); });
+  pool.submit([] { return fib(30); }, &loop, [&loop, &f](long result) {
+    loop.assertInLoopThread();
+    printf("fib(30) = %ld delivered in loop thread, fib(25) = %ld\n", result,
+           f.get());
+    loop.quit();
+  });
+  loop.loop();
+}
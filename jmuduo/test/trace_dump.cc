@@ -0,0 +1,128 @@
+/**
+ * 事件循环跟踪记录（Tracer）的演示
+ * 1. 测量一条记录的开销：没有开启时是一次判断；开启时和事件循环中一样，
+ *    相邻的区间共用读到的时间，每条记录读一次时钟
+ * 2. echo 服务端运行在单独的 IO 线程中，主线程每 100ms 向服务端的事件循环投递一个耗时 1ms 的
+ *    functor 模拟延迟尖刺，客户端在主线程中做 ping-pong。先不开启、再开启跟踪各运行一段时间，
+ *    对比 ping-pong 的速率，最后导出为 Chrome trace 的 JSON 文件，
+ *    用 chrome://tracing 或 ui.perfetto.dev 打开后可以看到阻塞事件循环的 functor
+ *
+ * 用法：./trace_dump [输出文件] [秒数]，使用 9998 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../base/metrics/Tracer.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9998;
+
+void busyWait(int64_t nanos) {
+  int64_t end = Tracer::now() + nanos;
+  while (Tracer::now() < end) {
+  }
+}
+
+// 每条记录的平均耗时，纳秒，和 EventLoop::loopInstrumented 中记录事件回调的方式相同
+double costPerEvent(int n) {
+  int64_t begin = Tracer::now();
+  int64_t start = begin;
+  for (int i = 0; i < n; ++i) {
+    if (Tracer::enabled()) {
+      int64_t end = Tracer::now();
+      Tracer::record("bench", start, end, i);
+      start = end;
+    }
+  }
+  return double(Tracer::now() - begin) / n;
+}
+
+// ping-pong 一段时间，返回每秒的往返次数
+double pingPong(EventLoop* loop, double seconds) {
+  std::string message(64, 'x');
+  int64_t roundTrips = 0;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (int i = 0; i < 2; ++i) {
+    clients.emplace_back(
+        new TcpClient(loop, InetAddress("127.0.0.1", kPort), "client"));
+    clients.back()->setConnectionCallback([&message](const TcpConnectionPtr& conn) {
+      if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        conn->send(message);
+      }
+    });
+    clients.back()->setMessageCallback(
+        [&](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          if (buf->readableBytes() >= message.size()) {
+            ++roundTrips;
+            conn->send(buf->retrieveAsString());
+          }
+        });
+    clients.back()->connect();
+  }
+  Timestamp start = Timestamp::now();
+  double rate = 0;
+  loop->runAfter(seconds, [&] {
+    rate = roundTrips / timeDifference(Timestamp::now(), start);
+    for (auto& client : clients) client->disconnect();
+    loop->runAfter(0.2, [loop] { loop->quit(); });
+  });
+  loop->loop();
+  return rate;
+}
+
+int main(int argc, char* argv[]) {
+  const char* path = argc > 1 ? argv[1] : "/tmp/jmuduo_trace.json";
+  double seconds = argc > 2 ? atof(argv[2]) : 1;
+  Logger::setLogLevel(Logger::WARN);
+
+  const int kBench = 10 * 1000 * 1000;
+  double disabled = costPerEvent(kBench);
+  Tracer::start();
+  double enabled = costPerEvent(kBench);
+  Tracer::stop();
+  printf("per event: %.1f ns disabled, %.1f ns enabled\n", disabled, enabled);
+
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  server.setConnectionCallback([](const TcpConnectionPtr& conn) {
+    if (conn->connected()) conn->setTcpNoDelay(true);
+  });
+  server.setMessageCallback([](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+    conn->send(buf);
+  });
+  serverLoop->call([&server] { server.start(); }).get();
+
+  EventLoop loop;
+  loop.runEvery(0.1, [serverLoop] {
+    serverLoop->runInLoop([] {
+      TraceSpan span("slowTask");
+      busyWait(1000 * 1000);
+    });
+  });
+  double plain = pingPong(&loop, seconds);
+  Tracer::start();
+  double traced = pingPong(&loop, seconds);
+  Tracer::stop();
+  printf("ping-pong: %.0f/s without tracing, %.0f/s with tracing\n", plain,
+         traced);
+
+  if (!Tracer::dumpToFile(path)) {
+    perror("dumpToFile");
+    return 1;
+  }
+  printf("trace written to %s\n", path);
+}
@@ -0,0 +1,133 @@
+/**
+ * UDP 收发的基准测试：同一进程中运行 UdpServer echo 服务（独立的线程）和客户端，
+ * 客户端的每个 socket 保持固定数量的数据报在途，收到回显后立即再发送一个，统计每秒往返的
+ * 数据报数和每次系统调用处理的数据报数。对比：
+ * 1. batch 1：每次 recvmmsg/sendmmsg 只处理一个数据报，相当于 recvfrom/sendto
+ * 2. batch 64：批量收发
+ * 3. batch 64 + GSO/GRO：内核合并/分段同一地址的数据报
+ *
+ * 用法：./udp_bench [服务端 IO 线程数] [客户端 socket 数] [每个 socket 在途数] [数据报长度] [秒数]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/UdpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9986;
+
+struct Options {
+  int serverThreads;
+  int clients;
+  int window;
+  size_t size;
+  double seconds;
+};
+
+struct Client {
+  std::unique_ptr<UdpSocket> socket;
+  int64_t sent = 0;
+  int64_t received = 0;
+};
+
+void runBench(const char* name, const Options& opt, int batch, bool offload) {
+  // 服务端运行在独立的线程中，UdpServer 在该线程中创建和析构
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  std::unique_ptr<UdpServer> server;
+  serverLoop->call([&] {
+    server.reset(new UdpServer(serverLoop, InetAddress(kPort), "UdpEcho"));
+    server->setThreadNum(opt.serverThreads);
+    server->setBatchSize(batch);
+    server->setGro(offload);
+    server->setGso(offload);
+    server->setMessageCallback([](UdpSocket* socket, const char* data,
+                                  size_t len, const InetAddress& peer,
+                                  Timestamp) { socket->send(data, len, peer); });
+    server->start();
+  }).get();
+
+  EventLoop loop;
+  InetAddress serverAddr("127.0.0.1", kPort);
+  std::string payload(opt.size, 'x');
+  std::vector<Client> clients(opt.clients);
+  for (Client& c : clients) {
+    c.socket.reset(new UdpSocket(&loop, InetAddress("127.0.0.1", 0)));
+    c.socket->setBatchSize(batch);
+    if (offload) {
+      c.socket->enableGro();
+      c.socket->enableGso();
+    }
+    Client* pc = &c;
+    c.socket->setMessageCallback([pc, &serverAddr](UdpSocket* socket,
+                                                   const char* data, size_t len,
+                                                   const InetAddress&, Timestamp) {
+      ++pc->received;
+      ++pc->sent;
+      socket->send(data, len, serverAddr);
+    });
+    c.socket->start();
+  }
+
+  // 补足在途的数据报，UDP 可能丢包
+  auto refill = [&] {
+    for (Client& c : clients) {
+      while (c.sent - c.received < opt.window) {
+        ++c.sent;
+        c.socket->send(payload.data(), payload.size(), serverAddr);
+      }
+    }
+  };
+  loop.runEvery(0.01, refill);
+  loop.runInLoop(refill);
+
+  int64_t startReceived = 0;
+  Timestamp start;
+  // 预热 0.2 秒后开始计数
+  loop.runAfter(0.2, [&] {
+    start = Timestamp::now();
+    for (Client& c : clients) startReceived += c.received;
+  });
+  loop.runAfter(0.2 + opt.seconds, [&] {
+    double elapsed = timeDifference(Timestamp::now(), start);
+    int64_t received = -startReceived;
+    uint64_t recvCalls = 0, sendCalls = 0, datagrams = 0;
+    for (Client& c : clients) {
+      received += c.received;
+      recvCalls += c.socket->recvSyscalls();
+      sendCalls += c.socket->sendSyscalls();
+      datagrams += c.socket->receivedDatagrams() + c.socket->sentDatagrams();
+    }
+    printf("%-24s %10.0f datagrams/s, %5.1f datagrams per client syscall\n",
+           name, received / elapsed,
+           static_cast<double>(datagrams) / (recvCalls + sendCalls));
+    loop.quit();
+  });
+  loop.loop();
+
+  clients.clear();
+  serverLoop->call([&] { server.reset(); }).get();
+}
+
+int main(int argc, char* argv[]) {
+  Options opt;
+  opt.serverThreads = argc > 1 ? atoi(argv[1]) : 1;
+  opt.clients = argc > 2 ? atoi(argv[2]) : 4;
+  opt.window = argc > 3 ? atoi(argv[3]) : 64;
+  opt.size = argc > 4 ? atoi(argv[4]) : 64;
+  opt.seconds = argc > 5 ? atof(argv[5]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+
+  printf("%d server threads, %d client sockets, window %d, %zd bytes\n",
+         opt.serverThreads, opt.clients, opt.window, opt.size);
+  runBench("batch 1", opt, 1, false);
+  runBench("batch 64", opt, UdpSocket::kMaxBatch, false);
+  runBench("batch 64 + GSO/GRO", opt, UdpSocket::kMaxBatch, true);
+}
@@ -0,0 +1,46 @@
+/**
+ * UDP echo 服务，把收到的数据报原样发回
+ * 多个 IO 线程时每个线程一个 SO_REUSEPORT 的 socket，可以用 udp_bench 或者
+ * high-performance-network-server/echoserver_udp&tcp.c 的客户端测试
+ *
+ * 用法：./udp_echo [端口] [IO 线程数] [gso]，默认监听 9985 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../reactor/EventLoop.h"
+#include "../reactor/UdpServer.h"
+
+using namespace jmuduo;
+
+int main(int argc, char* argv[]) {
+  printf("main(): pid = %d\n", getpid());
+  uint16_t port = static_cast<uint16_t>(argc > 1 ? atoi(argv[1]) : 9985);
+  int numThreads = argc > 2 ? atoi(argv[2]) : 0;
+  bool offload = argc > 3 && strcmp(argv[3], "gso") == 0;
+
+  EventLoop loop;
+  UdpServer server(&loop, InetAddress(port), "UdpEcho");
+  server.setThreadNum(numThreads);
+  server.setGro(offload);
+  server.setGso(offload);
+  server.setMessageCallback([](UdpSocket* socket, const char* data, size_t len,
+                               const InetAddress& peer, Timestamp) {
+    socket->send(data, len, peer);
+  });
+  server.start();
+  // 每 5 秒打印各个 socket 的统计信息
+  loop.runEvery(5.0, [&server] {
+    for (auto& socket : server.sockets()) {
+      UdpSocket* s = socket.get();
+      s->getLoop()->runInLoop([s] {
+        printf("fd %d: received %lu sent %lu dropped %lu, %lu recvmmsg %lu sendmmsg\n",
+               s->fd(), s->receivedDatagrams(), s->sentDatagrams(),
+               s->droppedDatagrams(), s->recvSyscalls(), s->sendSyscalls());
+      });
+    }
+  });
+  loop.loop();
+}
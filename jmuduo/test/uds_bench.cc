@@ -0,0 +1,107 @@
+/**
+ * 同一台机器上不同传输方式的对比：IPv4 回环 TCP、IPv6 回环 TCP、文件系统中的 Unix 域
+ * socket 和抽象命名空间的 Unix 域 socket。echo 服务运行在另一个 IO 线程中，
+ * 客户端用一条连接做 ping-pong（收到什么就发回什么），统计：
+ * 1. 延迟：消息很小（默认 64 字节），每次只有一个消息在途，给出平均往返时间
+ * 2. 吞吐：消息很大（默认 64KB），给出每秒传输的字节数
+ *
+ * 用法：./uds_bench [小消息字节数] [大消息字节数] [秒数]，使用 9987 和 9988 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/SockAddr.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9987;
+
+// 用一条连接 ping-pong seconds 秒，返回传输的字节数（单向）
+int64_t pingpong(const SockAddr& serverAddr, size_t size, double seconds,
+                 double* elapsed) {
+  EventLoop loop;
+  TcpClient client(&loop, serverAddr, "pingpong");
+  int64_t bytes = 0;
+  Timestamp start;
+  std::string message(size, 'x');
+  client.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (conn->connected()) {
+      conn->setTcpNoDelay(true);
+      start = Timestamp::now();
+      conn->send(message);
+    }
+  });
+  client.setMessageCallback(
+      [&bytes](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+        bytes += buf->readableBytes();
+        conn->send(buf);
+      });
+  client.connect();
+  int64_t result = 0;
+  loop.runAfter(seconds, [&] {
+    *elapsed = timeDifference(Timestamp::now(), start);
+    result = bytes;
+    client.disconnect();
+    // 等待连接关闭后再退出，TcpClient 析构时连接已经断开
+    loop.runAfter(0.1, [&loop] { loop.quit(); });
+  });
+  loop.loop();
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  size_t smallSize = argc > 1 ? atoi(argv[1]) : 64;
+  size_t largeSize = argc > 2 ? atoi(argv[2]) : 65536;
+  double seconds = argc > 3 ? atof(argv[3]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+
+  struct Transport {
+    const char* name;
+    SockAddr listenAddr;
+    SockAddr connectAddr;
+  };
+  std::vector<Transport> transports = {
+      {"tcp 127.0.0.1", SockAddr(kPort), SockAddr("127.0.0.1", kPort)},
+      // [::] 默认也接受 IPv4 的连接，和 0.0.0.0 不能绑定同一个端口
+      {"tcp [::1]", SockAddr(kPort + 1, true), SockAddr("::1", kPort + 1)},
+      {"unix path", SockAddr::unixPath("/tmp/jmuduo_uds_bench.sock"),
+       SockAddr::unixPath("/tmp/jmuduo_uds_bench.sock")},
+      {"unix abstract", SockAddr::unixAbstract("jmuduo_uds_bench"),
+       SockAddr::unixAbstract("jmuduo_uds_bench")},
+  };
+
+  // echo 服务运行在另一个 IO 线程中，进程退出时不析构，避免和 IO 线程竞争
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  for (const Transport& t : transports) {
+    TcpServer* server = new TcpServer(serverLoop, t.listenAddr);
+    server->setConnectionCallback([](const TcpConnectionPtr& conn) {
+      if (conn->connected()) conn->setTcpNoDelay(true);
+    });
+    server->setMessageCallback(
+        [](const TcpConnectionPtr& conn, Buffer* buf, Timestamp) {
+          conn->send(buf);
+        });
+    serverLoop->runInLoop([server] { server->start(); });
+  }
+
+  printf("%-16s %16s %16s\n", "transport", "rtt", "throughput");
+  for (const Transport& t : transports) {
+    double elapsed = 0;
+    int64_t bytes = pingpong(t.connectAddr, smallSize, seconds, &elapsed);
+    double rtt = elapsed / (static_cast<double>(bytes) / smallSize);
+    bytes = pingpong(t.connectAddr, largeSize, seconds, &elapsed);
+    double throughput = bytes / elapsed;
+    printf("%-16s %14.1fus %12.1fMB/s\n", t.name, rtt * 1e6,
+           throughput / 1024 / 1024);
+  }
+}
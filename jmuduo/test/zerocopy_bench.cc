@@ -0,0 +1,120 @@
+/**
+ * 零拷贝发送（TcpConnection::enableZeroCopy）的基准测试。服务端运行在单独的 IO 线程中，
+ * 每次输出缓冲区清空（WriteCompleteCallback）时再发送同一份共享的数据块；客户端在主线程中
+ * 读取并丢弃数据。对比普通的拷贝发送和 MSG_ZEROCOPY 发送的吞吐量，以及服务端线程每发送
+ * 1GB 数据消耗的 CPU 时间（getrusage(RUSAGE_THREAD)）
+ * 注意：发往本机（loopback）的数据在接收端仍然需要拷贝，内核会退回拷贝发送
+ * （完成通知带有 SO_EE_CODE_ZEROCOPY_COPIED，见输出中的 copied），
+ * 零拷贝节省的 CPU 只有在真实网卡上才能体现，这里主要衡量锁定内存页和完成通知的额外开销
+ *
+ * 用法：./zerocopy_bench [数据块KB] [秒数]，使用 9992 端口
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include <memory>
+#include <string>
+
+#include "../base/logging/Logging.h"
+#include "../reactor/Buffer.h"
+#include "../reactor/EventLoop.h"
+#include "../reactor/EventLoopThread.h"
+#include "../reactor/TcpClient.h"
+#include "../reactor/TcpServer.h"
+
+using namespace jmuduo;
+
+const uint16_t kPort = 9992;
+
+bool g_zeroCopy = false;
+
+// 调用线程消耗的 CPU 时间（用户态 + 内核态），单位秒
+double threadCpuSeconds() {
+  struct rusage usage;
+  ::getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+struct ZeroCopyStats {
+  uint64_t sends = 0;
+  uint64_t copied = 0;
+};
+
+int main(int argc, char* argv[]) {
+  size_t chunkSize = (argc > 1 ? atoi(argv[1]) : 1024) * 1024;
+  double seconds = argc > 2 ? atof(argv[2]) : 2;
+  Logger::setLogLevel(Logger::WARN);
+
+  auto chunk = std::make_shared<const std::string>(chunkSize, 'x');
+
+  EventLoopThread serverThread;
+  EventLoop* serverLoop = serverThread.startLoop();
+  // 服务端在进程退出时不析构，避免和 IO 线程竞争
+  TcpServer& server = *new TcpServer(serverLoop, InetAddress(kPort));
+  TcpConnectionPtr serverConn;  // 只在服务端 IO 线程中访问
+  server.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+    if (!conn->connected()) {
+      serverConn.reset();
+      return;
+    }
+    serverConn = conn;
+    if (g_zeroCopy && !conn->enableZeroCopy()) {
+      fprintf(stderr, "SO_ZEROCOPY is not supported\n");
+      exit(1);
+    }
+    conn->send(chunk);
+  });
+  server.setWriteCompleteCallback(
+      [&chunk](const TcpConnectionPtr& conn) { conn->send(chunk); });
+  serverLoop->runInLoop([&server] { server.start(); });
+
+  EventLoop loop;
+  printf("chunk %zu KB\n", chunkSize / 1024);
+  for (int i = 0; i < 2; ++i) {
+    g_zeroCopy = i == 1;
+    int64_t received = 0;
+    double cpuStart = 0;
+    Timestamp start;
+    TcpClient client(&loop, InetAddress("127.0.0.1", kPort), "client");
+    client.setConnectionCallback([&](const TcpConnectionPtr& conn) {
+      if (!conn->connected()) return;
+      // 跳过建立连接的过程
+      loop.runAfter(0.1, [&] {
+        received = 0;
+        start = Timestamp::now();
+        cpuStart = serverLoop->call(threadCpuSeconds).get();
+        loop.runAfter(seconds, [&] {
+          double cpu = serverLoop->call(threadCpuSeconds).get() - cpuStart;
+          double elapsed = timeDifference(Timestamp::now(), start);
+          ZeroCopyStats stats = serverLoop->call([&serverConn] {
+            ZeroCopyStats s;
+            if (serverConn) {
+              s.sends = serverConn->zeroCopySends();
+              s.copied = serverConn->zeroCopyCopied();
+            }
+            return s;
+          }).get();
+          double gb = received / 1e9;
+          printf("%-10s %8.1f MB/s, sender cpu %6.3f s/GB",
+                 g_zeroCopy ? "zerocopy" : "copy", received / 1e6 / elapsed,
+                 cpu / gb);
+          if (g_zeroCopy)
+            printf(", %llu zerocopy sends, %llu copied",
+                   static_cast<unsigned long long>(stats.sends),
+                   static_cast<unsigned long long>(stats.copied));
+          printf("\n");
+          client.disconnect();
+          loop.runAfter(0.2, [&loop] { loop.quit(); });
+        });
+      });
+    });
+    client.setMessageCallback([&](const TcpConnectionPtr&, Buffer* buf, Timestamp) {
+      received += buf->readableBytes();
+      buf->retrieveAll();
+    });
+    client.connect();
+    loop.loop();
+  }
+}
@@ -0,0 +1,193 @@
+/**
+ * @file logdecode.cc
+ * @brief 将 LOG_BIN 输出的二进制日志还原为和 Logger 相同格式的文本日志
+ *
+ * 用法：./logdecode [binary.log]，不指定文件时从标准输入读取
+ *
+ * 日志由调用点描述、块头和事件三种记录组成（见 BinaryLog.h），
+ * 事件按其调用点描述中的格式串还原，格式串中的 {} 依次被参数替换
+ */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../base/datetime/Timestamp.h"
+#include "../base/logging/BinaryLog.h"
+#include "../base/logging/LogStream.h"
+
+using namespace jmuduo;
+using namespace jmuduo::binlog;
+
+namespace {
+
+const char* kLevelNames[Logger::NUM_LOG_LEVELS] = {
+    "TRACE ", "DEBUG ", "INFO  ", "WARN  ", "ERROR ", "FATAL ",
+};
+
+struct Site {
+  int level;
+  int line;
+  std::string file;
+  std::string format;
+  std::string argTypes;
+};
+
+// 对日志数据的顺序读取，越界时标记失败
+class Reader {
+ public:
+  Reader(const char* data, size_t len) : cur_(data), end_(data + len) {}
+
+  bool empty() const { return cur_ >= end_; }
+  bool ok() const { return ok_; }
+
+  template <typename T>
+  T get() {
+    T v{};
+    if (end_ - cur_ < static_cast<ptrdiff_t>(sizeof v)) {
+      ok_ = false;
+      cur_ = end_;
+      return v;
+    }
+    memcpy(&v, cur_, sizeof v);
+    cur_ += sizeof v;
+    return v;
+  }
+
+  std::string getString() {
+    uint16_t n = get<uint16_t>();
+    if (end_ - cur_ < n) {
+      ok_ = false;
+      cur_ = end_;
+      return std::string();
+    }
+    std::string s(cur_, n);
+    cur_ += n;
+    return s;
+  }
+
+ private:
+  const char* cur_;
+  const char* end_;
+  bool ok_ = true;
+};
+
+// 读取一个调用点描述（已读过 u32 0 和记录类型）
+bool readSite(Reader& r, uint32_t* id, Site* site) {
+  *id = r.get<uint32_t>();
+  site->level = r.get<uint8_t>();
+  site->line = r.get<int32_t>();
+  site->file = r.getString();
+  site->format = r.getString();
+  uint8_t nargs = r.get<uint8_t>();
+  site->argTypes.clear();
+  for (uint8_t i = 0; i < nargs; ++i) site->argTypes.push_back(r.get<char>());
+  return r.ok() && site->level < Logger::NUM_LOG_LEVELS;
+}
+
+// 按类型码读取一个参数并输出到日志流
+void formatArg(Reader& r, char type, LogStream& os) {
+  switch (type) {
+    case kInt32: os << r.get<int32_t>(); break;
+    case kUInt32: os << r.get<uint32_t>(); break;
+    case kInt64: os << r.get<int64_t>(); break;
+    case kUInt64: os << r.get<uint64_t>(); break;
+    case kDouble: os << r.get<double>(); break;
+    case kChar: os << r.get<char>(); break;
+    case kPointer:
+      os << reinterpret_cast<const void*>(
+          static_cast<uintptr_t>(r.get<uint64_t>()));
+      break;
+    case kString: os << r.getString(); break;
+    default: os << "<bad type>"; break;
+  }
+}
+
+const char* basename(const std::string& path) {
+  const char* p = strrchr(path.c_str(), '/');
+  return p ? p + 1 : path.c_str();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  FILE* fp = argc > 1 ? fopen(argv[1], "rb") : stdin;
+  if (fp == nullptr) {
+    perror("fopen");
+    return 1;
+  }
+  std::vector<char> data;
+  char chunk[65536];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof chunk, fp)) > 0)
+    data.insert(data.end(), chunk, chunk + n);
+  if (fp != stdin) fclose(fp);
+
+  std::unordered_map<uint32_t, Site> sites;
+  // 顺序还原事件，调用点描述总是出现在使用它的事件之前
+  Reader r(data.data(), data.size());
+  int tid = 0;
+  int64_t now = 0;
+  LogStream os;
+  while (!r.empty() && r.ok()) {
+    uint32_t id = r.get<uint32_t>();
+    if (id == 0) {
+      uint8_t type = r.get<uint8_t>();
+      if (type == kBlockHeader) {
+        tid = r.get<int32_t>();
+        now = r.get<int64_t>();
+      } else if (type == kSiteDefinition) {
+        Site site;
+        if (readSite(r, &id, &site)) sites[id] = site;
+      } else {
+        fprintf(stderr, "logdecode: bad record type %d\n", type);
+        return 1;
+      }
+      continue;
+    }
+
+    auto it = sites.find(id);
+    if (it == sites.end()) {
+      fprintf(stderr, "logdecode: unknown site %u\n", id);
+      return 1;
+    }
+    const Site& site = it->second;
+    now += r.get<uint32_t>();
+
+    os.resetBuffer();
+    Timestamp t(now);
+    char time[Timestamp::kSecondsFormatLength +
+              Timestamp::kMicroSecondsFormatLength];
+    t.formatSeconds(time);
+    t.formatMicroSeconds(time + Timestamp::kSecondsFormatLength);
+    os.append(time, sizeof time);
+    os << Fmt("Z %6d ", tid) << kLevelNames[site.level];
+
+    // 依次用参数替换格式串中的 {}
+    const char* fmt = site.format.c_str();
+    size_t arg = 0;
+    while (*fmt) {
+      if (fmt[0] == '{' && fmt[1] == '}' && arg < site.argTypes.size()) {
+        formatArg(r, site.argTypes[arg++], os);
+        fmt += 2;
+      } else {
+        os << *fmt++;
+      }
+    }
+    for (; arg < site.argTypes.size(); ++arg) {  // 多余的参数追加在末尾
+      os << ' ';
+      formatArg(r, site.argTypes[arg], os);
+    }
+    os << " - " << basename(site.file) << ':' << site.line << '\n';
+    fwrite(os.buffer().data(), 1, os.buffer().length(), stdout);
+  }
+
+  if (!r.ok()) {
+    fprintf(stderr, "logdecode: truncated log\n");
+    return 1;
+  }
+  return 0;
+}